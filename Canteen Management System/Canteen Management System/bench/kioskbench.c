@@ -0,0 +1,161 @@
+/**
+ * @file kioskbench.c
+ * @brief Sessions-per-core benchmark of the kiosk session engine.
+ *
+ * Keeps --sessions kiosk sessions open at once and drives all of them
+ * from this one thread: each step picks a random open session and
+ * answers its current prompt the way a consumer would (view the menu,
+ * search, build a basket from a generated order, sometimes cancel,
+ * exit). A finished session is replaced by a new consumer, until
+ * --orders sessions have completed. Output is counted, not printed.
+ *
+ * Prints JSON lines for whole sessions and for single inputs, then the
+ * per-input latency and per-session memory on stderr.
+ *
+ * Usage: KioskBench.exe [--sessions=N] [workload options...]
+ */
+
+#include "workload.h"
+#include "../include/kiosksession.h"
+#include "../include/metrics.h"
+
+/* A simulated consumer at one kiosk */
+typedef struct {
+    KioskSession session;
+    WorkloadOrder plan;
+    int step;                 /* position in the choice script */
+} Client;
+
+static void countOutput(void *context, const char *text, size_t length){
+    (void)text;
+    *(uint64_t *)context += length;
+}
+
+static void startClient(Workload *w, KioskCanteen *canteen, Client *client, uint64_t *output){
+    nextWorkloadOrder(w, &client->plan);
+    client->step = 0;
+    kioskStart(&client->session, canteen, countOutput, output);
+}
+
+/* Choice script: view menu, search, order, cancel if the plan says so, exit */
+static const char* nextChoice(Client *client){
+    switch (client->step++) {
+    case 0: return "1";
+    case 1: return "6";
+    case 2: return "2";
+    case 3: if (client->plan.undo) return "3";
+            client->step++;
+            /* fall through */
+    default: return "0";
+    }
+}
+
+static const char* answer(Workload *w, Client *client, char *buffer, size_t size){
+    const WorkloadOrder *plan = &client->plan;
+    const KioskSession *session = &client->session;
+
+    switch (session->state) {
+    case KIOSK_ASK_NAME:
+        return plan->consumer->name;
+    case KIOSK_ASK_UID:
+        return plan->consumer->uid;
+    case KIOSK_ASK_CHOICE:
+        return nextChoice(client);
+    case KIOSK_ASK_ITEM_COUNT:
+        snprintf(buffer, size, "%d", plan->lineCount);
+        return buffer;
+    case KIOSK_ASK_ITEM_ID:
+        snprintf(buffer, size, "%d", plan->menuIds[session->linesEntered]);
+        return buffer;
+    case KIOSK_ASK_QUANTITY: {
+        /* staff restock between customers rather than turning lines away */
+        Menu *item = findMenuItem(w->menu, session->pendingMenuId);
+        int quantity = plan->quantities[session->linesEntered];
+        if (item->quantity < quantity) adjustItemQuantity(item, WORKLOAD_STOCK - item->quantity);
+        snprintf(buffer, size, "%d", quantity);
+        return buffer;
+    }
+    case KIOSK_ASK_SEARCH:
+        snprintf(buffer, size, "%.3s", findMenuItem(w->menu, randomMenuId(w))->name);
+        return buffer;
+    default:
+        return "0";
+    }
+}
+
+int main(int argc, char *argv[]){
+    WorkloadConfig config = defaultWorkloadConfig();
+    int sessions = 10000;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--sessions=", 11) == 0) {
+            sessions = atoi(argv[i] + 11);
+        } else if (parseWorkloadOption(&config, argv[i]) != 0) {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            fprintf(stderr, "Usage: %s [--sessions=N] [--seed=N] [--consumers=N] [--menu=N] "
+                            "[--items=N] [--quantity=N] [--undo=P] [--skew=S] [--orders=N] "
+                            "[--depth=N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (sessions < 1) sessions = 1;
+
+    Workload *w = createWorkload(&config);
+    OrderQueue *queue = createOrderQueue();
+    OrderStack *stack = createOrderStack();
+    Client *clients = (Client *)calloc(sessions, sizeof(Client));
+    if (!w || !queue || !stack || !clients) return 1;
+    MenuIndex *menuIndex = createMenuIndex(w->menu);
+    MenuSearch *menuSearch = createMenuSearch(w->menu);
+    WaitEstimator *eta = createWaitEstimator(4, 60000000000ULL);
+    KioskCanteen canteen = { &w->consumers, w->menu, menuIndex, menuSearch, queue, stack, 1, eta, NULL, NULL, NULL, NULL };
+
+    uint64_t output = 0;
+    for (int i = 0; i < sessions; i++) startClient(w, &canteen, &clients[i], &output);
+
+    static LatencyHistogram perInput;
+    char buffer[32];
+    long completed = 0, inputs = 0;
+    resetHistogram(&perInput);
+    uint64_t start = benchNanos();
+    while (completed < config.orders) {
+        Client *client = &clients[workloadRandom(w) % (uint32_t)sessions];
+        const char *line = answer(w, client, buffer, sizeof(buffer));
+
+        uint64_t before = benchNanos();
+        int open = kioskInput(&client->session, line);
+        histogramRecord(&perInput, benchNanos() - before);
+        inputs++;
+
+        if (!open) {
+            completed++;
+            startClient(w, &canteen, client, &output);
+        }
+        while (queue->count > config.queueDepth) {
+            Order *done = dequeueOrder(queue);
+            forgetOrder(stack, done);
+            freeOrder(done);
+        }
+    }
+    uint64_t elapsed = benchNanos() - start;
+
+    printBenchResult(stdout, "kioskSession", completed, elapsed, &config);
+    printBenchResult(stdout, "kioskInput", inputs, elapsed, &config);
+    fprintf(stderr, "%d concurrent sessions on one thread, %zu bytes of state each\n",
+            sessions, sizeof(KioskSession));
+    fprintf(stderr, "%.1f inputs and %.0f output bytes per session\n",
+            inputs / (double)completed, output / (double)(completed + sessions));
+    fprintf(stderr, "per input: p50 %.2f us, p99 %.2f us, max %.2f us\n",
+            histogramPercentile(&perInput, 50.0) / 1e3, histogramPercentile(&perInput, 99.0) / 1e3,
+            perInput.max / 1e3);
+
+    for (int i = 0; i < sessions; i++) kioskEnd(&clients[i].session);
+    free(clients);
+    freeWaitEstimator(eta);
+    freeMenuSearch(menuSearch);
+    freeMenuIndex(menuIndex);
+    freeOrderStack(stack);
+    freeOrderQueue(queue);
+    freeWorkload(w);
+    return 0;
+}
@@ -0,0 +1,289 @@
+/**
+ * @file microbench.c
+ * @brief Microbenchmarks of the core order path.
+ *
+ * Times findMenuItem, findConsumer, enqueueOrder / dequeueOrder,
+ * undoLastOrder, printBill, idempotency-key lookups and pre-order
+ * holds, plus an end-to-end lunch rush, on a
+ * generated workload. Each result is printed to stdout as one JSON
+ * line (see printBenchResult()).
+ *
+ * Usage: MicroBench.exe [--only=name] [workload options...]
+ */
+
+#include "workload.h"
+#include "../include/order.h"
+#include "../include/undo.h"
+#include "../include/metrics.h"
+#include "../include/idempotency.h"
+#include "../include/reservation.h"
+#include "../include/clocksource.h"
+
+/* Keeps lookups from being optimised away */
+static volatile long sink;
+
+static const char *only = NULL;
+
+static int selected(const char *bench){
+    return only == NULL || strcmp(only, bench) == 0;
+}
+
+static OrderItem* buildItems(Workload *w, const WorkloadOrder *order, float *total){
+    OrderItem *head = NULL, *tail = NULL;
+    *total = 0.0f;
+    for (int i = 0; i < order->lineCount; i++) {
+        Menu *item = findMenuItem(w->menu, order->menuIds[i]);
+        OrderItem *line = createOrderItem(item, order->quantities[i]);
+        *total += line->unitPrice * line->quantity;
+        if (tail) tail->next = line;
+        else head = line;
+        tail = line;
+    }
+    return head;
+}
+
+static void benchFindMenuItem(Workload *w){
+    long n = w->config.orders;
+    int *ids = (int *)malloc(n * sizeof(int));
+    for (long i = 0; i < n; i++) ids[i] = randomMenuId(w);
+
+    uint64_t start = benchNanos();
+    for (long i = 0; i < n; i++) {
+        sink += findMenuItem(w->menu, ids[i])->id;
+    }
+    printBenchResult(stdout, "findMenuItem", n, benchNanos() - start, &w->config);
+    free(ids);
+}
+
+static void benchFindConsumer(Workload *w){
+    long n = w->config.orders;
+    const char **uids = (const char **)malloc(n * sizeof(char *));
+    for (long i = 0; i < n; i++) uids[i] = randomConsumer(w)->uid;
+
+    uint64_t start = benchNanos();
+    for (long i = 0; i < n; i++) {
+        sink += findConsumer(w->consumers, uids[i])->type;
+    }
+    printBenchResult(stdout, "findConsumer", n, benchNanos() - start, &w->config);
+    free(uids);
+}
+
+static void benchQueue(Workload *w){
+    long n = w->config.orders;
+    OrderQueue *queue = createOrderQueue();
+    Order **served = (Order **)malloc(n * sizeof(Order *));
+
+    uint64_t start = benchNanos();
+    for (long i = 0; i < n; i++) {
+        Consumer *c = w->consumerAt[i % w->config.consumers];
+        enqueueOrder(queue, (int)(i & 0xFFFF), c->name, c->uid, NULL, 0.0f);
+    }
+    printBenchResult(stdout, "enqueueOrder", n, benchNanos() - start, &w->config);
+
+    start = benchNanos();
+    for (long i = 0; i < n; i++) {
+        served[i] = dequeueOrder(queue);
+    }
+    printBenchResult(stdout, "dequeueOrder", n, benchNanos() - start, &w->config);
+
+    for (long i = 0; i < n; i++) freeOrder(served[i]);
+    free(served);
+    freeOrderQueue(queue);
+}
+
+static void benchUndo(Workload *w){
+    long n = w->config.orders;
+    int depth = w->config.queueDepth;
+    OrderQueue *queue = createOrderQueue();
+    OrderStack *stack = createOrderStack();
+    WorkloadOrder order;
+    uint64_t elapsed = 0;
+    long undone = 0;
+
+    int saved = muteStdout();
+    while (undone < n) {
+        /* fill to the configured depth, then undo everything from the top */
+        for (int i = 0; i < depth; i++) {
+            float total;
+            nextWorkloadOrder(w, &order);
+            OrderItem *items = buildItems(w, &order, &total);
+            pushOrder(stack, enqueueConsumerOrder(queue, i, order.consumer, items, total));
+        }
+        uint64_t start = benchNanos();
+        for (int i = 0; i < depth; i++) {
+            undoLastOrder(stack, queue);
+        }
+        elapsed += benchNanos() - start;
+        undone += depth;
+    }
+    unmuteStdout(saved);
+    printBenchResult(stdout, "undoLastOrder", undone, elapsed, &w->config);
+
+    freeOrderStack(stack);
+    freeOrderQueue(queue);
+}
+
+static void benchPrintBill(Workload *w){
+    long n = w->config.orders;
+    OrderQueue *queue = createOrderQueue();
+    WorkloadOrder order;
+    float total;
+
+    nextWorkloadOrder(w, &order);
+    order.lineCount = w->config.maxItemsPerOrder;
+    for (int i = 0; i < order.lineCount; i++) {
+        order.menuIds[i] = randomMenuId(w);
+        order.quantities[i] = 1;
+    }
+    OrderItem *items = buildItems(w, &order, &total);
+    Order *bill = enqueueConsumerOrder(queue, 1, order.consumer, items, total);
+
+    int saved = muteStdout();
+    uint64_t start = benchNanos();
+    for (long i = 0; i < n; i++) {
+        printBill(bill);
+    }
+    fflush(stdout);
+    uint64_t elapsed = benchNanos() - start;
+    unmuteStdout(saved);
+    printBenchResult(stdout, "printBill", n, elapsed, &w->config);
+
+    freeOrderQueue(queue);
+}
+
+/* Submissions with idempotency keys, one in ten a retry of a recent one */
+static void benchRequestKeys(Workload *w){
+    long n = w->config.orders;
+    OrderQueue *queue = createOrderQueue();
+    RequestTable *table = createRequestTable(UINT64_MAX / 2);
+    char (*keys)[REQUEST_KEY_LENGTH] = malloc(n * sizeof(*keys));
+    for (long i = 0; i < n; i++) {
+        long id = (i % 10 == 9) ? i - 1 - (long)(workloadRandom(w) % 64) : i;
+        snprintf(keys[i], REQUEST_KEY_LENGTH, "kiosk-%ld-%016lx", id % 97, (unsigned long)id * 2654435761UL);
+    }
+    Order *order = enqueueOrder(queue, 1, "bench", "B0", NULL, 0.0f);
+
+    uint64_t start = benchNanos();
+    for (long i = 0; i < n; i++) {
+        if (findRequest(table, keys[i])) sink++;
+        else rememberRequest(table, keys[i], order);
+    }
+    printBenchResult(stdout, "requestKeys", n, benchNanos() - start, &w->config);
+
+    freeRequestTable(table);
+    freeOrderQueue(queue);
+    free(keys);
+}
+
+/* Pre-order holds over a two-hour window on a virtual clock: every hold
+   is armed, a third are cancelled, the rest expire second by second */
+static void benchHolds(Workload *w){
+    long n = w->config.orders;
+    Reservation **holds = (Reservation **)malloc(n * sizeof(Reservation *));
+    VirtualClock clock;
+
+    initVirtualClock(&clock, 1736121600, w->config.seed);
+    useVirtualClock(&clock);
+    ReservationBook *book = createReservationBook(1000000000ULL);
+    uint64_t base = clockNanos();
+
+    uint64_t start = benchNanos();
+    for (long i = 0; i < n; i++) {
+        uint64_t deadline = base + (1 + workloadRandom(w) % 7200) * 1000000000ULL;
+        holds[i] = reserveStock(book, w->consumers, NULL, 0.0f, deadline);
+    }
+    for (long i = 0; i < n; i += 3) {
+        cancelReservation(book, holds[i]);
+    }
+    for (int s = 0; s <= 7200; s++) {
+        sink += expireReservations(book);
+        advanceVirtualClock(&clock, 1000000000ULL);
+    }
+    printBenchResult(stdout, "holds", n, benchNanos() - start, &w->config);
+
+    freeReservationBook(book);
+    setClockSource(NULL);
+    free(holds);
+}
+
+/* Orders placed, undone and served the way the admin console does it */
+static void benchLunchRush(Workload *w){
+    long n = w->config.orders;
+    OrderQueue *queue = createOrderQueue();
+    OrderStack *stack = createOrderStack();
+    WorkloadOrder order;
+
+    int saved = muteStdout();
+    uint64_t start = benchNanos();
+    for (long i = 0; i < n; i++) {
+        nextWorkloadOrder(w, &order);
+        Consumer *c = findConsumer(w->consumers, order.consumer->uid);
+
+        OrderItem *head = NULL, *tail = NULL;
+        float total = 0.0f;
+        for (int k = 0; k < order.lineCount; k++) {
+            Menu *item = findMenuItem(w->menu, order.menuIds[k]);
+            if (item->quantity < order.quantities[k]) {
+                adjustItemQuantity(item, WORKLOAD_STOCK - item->quantity);
+            }
+            adjustItemQuantity(item, -order.quantities[k]);
+            OrderItem *line = createOrderItem(item, order.quantities[k]);
+            total += line->unitPrice * line->quantity;
+            if (tail) tail->next = line;
+            else head = line;
+            tail = line;
+        }
+        pushOrder(stack, enqueueConsumerOrder(queue, (int)(i & 0xFFFF), c, head, total));
+
+        if (order.undo) {
+            undoLastOrder(stack, queue);
+        }
+        while (queue->count > w->config.queueDepth) {
+            Order *done = dequeueOrder(queue);
+            forgetOrder(stack, done);
+            freeOrder(done);
+        }
+    }
+    uint64_t elapsed = benchNanos() - start;
+    unmuteStdout(saved);
+    printBenchResult(stdout, "lunchRush", n, elapsed, &w->config);
+
+    freeOrderStack(stack);
+    freeOrderQueue(queue);
+}
+
+int main(int argc, char *argv[]){
+    WorkloadConfig config = defaultWorkloadConfig();
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--only=", 7) == 0) {
+            only = argv[i] + 7;
+        } else if (parseWorkloadOption(&config, argv[i]) != 0) {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            fprintf(stderr, "Usage: %s [--only=name] [--seed=N] [--consumers=N] [--menu=N] "
+                            "[--items=N] [--quantity=N] [--undo=P] [--skew=S] [--orders=N] "
+                            "[--depth=N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    static void (*const benches[])(Workload *) = {
+        benchFindMenuItem, benchFindConsumer, benchQueue, benchUndo, benchPrintBill, benchRequestKeys,
+        benchHolds, benchLunchRush
+    };
+    static const char *names[] = {
+        "findMenuItem", "findConsumer", "queue", "undoLastOrder", "printBill", "requestKeys", "holds",
+        "lunchRush"
+    };
+    for (size_t b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+        if (!selected(names[b])) continue;
+        /* every benchmark starts from the same generated state */
+        Workload *w = createWorkload(&config);
+        if (!w) return 1;
+        benches[b](w);
+        freeWorkload(w);
+    }
+    /* built with METRICS=1: show what the instrumentation saw */
+    if (metricsEnabled()) dumpMetrics(stderr);
+    return 0;
+}
@@ -0,0 +1,430 @@
+/**
+ * @file replay.c
+ * @brief Replays a recorded operation trace as load.
+ *
+ * Loads a trace written by the recorder (CanteenApp.exe --record,
+ * Kiosk --record or Simulate.exe --record=) and re-issues every
+ * operation against a fresh menu, queue and undo stack. Each thread
+ * replays the whole trace on its own copy of that state, so N threads
+ * offer N times the recorded load.
+ *
+ * At --speed=S the gaps between operations are divided by S; an
+ * operation's latency is then measured from the moment it was due, so
+ * falling behind shows up in the percentiles. With --speed=max the
+ * operations run back to back and latency is the time each one takes.
+ *
+ * Usage: Replay.exe <trace> [--speed=N|max] [--threads=N]
+ */
+
+#include <pthread.h>
+#include "workload.h"
+#include "../include/order.h"
+#include "../include/undo.h"
+#include "../include/archive.h"
+#include "../include/recorder.h"
+#include "../include/metrics.h"
+
+#define REPLAY_MAX_THREADS 64
+#define REPLAY_OP_KINDS (RECORD_SERVE + 1)
+#define REPLAY_SPIN_NANOS 2000000ULL     /* spin the last 2 ms; sleeps overshoot */
+
+/* Operations are stored compactly; strings live in side tables */
+typedef struct {
+    uint64_t nanos;
+    uint8_t type;
+    int32_t value;              /* menu ID, or menu item index for MENU_ITEM */
+    int32_t orderId;
+    int32_t consumer;           /* index into consumer tables */
+    int32_t firstLine;
+    int32_t lineCount;
+} ReplayOp;
+
+typedef struct {
+    char *name;
+    int id;
+    int type;
+    float price;
+    int quantity;
+} ReplayItem;
+
+typedef struct {
+    ReplayOp *ops;
+    long opCount, opCapacity;
+    int32_t *lineIds, *lineQuantities;
+    long lineCount, lineCapacity;
+    ReplayItem *items;
+    int itemCount, itemCapacity;
+    char **uids;
+    int *uidTypes;
+    int uidCount, uidCapacity;
+    int32_t *uidSlots;          /* hash: UID -> index + 1 */
+    int slotCapacity;
+} Trace;
+
+typedef struct {
+    const Trace *trace;
+    double speed;               /* 0 = as fast as possible */
+    uint64_t startNanos;
+    LatencyHistogram latency[REPLAY_OP_KINDS];
+    long missingItems;
+    uint64_t elapsedNanos;
+} ReplayThread;
+
+static volatile long sink;
+
+static const char *opNames[REPLAY_OP_KINDS] = {
+    "", "menu.item", "menu.lookup", "order.place", "order.undo", "order.serve"
+};
+
+/* ===============================
+   Loading
+   =============================== */
+
+static int grow(void **array, long *capacity, long needed, size_t size){
+    if (needed <= *capacity) return 0;
+    long next = *capacity ? *capacity * 2 : 1024;
+    while (next < needed) next *= 2;
+    void *bigger = realloc(*array, next * size);
+    if (!bigger) return -1;
+    *array = bigger;
+    *capacity = next;
+    return 0;
+}
+
+static uint32_t hashString(const char *s){
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int rehashUids(Trace *t, int capacity){
+    int32_t *slots = (int32_t *)calloc(capacity, sizeof(int32_t));
+    if (!slots) return -1;
+    for (int i = 0; i < t->uidCount; i++) {
+        uint32_t h = hashString(t->uids[i]) & (capacity - 1);
+        while (slots[h]) h = (h + 1) & (capacity - 1);
+        slots[h] = i + 1;
+    }
+    free(t->uidSlots);
+    t->uidSlots = slots;
+    t->slotCapacity = capacity;
+    return 0;
+}
+
+static int consumerIndex(Trace *t, const char *uid, int type){
+    if ((t->uidCount + 1) * 2 > t->slotCapacity
+        && rehashUids(t, t->slotCapacity ? t->slotCapacity * 2 : 256) != 0) return -1;
+
+    uint32_t h = hashString(uid) & (t->slotCapacity - 1);
+    while (t->uidSlots[h]) {
+        int index = t->uidSlots[h] - 1;
+        if (strcmp(t->uids[index], uid) == 0) return index;
+        h = (h + 1) & (t->slotCapacity - 1);
+    }
+    if (t->uidCount == t->uidCapacity) {
+        int capacity = t->uidCapacity ? t->uidCapacity * 2 : 256;
+        char **uids = (char **)realloc(t->uids, capacity * sizeof(char *));
+        if (!uids) return -1;
+        t->uids = uids;
+        int *types = (int *)realloc(t->uidTypes, capacity * sizeof(int));
+        if (!types) return -1;
+        t->uidTypes = types;
+        t->uidCapacity = capacity;
+    }
+    t->uids[t->uidCount] = strdup(uid);
+    t->uidTypes[t->uidCount] = type;
+    t->uidSlots[h] = t->uidCount + 1;
+    return t->uidCount++;
+}
+
+static void freeTrace(Trace *t){
+    for (int i = 0; i < t->itemCount; i++) free(t->items[i].name);
+    for (int i = 0; i < t->uidCount; i++) free(t->uids[i]);
+    free(t->ops);
+    free(t->lineIds);
+    free(t->lineQuantities);
+    free(t->items);
+    free(t->uids);
+    free(t->uidTypes);
+    free(t->uidSlots);
+}
+
+static int loadTrace(const char *path, Trace *t){
+    RecordingReader *reader = openRecording(path);
+    RecordedOp op;
+    int status;
+
+    if (!reader) return -1;
+    memset(t, 0, sizeof(*t));
+    while ((status = nextRecordedOp(reader, &op)) == 1) {
+        if (grow((void **)&t->ops, &t->opCapacity, t->opCount + 1, sizeof(ReplayOp)) != 0) break;
+        ReplayOp *r = &t->ops[t->opCount++];
+        memset(r, 0, sizeof(*r));
+        r->nanos = op.nanos;
+        r->type = (uint8_t)op.type;
+
+        if (op.type == RECORD_MENU_ITEM) {
+            if (t->itemCount == t->itemCapacity) {
+                int capacity = t->itemCapacity ? t->itemCapacity * 2 : 64;
+                ReplayItem *items = (ReplayItem *)realloc(t->items, capacity * sizeof(ReplayItem));
+                if (!items) break;
+                t->items = items;
+                t->itemCapacity = capacity;
+            }
+            ReplayItem *item = &t->items[t->itemCount];
+            item->name = strdup(op.name);
+            item->id = op.menuId;
+            item->type = op.itemType;
+            item->price = op.price;
+            item->quantity = op.quantity;
+            r->value = t->itemCount++;
+        } else if (op.type == RECORD_MENU_LOOKUP) {
+            r->value = op.menuId;
+        } else if (op.type == RECORD_ORDER_PLACED) {
+            long needed = t->lineCount + op.lineCount;
+            long capacity = t->lineCapacity;
+            if (grow((void **)&t->lineIds, &capacity, needed, sizeof(int32_t)) != 0) break;
+            capacity = t->lineCapacity;
+            if (grow((void **)&t->lineQuantities, &capacity, needed, sizeof(int32_t)) != 0) break;
+            t->lineCapacity = capacity;
+            r->orderId = op.orderId;
+            r->consumer = consumerIndex(t, op.consumerUID, op.consumerType);
+            r->firstLine = (int32_t)t->lineCount;
+            r->lineCount = op.lineCount;
+            memcpy(t->lineIds + t->lineCount, op.menuIds, op.lineCount * sizeof(int32_t));
+            memcpy(t->lineQuantities + t->lineCount, op.quantities, op.lineCount * sizeof(int32_t));
+            t->lineCount = needed;
+            if (r->consumer < 0) break;
+        }
+    }
+    closeRecording(reader);
+    if (status != 0) {
+        fprintf(stderr, "%s: trace is corrupt or memory ran out after %ld operations\n", path, t->opCount);
+        freeTrace(t);
+        return -1;
+    }
+    return 0;
+}
+
+/* ===============================
+   Replaying
+   =============================== */
+
+/* Per-thread menu ID -> item table, so order lines do not add lookups the trace already has */
+typedef struct {
+    int *ids;
+    Menu **items;
+    int capacity;
+} ItemTable;
+
+static Menu* tableGet(const ItemTable *table, int id){
+    unsigned h = ((unsigned)id * 2654435761u) & (table->capacity - 1);
+    while (table->ids[h] != 0) {
+        if (table->ids[h] == id) return table->items[h];
+        h = (h + 1) & (table->capacity - 1);
+    }
+    return NULL;
+}
+
+static void tablePut(ItemTable *table, int id, Menu *item){
+    unsigned h = ((unsigned)id * 2654435761u) & (table->capacity - 1);
+    while (table->ids[h] != 0 && table->ids[h] != id) h = (h + 1) & (table->capacity - 1);
+    table->ids[h] = id;
+    table->items[h] = item;
+}
+
+static void waitUntil(uint64_t due){
+    for (;;) {
+        uint64_t now = benchNanos();
+        if (now >= due) return;
+        if (due - now > REPLAY_SPIN_NANOS) {
+            uint64_t nap = due - now - REPLAY_SPIN_NANOS;
+            struct timespec ts = { (time_t)(nap / 1000000000ULL), (long)(nap % 1000000000ULL) };
+            nanosleep(&ts, NULL);
+        }
+    }
+}
+
+static void* replayThread(void *arg){
+    ReplayThread *self = (ReplayThread *)arg;
+    const Trace *t = self->trace;
+    Menu *menu = NULL;
+    Consumer *consumers = NULL;
+    OrderQueue *queue = createOrderQueue();
+    OrderStack *stack = createOrderStack();
+    OrderArchive *archive = createOrderArchive();
+    Consumer **consumerAt = (Consumer **)malloc((t->uidCount + 1) * sizeof(Consumer *));
+    ItemTable table;
+
+    table.capacity = 64;
+    while (table.capacity < t->itemCount * 2) table.capacity *= 2;
+    table.ids = (int *)calloc(table.capacity, sizeof(int));
+    table.items = (Menu **)calloc(table.capacity, sizeof(Menu *));
+    if (!queue || !stack || !archive || !consumerAt || !table.ids || !table.items) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    for (int i = 0; i < t->uidCount; i++) {
+        addConsumer(&consumers, t->uids[i], t->uids[i], (ConsumerType)t->uidTypes[i]);
+        consumerAt[i] = consumers;
+    }
+    for (int k = 0; k < REPLAY_OP_KINDS; k++) resetHistogram(&self->latency[k]);
+
+    uint64_t first = t->opCount ? t->ops[0].nanos : 0;
+    for (long i = 0; i < t->opCount; i++) {
+        const ReplayOp *op = &t->ops[i];
+        uint64_t due = 0;
+        if (self->speed > 0) {
+            due = self->startNanos + (uint64_t)((op->nanos - first) / self->speed);
+            waitUntil(due);
+        }
+        uint64_t start = benchNanos();
+
+        switch (op->type) {
+        case RECORD_MENU_ITEM: {
+            const ReplayItem *item = &t->items[op->value];
+            if (!tableGet(&table, item->id)) {
+                addMenuItem(&menu, item->id, item->name, (ItemType)item->type, item->price,
+                            (uint16_t)item->quantity);
+                Menu *added = menu;
+                while (added->next) added = added->next;
+                tablePut(&table, item->id, added);
+            }
+            break;
+        }
+        case RECORD_MENU_LOOKUP: {
+            Menu *item = findMenuItem(menu, op->value);
+            sink += item ? item->quantity : 0;
+            break;
+        }
+        case RECORD_ORDER_PLACED: {
+            OrderItem *head = NULL, *tail = NULL;
+            float total = 0.0f;
+            for (int l = 0; l < op->lineCount; l++) {
+                Menu *item = tableGet(&table, t->lineIds[op->firstLine + l]);
+                int quantity = t->lineQuantities[op->firstLine + l];
+                if (!item) {
+                    self->missingItems++;
+                    continue;
+                }
+                /* restocks are not recorded; top up instead of refusing the line */
+                if (item->quantity < quantity) adjustItemQuantity(item, UINT16_MAX - item->quantity);
+                adjustItemQuantity(item, -quantity);
+                OrderItem *line = createOrderItem(item, quantity);
+                total += line->unitPrice * line->quantity;
+                if (tail) tail->next = line;
+                else head = line;
+                tail = line;
+            }
+            pushOrder(stack, enqueueConsumerOrder(queue, op->orderId, consumerAt[op->consumer],
+                                                  head, total));
+            break;
+        }
+        case RECORD_UNDO:
+            revertLastOrder(stack, queue);
+            break;
+        case RECORD_SERVE:
+            /* traces do not record kitchen stages, so serve in queue order */
+            serveOrder(queue, stack, archive, queue->front);
+            break;
+        }
+
+        uint64_t end = benchNanos();
+        histogramRecord(&self->latency[op->type], end - (due && due < start ? due : start));
+    }
+    self->elapsedNanos = benchNanos() - self->startNanos;
+
+    freeOrderStack(stack);
+    freeOrderQueue(queue);
+    freeOrderArchive(archive);
+    freeConsumers(consumers);
+    freeMenu(menu);
+    free(consumerAt);
+    free(table.ids);
+    free(table.items);
+    return NULL;
+}
+
+static void mergeHistogram(LatencyHistogram *into, const LatencyHistogram *from){
+    for (int i = 0; i < METRIC_BUCKETS; i++) into->counts[i] += from->counts[i];
+    into->total += from->total;
+    into->sum += from->sum;
+    if (from->min < into->min) into->min = from->min;
+    if (from->max > into->max) into->max = from->max;
+}
+
+int main(int argc, char *argv[]){
+    const char *path = NULL;
+    double speed = 0.0;
+    int threads = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--speed=", 8) == 0) {
+            speed = strcmp(argv[i] + 8, "max") == 0 ? 0.0 : atof(argv[i] + 8);
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            threads = atoi(argv[i] + 10);
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            path = NULL;
+            break;
+        }
+    }
+    if (!path || speed < 0 || threads < 1 || threads > REPLAY_MAX_THREADS) {
+        fprintf(stderr, "Usage: %s <trace> [--speed=N|max] [--threads=1..%d]\n",
+                argv[0], REPLAY_MAX_THREADS);
+        return 1;
+    }
+
+    static Trace trace;
+    if (loadTrace(path, &trace) != 0) return 1;
+    double span = trace.opCount ? (trace.ops[trace.opCount - 1].nanos - trace.ops[0].nanos) / 1e9 : 0.0;
+    printf("trace %s: %ld operations, %d menu items, %d consumers, %.1f s recorded\n",
+           path, trace.opCount, trace.itemCount, trace.uidCount, span);
+
+    static ReplayThread workers[REPLAY_MAX_THREADS];
+    pthread_t ids[REPLAY_MAX_THREADS];
+    uint64_t start = benchNanos() + 1000000;     /* common start, 1 ms out */
+    int saved = muteStdout();
+    for (int i = 0; i < threads; i++) {
+        workers[i].trace = &trace;
+        workers[i].speed = speed;
+        workers[i].startNanos = start;
+        pthread_create(&ids[i], NULL, replayThread, &workers[i]);
+    }
+    for (int i = 0; i < threads; i++) pthread_join(ids[i], NULL);
+    unmuteStdout(saved);
+
+    static LatencyHistogram merged[REPLAY_OP_KINDS];
+    uint64_t wall = 0;
+    long missing = 0, total = 0;
+    for (int k = 0; k < REPLAY_OP_KINDS; k++) resetHistogram(&merged[k]);
+    for (int i = 0; i < threads; i++) {
+        for (int k = 0; k < REPLAY_OP_KINDS; k++) mergeHistogram(&merged[k], &workers[i].latency[k]);
+        if (workers[i].elapsedNanos > wall) wall = workers[i].elapsedNanos;
+        missing += workers[i].missingItems;
+    }
+
+    printf("\n%-12s %10s %10s %10s %10s %10s %10s\n", "Op (us)", "Count", "p50", "p90", "p99", "p99.9", "Max");
+    for (int k = 1; k < REPLAY_OP_KINDS; k++) {
+        const LatencyHistogram *h = &merged[k];
+        total += (long)h->total;
+        if (h->total == 0) continue;
+        printf("%-12s %10llu %10.2f %10.2f %10.2f %10.2f %10.2f\n", opNames[k],
+               (unsigned long long)h->total,
+               histogramPercentile(h, 50.0) / 1e3, histogramPercentile(h, 90.0) / 1e3,
+               histogramPercentile(h, 99.0) / 1e3, histogramPercentile(h, 99.9) / 1e3, h->max / 1e3);
+    }
+    double seconds = wall / 1e9;
+    printf("\n%ld operations on %d thread(s) in %.3f s: %.0f ops/s (speed %s", total, threads,
+           seconds, seconds > 0 ? total / seconds : 0.0, speed > 0 ? "" : "max");
+    if (speed > 0) printf("%gx", speed);
+    printf(")\n");
+    if (missing) printf("%ld order lines referenced unknown menu items\n", missing);
+
+    freeTrace(&trace);
+    return 0;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file reportbench.c
+ * @brief Thread scaling benchmark for the report engine.
+ *
+ * Fills an archive with synthetic orders spread over a semester and
+ * times each report grouping with 1, 2, 4, ... worker threads.
+ *
+ * Usage: ReportBench.exe [orders] [max threads]
+ */
+
+#include "../include/reportengine.h"
+
+#define BENCH_ITEMS 40
+#define BENCH_CONSUMERS 500
+#define BENCH_DAYS 120
+#define BENCH_RUNS 5
+
+static unsigned long long rngState = 88172645463325252ULL;
+
+static unsigned nextRandom(void){
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return (unsigned)(rngState >> 32);
+}
+
+static OrderArchive* buildArchive(long orders, Menu **items){
+    OrderArchive *archive = createOrderArchive();
+    OrderItem lines[4];
+    char uid[16], name[32];
+    time_t start = 1735689600;     /* 2025-01-01 */
+    double step = (double)BENCH_DAYS * ARCHIVE_DAY_SECONDS / orders;
+
+    for (long k = 0; k < orders; k++) {
+        Order order;
+        int consumer = nextRandom() % BENCH_CONSUMERS;
+        int count = 1 + nextRandom() % 4;
+
+        memset(&order, 0, sizeof(order));
+        snprintf(uid, sizeof(uid), "C%04d", consumer);
+        snprintf(name, sizeof(name), "Consumer %d", consumer);
+        order.orderId = (uint16_t)(k + 1);
+        order.consumerUID = uid;
+        order.consumerName = name;
+        order.consumerType = (ConsumerType)(consumer % 3);
+        order.orderTime = start + (time_t)(k * step);
+        for (int i = 0; i < count; i++) {
+            lines[i].menuItem = items[nextRandom() % BENCH_ITEMS];
+            lines[i].quantity = 1 + nextRandom() % 3;
+            lines[i].unitPrice = lines[i].menuItem->price;
+            lines[i].next = i + 1 < count ? &lines[i + 1] : NULL;
+            order.totalAmount += lines[i].unitPrice * lines[i].quantity;
+        }
+        order.items = lines;
+        if (archiveOrder(archive, &order) != 0) exit(1);
+    }
+    return archive;
+}
+
+int main(int argc, char *argv[]){
+    static const char *groupNames[] = { "item", "consumer type", "day", "hour" };
+    long orders = argc > 1 ? atol(argv[1]) : 500000;
+    int maxThreads = argc > 2 ? atoi(argv[2]) : 8;
+    Menu *items[BENCH_ITEMS];
+
+    for (int i = 0; i < BENCH_ITEMS; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "Item %d", i + 1);
+        items[i] = createMenuItem(i + 1, name, (ItemType)(i % 3), 20.0f + i * 5.0f, 100);
+    }
+    OrderArchive *archive = buildArchive(orders, items);
+    ReportFilter filter = reportFilterRange(0, (time_t)1 << 40);
+
+    printf("%ld orders, %d segments\n", archive->totalOrders, archive->segmentCount);
+    printf("%-14s %8s %12s %9s %16s\n", "Group", "Threads", "Best ms", "Speedup", "Revenue");
+    for (int g = REPORT_BY_ITEM; g <= REPORT_BY_HOUR; g++) {
+        double base = 0.0;
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            double best = -1.0, revenue = 0.0;
+            for (int run = 0; run < BENCH_RUNS; run++) {
+                Report *report = runReport(archive, &filter, (ReportGroup)g, threads);
+                if (!report) return 1;
+                if (best < 0 || report->seconds < best) best = report->seconds;
+                revenue = 0.0;
+                for (int i = 0; i < report->count; i++) revenue += report->rows[i].revenue;
+                freeReport(report);
+            }
+            if (threads == 1) base = best;
+            printf("%-14s %8d %12.2f %8.2fx %16.2f\n", groupNames[g], threads,
+                   best * 1000.0, base / best, revenue);
+        }
+    }
+
+    freeOrderArchive(archive);
+    for (int i = 0; i + 1 < BENCH_ITEMS; i++) items[i]->next = items[i + 1];
+    freeMenu(items[0]);
+    return 0;
+}
@@ -0,0 +1,519 @@
+/**
+ * @file simulate.c
+ * @brief Deterministic simulation of canteen days on a virtual clock.
+ *
+ * Consumers arrive during opening hours (a steady base rate plus lunch
+ * and dinner peaks), place generated orders, sometimes cancel them, and
+ * kitchen stations prepare them; consumers collect their orders once
+ * ready. The kitchen starts orders in queue order (--policy=fifo) or
+ * through the priority scheduler (--policy=priority); --bulk=P makes a
+ * share of the orders five times larger, like staff event orders.
+ * Time advances in one-second virtual steps, so days run in
+ * milliseconds. The library's clock and randomness come from a
+ * VirtualClock, so the same options always give the same output; the
+ * fingerprint line makes comparing runs between builds a one-liner.
+ *
+ * The ready-in estimate each consumer would be shown at the till is
+ * compared with when the order is actually ready.
+ *
+ * --max-queue=N, --max-station=N (units per station) and --max-wait=MIN
+ * put the intake gate in front of the queue; consumers turned away at
+ * the till leave without ordering.
+ *
+ * --preorder=P makes a share of the consumers pre-order for a pickup
+ * slot 30-120 min ahead; the stock is held until 15 min after the slot.
+ * They come in during the first 10 min of the slot and claim it, except
+ * a --noshow=P share who never come and whose hold expires.
+ *
+ * Simulated results go to stdout, real run time to stderr.
+ *
+ * --record=FILE writes the run as an operation trace for Replay.exe.
+ *
+ * Usage: Simulate.exe [--days=N] [--stations=N] [--base=N] [--peak=N]
+ *                     [--policy=fifo|priority] [--bulk=P]
+ *                     [--max-queue=N] [--max-station=N] [--max-wait=MIN]
+ *                     [--preorder=P] [--noshow=P]
+ *                     [--record=FILE] [workload options...]
+ */
+
+#include <math.h>
+#include "workload.h"
+#include "../include/order.h"
+#include "../include/undo.h"
+#include "../include/archive.h"
+#include "../include/ordertrace.h"
+#include "../include/clocksource.h"
+#include "../include/memtrack.h"
+#include "../include/recorder.h"
+#include "../include/scheduler.h"
+#include "../include/waitestimate.h"
+#include "../include/intake.h"
+#include "../include/reservation.h"
+
+#define SIM_EPOCH 1736121600        /* Monday 2025-01-06 00:00 UTC */
+#define SIM_OPEN_HOUR 8
+#define SIM_CLOSE_HOUR 20
+#define SIM_MAX_STATIONS 32
+#define NANOS_PER_SECOND 1000000000ULL
+#define SIM_UNIT_GUESS (45 * NANOS_PER_SECOND)    /* prep time per unit before anything is learned */
+#define SIM_SLOT_SECONDS (15 * 60)                 /* pickup slots, also the grace after a slot */
+
+typedef struct {
+    int days;
+    int stations;
+    double baseRate;                /* orders per hour all day */
+    double peakRate;                /* extra orders per hour at the lunch peak */
+    int priority;                   /* 1: kitchen uses the scheduler, 0: FIFO */
+    double bulkRate;                /* share of orders that are bulk */
+    IntakeLimits limits;            /* all 0: every order is admitted */
+    double preorderRate;            /* share of consumers who pre-order a pickup slot */
+    double noShowRate;              /* share of pre-orders never collected */
+} SimConfig;
+
+typedef struct {
+    Order *order;
+    uint64_t doneAt;                /* virtual second the order is ready */
+} Station;
+
+typedef struct {
+    long placed;
+    long cancelled;
+    long cancelRefused;
+    long served;
+    long rejectedLines;
+    int peakQueue;
+    long turnedAway;
+} DayStats;
+
+typedef struct {
+    Workload *workload;
+    VirtualClock clock;
+    OrderQueue *queue;
+    OrderStack *stack;
+    OrderArchive *archive;
+    Station stations[SIM_MAX_STATIONS];
+    int stationCount;
+    OrderScheduler *scheduler;      /* NULL for FIFO */
+    SchedulerConfig classes;        /* classifies orders for the per-class waits */
+    LatencyHistogram classWait[PRIORITY_CLASS_COUNT];
+    WaitEstimator *eta;
+    IntakeControl *intake;
+    ReservationBook *reservations;  /* pre-orders holding stock */
+    TimingWheel pickups;            /* when pre-ordering consumers come in */
+    uint32_t preorderThreshold;     /* pre-order chance scaled to 2^32 */
+    uint32_t noShowThreshold;       /* no-show chance scaled to 2^32 */
+    DayStats *today;                /* day being simulated, for the pickup callback */
+    uint64_t promisedReady[UINT16_MAX + 1];     /* by order ID: ready time shown at the till */
+    LatencyHistogram etaError;
+    uint32_t bulkThreshold;         /* bulk chance scaled to 2^32 */
+    Order *pendingCancel;           /* order its consumer will try to cancel */
+    uint64_t cancelAt;
+    long nextOrderId;
+    uint32_t arrivalThreshold[24 * 60];  /* per-second arrival chance per minute of day, scaled to 2^32 */
+} Simulation;
+
+static uint64_t nowSeconds(const Simulation *sim){
+    return sim->clock.nanos / NANOS_PER_SECOND;
+}
+
+/* Base rate plus a lunch peak at 12:45 and a smaller dinner peak at 18:30 */
+static void buildArrivalCurve(Simulation *sim, const SimConfig *config){
+    for (int minute = 0; minute < 24 * 60; minute++) {
+        double hour = minute / 60.0;
+        double rate = 0.0;
+        if (hour >= SIM_OPEN_HOUR && hour < SIM_CLOSE_HOUR) {
+            double lunch = (hour - 12.75) / 0.6, dinner = (hour - 18.5) / 0.5;
+            rate = config->baseRate
+                 + config->peakRate * exp(-0.5 * lunch * lunch)
+                 + 0.4 * config->peakRate * exp(-0.5 * dinner * dinner);
+        }
+        double perSecond = rate / 3600.0;
+        if (perSecond > 1.0) perSecond = 1.0;
+        sim->arrivalThreshold[minute] = (uint32_t)(perSecond * 4294967295.0);
+    }
+}
+
+static void restock(Simulation *sim){
+    for (Menu *item = sim->workload->menu; item != NULL; item = item->next) {
+        adjustItemQuantity(item, WORKLOAD_STOCK - item->quantity);
+    }
+}
+
+typedef struct {
+    TimerNode timer;                /* first: the callback gets the Pickup */
+    Reservation *reservation;
+} Pickup;
+
+static void place(Simulation *sim, DayStats *day, Order *order){
+    sim->promisedReady[order->orderId] = clockNanos() + estimateOrderReadyIn(sim->eta, order);
+    pushOrder(sim->stack, order);
+    day->placed++;
+    if (sim->queue->count > day->peakQueue) day->peakQueue = sim->queue->count;
+}
+
+static int nextOrderId(Simulation *sim){
+    return (int)(sim->nextOrderId++ % 65535) + 1;
+}
+
+/* A pre-ordering consumer came in: the held basket joins the queue */
+static void pickUp(TimerNode *timer, void *context){
+    Simulation *sim = (Simulation *)context;
+    Pickup *pickup = (Pickup *)timer;
+    place(sim, sim->today, claimReservation(sim->reservations, pickup->reservation, sim->queue, nextOrderId(sim)));
+    free(pickup);
+}
+
+static void preorder(Simulation *sim, const WorkloadOrder *generated, OrderItem *items, float total){
+    uint64_t slot = (nowSeconds(sim) + 1800 + workloadRandom(sim->workload) % 5400) / SIM_SLOT_SECONDS + 1;
+    uint64_t slotStart = slot * SIM_SLOT_SECONDS;
+    Reservation *reservation = reserveStock(sim->reservations, generated->consumer, items, total,
+                                            (slotStart + SIM_SLOT_SECONDS) * NANOS_PER_SECOND);
+    if (!reservation) {
+        discardOrderItems(items);
+        return;
+    }
+    if (workloadRandom(sim->workload) < sim->noShowThreshold) return;
+
+    Pickup *pickup = (Pickup *)calloc(1, sizeof(Pickup));
+    if (!pickup) return;
+    pickup->reservation = reservation;
+    armTimer(&sim->pickups, &pickup->timer, (slotStart + workloadRandom(sim->workload) % 600) * NANOS_PER_SECOND);
+}
+
+static void arrive(Simulation *sim, DayStats *day){
+    WorkloadOrder generated;
+    OrderItem *head = NULL, *tail = NULL;
+    float total = 0.0f;
+
+    nextWorkloadOrder(sim->workload, &generated);
+    if (sim->bulkThreshold && workloadRandom(sim->workload) < sim->bulkThreshold) {
+        for (int k = 0; k < generated.lineCount; k++) generated.quantities[k] *= 5;
+    }
+    for (int k = 0; k < generated.lineCount; k++) {
+        Menu *item = findMenuItem(sim->workload->menu, generated.menuIds[k]);
+        if (!item || item->quantity < generated.quantities[k]) {
+            day->rejectedLines++;
+            continue;
+        }
+        adjustItemQuantity(item, -generated.quantities[k]);
+        OrderItem *line = createOrderItem(item, generated.quantities[k]);
+        total += line->unitPrice * line->quantity;
+        if (tail) tail->next = line;
+        else head = line;
+        tail = line;
+    }
+    if (!head) return;
+    if (sim->preorderThreshold && workloadRandom(sim->workload) < sim->preorderThreshold) {
+        preorder(sim, &generated, head, total);
+        return;
+    }
+
+    int orderId = (int)(sim->nextOrderId % 65535) + 1;
+    Order *order = submitOrder(sim->intake, sim->queue, orderId, generated.consumer, head, total, NULL);
+    if (!order) {
+        discardOrderItems(head);
+        day->turnedAway++;
+        return;
+    }
+    sim->nextOrderId++;
+    place(sim, day, order);
+
+    if (generated.undo) {
+        sim->pendingCancel = order;
+        sim->cancelAt = nowSeconds(sim) + 5 + clockRandom() % 56;
+    }
+}
+
+/* Only the newest order can be undone; undoLastOrder() refuses once the kitchen has started it */
+static void cancelIfDue(Simulation *sim, DayStats *day){
+    if (!sim->pendingCancel || nowSeconds(sim) < sim->cancelAt) return;
+
+    Order *order = sim->pendingCancel;
+    sim->pendingCancel = NULL;
+    if (sim->stack->top && sim->stack->top->order == order && undoLastOrder(sim->stack, sim->queue) == 0) {
+        day->cancelled++;
+    } else {
+        day->cancelRefused++;
+    }
+}
+
+static uint64_t preparationSeconds(const Order *order){
+    uint64_t units = 0;
+    for (const OrderItem *line = order->items; line != NULL; line = line->next) {
+        units += line->quantity;
+    }
+    uint64_t nominal = 30 + 15 * units;
+    return nominal * (75 + clockRandom() % 51) / 100;     /* +-25% */
+}
+
+static void runKitchen(Simulation *sim, DayStats *day){
+    uint64_t now = nowSeconds(sim);
+    for (int s = 0; s < sim->stationCount; s++) {
+        Station *station = &sim->stations[s];
+        if (station->order && now >= station->doneAt) {
+            markOrderStage(station->order, STAGE_READY);
+            uint64_t ready = station->order->stageNanos[STAGE_READY];
+            uint64_t promised = sim->promisedReady[station->order->orderId];
+            histogramRecord(&sim->etaError, ready > promised ? ready - promised : promised - ready);
+            station->order = NULL;
+        }
+        if (!station->order) {
+            Order *order = sim->scheduler ? startScheduledOrder(sim->scheduler) : startNextOrder(sim->queue);
+            if (order) {
+                histogramRecord(&sim->classWait[classifyOrder(&sim->classes, order)],
+                                orderStageNanos(order, STAGE_QUEUED, STAGE_STARTED));
+                if (order == sim->pendingCancel) {
+                    /* too late to cancel; also keeps pendingCancel from dangling */
+                    sim->pendingCancel = NULL;
+                    day->cancelRefused++;
+                }
+                station->order = order;
+                station->doneAt = now + preparationSeconds(order);
+            }
+        }
+    }
+}
+
+/* Consumers pick up their order at the counter 10-89 s after it is ready */
+static void collect(Simulation *sim, DayStats *day){
+    uint64_t now = clockNanos();
+    Order *order = sim->queue->front;
+    while (order) {
+        Order *next = order->next;
+        uint64_t ready = order->stageNanos[STAGE_READY];
+        uint64_t delay = (10 + (order->orderId * 2654435761u) % 80) * NANOS_PER_SECOND;
+        if (ready != 0 && now >= ready + delay) {
+            if (serveOrder(sim->queue, sim->stack, sim->archive, order) >= 0) day->served++;
+        }
+        order = next;
+    }
+}
+
+static int kitchenBusy(const Simulation *sim){
+    for (int s = 0; s < sim->stationCount; s++) {
+        if (sim->stations[s].order) return 1;
+    }
+    return 0;
+}
+
+static void simulateDay(Simulation *sim, int dayIndex, DayStats *day){
+    uint64_t dayStart = (uint64_t)dayIndex * 86400;
+    uint64_t open = dayStart + SIM_OPEN_HOUR * 3600, close = dayStart + SIM_CLOSE_HOUR * 3600;
+
+    sim->clock.nanos = open * NANOS_PER_SECOND;
+    sim->today = day;
+    restock(sim);
+    for (;;) {
+        uint64_t now = nowSeconds(sim);
+        if (now < close) {
+            int minute = (int)((now - dayStart) / 60);
+            if (workloadRandom(sim->workload) < sim->arrivalThreshold[minute]) {
+                arrive(sim, day);
+            }
+        } else if (sim->queue->count == 0 && !kitchenBusy(sim) && sim->reservations->held == 0) {
+            break;              /* closed and everyone has been served */
+        }
+        advanceTimingWheel(&sim->pickups, clockNanos());
+        expireReservations(sim->reservations);
+        cancelIfDue(sim, day);
+        runKitchen(sim, day);
+        collect(sim, day);
+        advanceVirtualClock(&sim->clock, NANOS_PER_SECOND);
+    }
+}
+
+/* FNV-1a over everything the run produced, for comparing runs */
+static uint64_t fingerprint(uint64_t hash, const void *data, size_t size){
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint64_t fingerprintRun(const Simulation *sim, const OrderWaitStats *waits){
+    uint64_t hash = 14695981039346656037ULL;
+    ArchiveCursor cursor;
+    ArchivedOrder row;
+
+    archiveSeek(sim->archive, 0, (time_t)INT64_MAX, &cursor);
+    while (archiveNext(&cursor, &row)) {
+        int64_t when = (int64_t)row.orderTime;
+        hash = fingerprint(hash, &when, sizeof(when));
+        hash = fingerprint(hash, &row.orderId, sizeof(row.orderId));
+        hash = fingerprint(hash, row.consumerUID, strlen(row.consumerUID));
+        hash = fingerprint(hash, &row.totalAmount, sizeof(row.totalAmount));
+        hash = fingerprint(hash, row.menuIds, row.lineCount * sizeof(int32_t));
+        hash = fingerprint(hash, row.quantities, row.lineCount * sizeof(int32_t));
+    }
+    hash = fingerprint(hash, waits, sizeof(*waits));
+    return hash;
+}
+
+static void printWaitSeconds(const char *name, const LatencyHistogram *h){
+    if (h->total == 0) {
+        printf("%-12s %8d\n", name, 0);
+        return;
+    }
+    printf("%-12s %8llu %8.1f %8.1f %8.1f %8.1f %8.1f\n", name, (unsigned long long)h->total,
+           h->sum / (double)h->total / 1e9, histogramPercentile(h, 50.0) / 1e9,
+           histogramPercentile(h, 90.0) / 1e9, histogramPercentile(h, 99.0) / 1e9, h->max / 1e9);
+}
+
+static int parseSimOption(SimConfig *config, const char *arg){
+    if (strncmp(arg, "--days=", 7) == 0) config->days = atoi(arg + 7);
+    else if (strncmp(arg, "--stations=", 11) == 0) config->stations = atoi(arg + 11);
+    else if (strncmp(arg, "--base=", 7) == 0) config->baseRate = atof(arg + 7);
+    else if (strncmp(arg, "--peak=", 7) == 0) config->peakRate = atof(arg + 7);
+    else if (strcmp(arg, "--policy=fifo") == 0) config->priority = 0;
+    else if (strcmp(arg, "--policy=priority") == 0) config->priority = 1;
+    else if (strncmp(arg, "--bulk=", 7) == 0) config->bulkRate = atof(arg + 7);
+    else if (strncmp(arg, "--max-queue=", 12) == 0) config->limits.maxQueueDepth = atoi(arg + 12);
+    else if (strncmp(arg, "--max-wait=", 11) == 0) config->limits.maxWaitNanos = (uint64_t)(atof(arg + 11) * 60e9);
+    else if (strncmp(arg, "--preorder=", 11) == 0) config->preorderRate = atof(arg + 11);
+    else if (strncmp(arg, "--noshow=", 9) == 0) config->noShowRate = atof(arg + 9);
+    else if (strncmp(arg, "--max-station=", 14) == 0) {
+        for (int s = 0; s < INTAKE_STATIONS; s++) config->limits.maxStationUnits[s] = atoi(arg + 14);
+    }
+    else return -1;
+
+    if (config->days < 1) config->days = 1;
+    if (config->stations < 1) config->stations = 1;
+    if (config->stations > SIM_MAX_STATIONS) config->stations = SIM_MAX_STATIONS;
+    if (config->baseRate < 0) config->baseRate = 0;
+    if (config->peakRate < 0) config->peakRate = 0;
+    if (config->bulkRate < 0) config->bulkRate = 0;
+    if (config->bulkRate > 1) config->bulkRate = 1;
+    if (config->preorderRate < 0) config->preorderRate = 0;
+    if (config->preorderRate > 1) config->preorderRate = 1;
+    if (config->noShowRate < 0) config->noShowRate = 0;
+    if (config->noShowRate > 1) config->noShowRate = 1;
+    if (config->limits.maxQueueDepth < 0) config->limits.maxQueueDepth = 0;
+    for (int s = 0; s < INTAKE_STATIONS; s++) {
+        if (config->limits.maxStationUnits[s] < 0) config->limits.maxStationUnits[s] = 0;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]){
+    WorkloadConfig workloadConfig = defaultWorkloadConfig();
+    SimConfig config = { .days = 5, .stations = 6, .baseRate = 30.0, .peakRate = 300.0 };
+    const char *recordPath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--record=", 9) == 0) {
+            recordPath = argv[i] + 9;
+            continue;
+        }
+        if (parseSimOption(&config, argv[i]) != 0 && parseWorkloadOption(&workloadConfig, argv[i]) != 0) {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            fprintf(stderr, "Usage: %s [--days=N] [--stations=N] [--base=N] [--peak=N] "
+                            "[--policy=fifo|priority] [--bulk=P] [--max-queue=N] [--max-station=N] "
+                            "[--max-wait=MIN] [--preorder=P] [--noshow=P] [--seed=N] "
+                            "[--consumers=N] [--menu=N] [--items=N] [--quantity=N] [--undo=P] "
+                            "[--skew=S] [--record=FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    static Simulation sim;
+    sim.workload = createWorkload(&workloadConfig);
+    sim.queue = createOrderQueue();
+    sim.stack = createOrderStack();
+    sim.archive = createOrderArchive();
+    if (!sim.workload || !sim.queue || !sim.stack || !sim.archive) return 1;
+    sim.stationCount = config.stations;
+    sim.classes = defaultSchedulerConfig();
+    sim.bulkThreshold = (uint32_t)(config.bulkRate * 4294967295.0);
+    sim.preorderThreshold = (uint32_t)(config.preorderRate * 4294967295.0);
+    sim.noShowThreshold = (uint32_t)(config.noShowRate * 4294967295.0);
+    for (int c = 0; c < PRIORITY_CLASS_COUNT; c++) resetHistogram(&sim.classWait[c]);
+    resetHistogram(&sim.etaError);
+    if (!(sim.eta = createWaitEstimator(config.stations, SIM_UNIT_GUESS))) return 1;
+    if (!(sim.intake = createIntakeControl(sim.queue, &config.limits, sim.eta))) return 1;
+    if (config.priority && !(sim.scheduler = createOrderScheduler(&sim.classes))) return 1;
+    buildArrivalCurve(&sim, &config);
+
+    initVirtualClock(&sim.clock, SIM_EPOCH, workloadConfig.seed);
+    useVirtualClock(&sim.clock);
+    resetOrderTrace();
+    /* both wheels start at the virtual time */
+    if (!(sim.reservations = createReservationBook(NANOS_PER_SECOND))) return 1;
+    initTimingWheel(&sim.pickups, NANOS_PER_SECOND, clockNanos(), pickUp, &sim);
+    if (recordPath && startRecording(recordPath, sim.workload->menu) != 0) return 1;
+
+    printf("# day placed cancelled cancel_refused served rejected_lines peak_queue revenue turned_away\n");
+    DayStats total = { 0, 0, 0, 0, 0, 0, 0 };
+    uint64_t started = benchNanos();
+    for (int d = 0; d < config.days; d++) {
+        DayStats day = { 0, 0, 0, 0, 0, 0, 0 };
+
+        int saved = muteStdout();
+        simulateDay(&sim, d, &day);
+        unmuteStdout(saved);
+
+        double revenue = 0.0;
+        time_t from = SIM_EPOCH + (time_t)d * 86400;
+        archiveRangeTotals(sim.archive, from, from + 86400, &revenue);
+        printf("day %d %ld %ld %ld %ld %ld %d %.2f %ld\n", d + 1, day.placed, day.cancelled,
+               day.cancelRefused, day.served, day.rejectedLines, day.peakQueue, revenue, day.turnedAway);
+        total.placed += day.placed;
+        total.cancelled += day.cancelled;
+        total.served += day.served;
+        total.turnedAway += day.turnedAway;
+    }
+    uint64_t elapsed = benchNanos() - started;
+    if (recordPath) {
+        long recorded = stopRecording();
+        fprintf(stderr, "%ld operations recorded to %s\n", recorded, recordPath);
+    }
+
+    OrderWaitStats waits;
+    getOrderWaitStats(&waits);
+    printf("\n%-12s %8s %8s %8s %8s %8s %8s\n", "Stage (s)", "Orders", "Mean", "p50", "p90", "p99", "Max");
+    printWaitSeconds("Queue wait", &waits.queueWait);
+    printWaitSeconds("Service", &waits.service);
+    printWaitSeconds("Turnaround", &waits.turnaround);
+    printf("\n%-12s %8s %8s %8s %8s %8s   (%s)\n", "Wait (s)", "Orders", "Mean", "p50", "p95", "Max",
+           config.priority ? "priority" : "fifo");
+    for (int c = 0; c < PRIORITY_CLASS_COUNT; c++) {
+        const LatencyHistogram *h = &sim.classWait[c];
+        if (h->total == 0) continue;
+        printf("%-12s %8llu %8.1f %8.1f %8.1f %8.1f\n", priorityClassName((PriorityClass)c),
+               (unsigned long long)h->total, h->sum / (double)h->total / 1e9,
+               histogramPercentile(h, 50.0) / 1e9, histogramPercentile(h, 95.0) / 1e9, h->max / 1e9);
+    }
+    printf("\nready-in estimate off by: p50 %.1f s, p90 %.1f s, p99 %.1f s (%ld kitchen runs learned)\n",
+           histogramPercentile(&sim.etaError, 50.0) / 1e9, histogramPercentile(&sim.etaError, 90.0) / 1e9,
+           histogramPercentile(&sim.etaError, 99.0) / 1e9, sim.eta->samples);
+    if (total.turnedAway) {
+        printf("turned away %ld of %ld:", total.turnedAway, total.turnedAway + total.placed);
+        for (int r = INTAKE_ACCEPTED + 1; r < INTAKE_RESULT_COUNT; r++) {
+            if (sim.intake->decisions[r]) printf(" %s %ld;", intakeResultText((IntakeResult)r), sim.intake->decisions[r]);
+        }
+        printf("\n");
+    }
+    if (sim.reservations->claimed + sim.reservations->expired) {
+        printf("pre-orders: %ld claimed, %ld expired unclaimed (%ld units back in stock)\n",
+               sim.reservations->claimed, sim.reservations->expired, sim.reservations->unitsReleased);
+    }
+    printf("throughput %.1f orders/open hour\n",
+           total.served / (double)(config.days * (SIM_CLOSE_HOUR - SIM_OPEN_HOUR)));
+    printf("fingerprint %016llx\n", (unsigned long long)fingerprintRun(&sim, &waits));
+
+    fprintf(stderr, "simulated %d day(s), %ld orders in %.1f ms\n",
+            config.days, total.placed, elapsed / 1e6);
+
+    setClockSource(NULL);
+    freeOrderScheduler(sim.scheduler);
+    freeReservationBook(sim.reservations);
+    freeIntakeControl(sim.intake);
+    freeWaitEstimator(sim.eta);
+    freeOrderStack(sim.stack);
+    freeOrderQueue(sim.queue);
+    freeOrderArchive(sim.archive);
+    freeWorkload(sim.workload);
+    reportMemoryLeaks(stderr);
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include <fcntl.h>
+#include <math.h>
+#include <unistd.h>
+#include "workload.h"
+
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+WorkloadConfig defaultWorkloadConfig(void){
+    WorkloadConfig config;
+    config.seed = 20250101;
+    config.consumers = 200;
+    config.menuItems = 50;
+    config.maxItemsPerOrder = 4;
+    config.maxQuantity = 3;
+    config.undoRate = 0.05;
+    config.skew = 1.0;
+    config.orders = 100000;
+    config.queueDepth = 64;
+    return config;
+}
+
+int parseWorkloadOption(WorkloadConfig *config, const char *arg){
+    const char *eq = strchr(arg, '=');
+    if (strncmp(arg, "--", 2) != 0 || !eq) return -1;
+
+    size_t n = eq - arg - 2;
+    const char *name = arg + 2;
+    const char *value = eq + 1;
+    if (n == 4 && strncmp(name, "seed", n) == 0) config->seed = strtoull(value, NULL, 10);
+    else if (n == 9 && strncmp(name, "consumers", n) == 0) config->consumers = atoi(value);
+    else if (n == 4 && strncmp(name, "menu", n) == 0) config->menuItems = atoi(value);
+    else if (n == 5 && strncmp(name, "items", n) == 0) config->maxItemsPerOrder = atoi(value);
+    else if (n == 8 && strncmp(name, "quantity", n) == 0) config->maxQuantity = atoi(value);
+    else if (n == 4 && strncmp(name, "undo", n) == 0) config->undoRate = atof(value);
+    else if (n == 4 && strncmp(name, "skew", n) == 0) config->skew = atof(value);
+    else if (n == 6 && strncmp(name, "orders", n) == 0) config->orders = atol(value);
+    else if (n == 5 && strncmp(name, "depth", n) == 0) config->queueDepth = atoi(value);
+    else return -1;
+
+    if (config->consumers < 1) config->consumers = 1;
+    if (config->menuItems < 1) config->menuItems = 1;
+    if (config->maxItemsPerOrder < 1) config->maxItemsPerOrder = 1;
+    if (config->maxItemsPerOrder > WORKLOAD_MAX_LINES) config->maxItemsPerOrder = WORKLOAD_MAX_LINES;
+    if (config->maxQuantity < 1) config->maxQuantity = 1;
+    if (config->orders < 1) config->orders = 1;
+    if (config->queueDepth < 1) config->queueDepth = 1;
+    return 0;
+}
+
+uint32_t workloadRandom(Workload *workload){
+    /* xorshift64* */
+    workload->state ^= workload->state >> 12;
+    workload->state ^= workload->state << 25;
+    workload->state ^= workload->state >> 27;
+    return (uint32_t)((workload->state * 2685821657736338717ULL) >> 32);
+}
+
+static double randomUnit(Workload *workload){
+    return workloadRandom(workload) / 4294967296.0;
+}
+
+Workload* createWorkload(const WorkloadConfig *config){
+    Workload *w = (Workload *)calloc(1, sizeof(Workload));
+    if (!w) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    w->config = *config;
+    w->state = config->seed ? config->seed : 1;
+    w->rankToId = (int *)malloc(config->menuItems * sizeof(int));
+    w->rankCdf = (double *)malloc(config->menuItems * sizeof(double));
+    w->consumerAt = (Consumer **)malloc(config->consumers * sizeof(Consumer *));
+    if (!w->rankToId || !w->rankCdf || !w->consumerAt) {
+        fprintf(stderr, "Memory allocation failed\n");
+        freeWorkload(w);
+        return NULL;
+    }
+
+    Menu *tail = NULL;
+    for (int i = 0; i < config->menuItems; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "Item %d", i + 1);
+        Menu *item = createMenuItem(i + 1, name, (ItemType)(i % 3),
+                                    10.0f + (workloadRandom(w) % 200) * 0.5f, WORKLOAD_STOCK);
+        if (!item) {
+            freeWorkload(w);
+            return NULL;
+        }
+        if (tail) {
+            tail->next = item;
+            item->prev = tail;
+        } else {
+            w->menu = item;
+        }
+        tail = item;
+    }
+
+    /* Zipf weights 1 / rank^skew, ranks shuffled over IDs */
+    double sum = 0.0;
+    for (int r = 0; r < config->menuItems; r++) {
+        sum += 1.0 / pow(r + 1, config->skew);
+        w->rankCdf[r] = sum;
+        w->rankToId[r] = r + 1;
+    }
+    for (int r = 0; r < config->menuItems; r++) {
+        w->rankCdf[r] /= sum;
+    }
+    for (int r = config->menuItems - 1; r > 0; r--) {
+        int k = workloadRandom(w) % (r + 1);
+        int id = w->rankToId[r];
+        w->rankToId[r] = w->rankToId[k];
+        w->rankToId[k] = id;
+    }
+
+    for (int i = config->consumers - 1; i >= 0; i--) {
+        char uid[16], name[32];
+        snprintf(uid, sizeof(uid), "S%05d", i + 1);
+        snprintf(name, sizeof(name), "Consumer%d", i + 1);
+        addConsumer(&w->consumers, uid, name, (ConsumerType)(i % 3));
+        w->consumerAt[i] = w->consumers;
+    }
+    return w;
+}
+
+int randomMenuId(Workload *workload){
+    double u = randomUnit(workload);
+    int lo = 0, hi = workload->config.menuItems - 1;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (workload->rankCdf[mid] < u) lo = mid + 1;
+        else hi = mid;
+    }
+    return workload->rankToId[lo];
+}
+
+Consumer* randomConsumer(Workload *workload){
+    return workload->consumerAt[workloadRandom(workload) % workload->config.consumers];
+}
+
+void nextWorkloadOrder(Workload *workload, WorkloadOrder *order){
+    const WorkloadConfig *config = &workload->config;
+    order->consumer = randomConsumer(workload);
+    order->lineCount = 1 + workloadRandom(workload) % config->maxItemsPerOrder;
+    for (int i = 0; i < order->lineCount; i++) {
+        order->menuIds[i] = randomMenuId(workload);
+        order->quantities[i] = 1 + workloadRandom(workload) % config->maxQuantity;
+    }
+    order->undo = randomUnit(workload) < config->undoRate;
+}
+
+void freeWorkload(Workload *workload){
+    if (!workload) return;
+    freeMenu(workload->menu);
+    freeConsumers(workload->consumers);
+    free(workload->rankToId);
+    free(workload->rankCdf);
+    free(workload->consumerAt);
+    free(workload);
+}
+
+uint64_t benchNanos(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void printBenchResult(FILE *out, const char *bench, long iterations, uint64_t elapsedNs,
+                      const WorkloadConfig *config){
+    double perOp = iterations > 0 ? (double)elapsedNs / iterations : 0.0;
+    fprintf(out, "{\"bench\":\"%s\",\"iterations\":%ld,\"total_ns\":%llu,"
+                 "\"ns_per_op\":%.2f,\"ops_per_sec\":%.0f,",
+            bench, iterations, (unsigned long long)elapsedNs, perOp,
+            perOp > 0 ? 1e9 / perOp : 0.0);
+    fprintf(out, "\"config\":{\"seed\":%llu,\"consumers\":%d,\"menu\":%d,\"items\":%d,"
+                 "\"quantity\":%d,\"undo\":%.3f,\"skew\":%.2f,\"orders\":%ld,\"depth\":%d}}\n",
+            config->seed, config->consumers, config->menuItems, config->maxItemsPerOrder,
+            config->maxQuantity, config->undoRate, config->skew, config->orders,
+            config->queueDepth);
+    fflush(out);
+}
+
+int muteStdout(void){
+    fflush(stdout);
+    int saved = dup(fileno(stdout));
+    int null = open(NULL_DEVICE, O_WRONLY);
+    if (null >= 0) {
+        dup2(null, fileno(stdout));
+        close(null);
+    }
+    return saved;
+}
+
+void unmuteStdout(int saved){
+    fflush(stdout);
+    if (saved >= 0) {
+        dup2(saved, fileno(stdout));
+        close(saved);
+    }
+}
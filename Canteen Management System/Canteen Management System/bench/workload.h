@@ -0,0 +1,189 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "../include/menuitem.h"
+#include "../include/consumer.h"
+
+/**
+ * @file workload.h
+ * @brief Deterministic lunch-rush workload generator for benchmarks.
+ *
+ * This header file defines a generator that builds a menu and a
+ * consumer list and then produces a reproducible stream of orders.
+ * Item popularity follows a Zipf distribution (skew 0 is uniform),
+ * and popularity ranks are shuffled over menu IDs so popular items
+ * are spread along the menu list. The same seed always produces
+ * the same menu, consumers and orders.
+ *
+ * Also provides the monotonic clock and the JSON result line used
+ * by every benchmark program.
+ */
+
+/** Upper bound on lines per generated order. */
+#define WORKLOAD_MAX_LINES 16
+
+/** Stock each generated menu item starts with. */
+#define WORKLOAD_STOCK 60000
+
+/**
+ * @struct WorkloadConfig
+ * @brief Shape of the generated workload.
+ */
+typedef struct {
+    unsigned long long seed;  /**< RNG seed */
+    int consumers;            /**< Number of consumers */
+    int menuItems;            /**< Number of menu items */
+    int maxItemsPerOrder;     /**< Lines per order are uniform in 1..this */
+    int maxQuantity;          /**< Quantity per line is uniform in 1..this */
+    double undoRate;          /**< Probability that an order is undone */
+    double skew;              /**< Zipf exponent of item popularity, 0 = uniform */
+    long orders;              /**< Orders (or iterations) per benchmark */
+    int queueDepth;           /**< Orders kept waiting in the queue */
+} WorkloadConfig;
+
+/**
+ * @struct WorkloadOrder
+ * @brief One generated order.
+ */
+typedef struct {
+    Consumer *consumer;                   /**< Consumer placing the order */
+    int lineCount;                        /**< Number of lines */
+    int menuIds[WORKLOAD_MAX_LINES];      /**< Menu item ID per line */
+    int quantities[WORKLOAD_MAX_LINES];   /**< Quantity per line */
+    int undo;                             /**< 1 if the order should be undone */
+} WorkloadOrder;
+
+/**
+ * @struct Workload
+ * @brief Generator state plus the menu and consumers it built.
+ */
+typedef struct {
+    WorkloadConfig config;    /**< Configuration */
+    uint64_t state;           /**< xorshift64* state */
+    Menu *menu;               /**< Menu list */
+    int *rankToId;            /**< Menu ID of each popularity rank */
+    double *rankCdf;          /**< Cumulative popularity by rank */
+    Consumer *consumers;      /**< Consumer list */
+    Consumer **consumerAt;    /**< Consumers by index */
+} Workload;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Returns the default configuration.
+ *
+ * @return 200 consumers, 50 items, up to 4 lines of up to 3 units,
+ *         5% undo, skew 1.0, 100000 orders, queue depth 64.
+ */
+WorkloadConfig defaultWorkloadConfig(void);
+
+/**
+ * @brief Applies one "--name=value" command-line option.
+ *
+ * Names: seed, consumers, menu, items, quantity, undo, skew,
+ * orders, depth.
+ *
+ * @param config Configuration to update.
+ * @param arg    Command-line argument.
+ *
+ * @return 0 if the option was recognised, -1 otherwise.
+ */
+int parseWorkloadOption(WorkloadConfig *config, const char *arg);
+
+/**
+ * @brief Builds the menu and consumers of a workload.
+ *
+ * @param config Configuration.
+ *
+ * @return Pointer to the new Workload, or NULL on failure.
+ */
+Workload* createWorkload(const WorkloadConfig *config);
+
+/**
+ * @brief Returns the next 32-bit pseudo-random number.
+ *
+ * @param workload Pointer to the workload.
+ *
+ * @return Random number.
+ */
+uint32_t workloadRandom(Workload *workload);
+
+/**
+ * @brief Draws a menu item ID according to the popularity skew.
+ *
+ * @param workload Pointer to the workload.
+ *
+ * @return Menu item ID.
+ */
+int randomMenuId(Workload *workload);
+
+/**
+ * @brief Draws a consumer uniformly.
+ *
+ * @param workload Pointer to the workload.
+ *
+ * @return Pointer to the consumer.
+ */
+Consumer* randomConsumer(Workload *workload);
+
+/**
+ * @brief Generates the next order.
+ *
+ * @param workload Pointer to the workload.
+ * @param order    Receives the order.
+ */
+void nextWorkloadOrder(Workload *workload, WorkloadOrder *order);
+
+/**
+ * @brief Frees the workload with its menu and consumers.
+ *
+ * @param workload Pointer to the workload.
+ */
+void freeWorkload(Workload *workload);
+
+/* ===============================
+   Timing and results
+   =============================== */
+
+/**
+ * @brief Returns a monotonic timestamp in nanoseconds.
+ *
+ * @return Nanoseconds since an arbitrary fixed point.
+ */
+uint64_t benchNanos(void);
+
+/**
+ * @brief Prints one result as a JSON line.
+ *
+ * Fields: bench, iterations, total_ns, ns_per_op, ops_per_sec and
+ * the workload configuration, so runs can be compared by tools.
+ *
+ * @param out        Destination.
+ * @param bench      Benchmark name.
+ * @param iterations Operations timed.
+ * @param elapsedNs  Total elapsed nanoseconds.
+ * @param config     Workload configuration.
+ */
+void printBenchResult(FILE *out, const char *bench, long iterations, uint64_t elapsedNs,
+                      const WorkloadConfig *config);
+
+/**
+ * @brief Sends stdout to the null device (the library prints bills etc.).
+ *
+ * @return Saved descriptor for unmuteStdout().
+ */
+int muteStdout(void);
+
+/**
+ * @brief Restores stdout after muteStdout().
+ *
+ * @param saved Descriptor returned by muteStdout().
+ */
+void unmuteStdout(int saved);
+
+#endif /* WORKLOAD_H */
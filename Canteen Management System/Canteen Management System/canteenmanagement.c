@@ -27,98 +27,236 @@
 #include "include/menuitem.h"
 #include "include/order.h"
 #include "include/undo.h"
+#include "include/menuindex.h"
+#include "include/menusnapshot.h"
+#include "include/userindex.h"
+#include "include/salesstats.h"
+#include "include/rushmetrics.h"
+#include "include/stockalert.h"
+#include "include/archive.h"
+#include "include/historyfile.h"
+#include "include/reportengine.h"
+#include "include/orderexport.h"
+#include "include/metrics.h"
+#include "include/memtrack.h"
+#include "include/ordertrace.h"
+#include "include/clocksource.h"
+#include "include/batch.h"
+#include "include/recorder.h"
+#include "include/scheduler.h"
+#include "include/combo.h"
+#include "include/waitestimate.h"
+#include "include/intake.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+/* Terminal ID of this admin console */
+#define ADMIN_TERMINAL 1
+#define KITCHEN_STATIONS 2                  /* orders prepared at once, for ready-in estimates */
+#define KITCHEN_UNIT_GUESS 60000000000ULL   /* 1 min per unit until the kitchen has been timed */
+
 /*
    Function Declarations
 */
 void adminMenu(User *, Menu **, Consumer **,
-               User **, OrderQueue *, OrderStack *);
+               User **, OrderQueue *, OrderStack *, MenuIndex *,
+               UserIndex *, SessionTable *, uint64_t, SalesStats *, RushMetrics *,
+               StockForecaster *, OrderArchive *, OrderScheduler *, ComboBook *, MenuStore *,
+               WaitEstimator *, IntakeControl *);
+void printRestockAlert(const RestockAlert *alert, void *context);
+void showMenu(MenuStore *menuStore);
 
-void placeOrder(Consumer **consumerHead, Menu *menuHead, OrderQueue *queue, OrderStack *stack);
+void placeOrder(Consumer **consumerHead, Menu *menuHead, MenuStore *menuStore, ComboBook *combos,
+                OrderQueue *queue, OrderStack *stack, WaitEstimator *eta, IntakeControl *intake);
 
 /*
    Main Function
+
+   CanteenApp.exe                    interactive admin console
+   CanteenApp.exe --batch <file|->   run commands from a file or stdin (see batch.h)
+   --record <file>                   also capture library operations for replay
+   --max-queue <n> / --max-wait <min> turn orders away while the kitchen is that busy
 */
-int main()
+int main(int argc, char *argv[])
 {
+    /* kill -USR1 <pid> dumps metrics to stderr */
+    if (metricsEnabled())
+        startMetricsSignalDump();
+
     /* Initialize lists */
     Menu *menuHead = NULL;
     Consumer *consumerHead = NULL;
     User *userHead = NULL;
     OrderQueue *orderQueue = createOrderQueue();
     OrderStack *undoStack = createOrderStack();
+    /* learns prep times from options 26 and 27, the kitchen of this process */
+    WaitEstimator *eta = createWaitEstimator(KITCHEN_STATIONS, KITCHEN_UNIT_GUESS);
 
     /* Create sample users */
-    addUser(&userHead, createUser("U001", "Admin", "admin", "admin123", ADMIN));
-    addUser(&userHead, createUser("U001", "Nibir", "nibir", "nibir123", ADMIN));
-    addUser(&userHead, createUser("U001", "Shimu", "simu", "simu123", ADMIN));
-    addUser(&userHead, createUser("U001", "Saif", "saif", "saif123", ADMIN));
-    addUser(&userHead, createUser("U001", "Tushi", "tushi", "tushi123", ADMIN));
+    UserIndex *userIndex = createUserIndex(userHead);
+    SessionTable *sessions = createSessionTable(15 * 60);
+    registerUser(&userHead, userIndex, createUser("U001", "Admin", "admin", "admin123", ADMIN));
+    registerUser(&userHead, userIndex, createUser("U002", "Nibir", "nibir", "nibir123", ADMIN));
+    registerUser(&userHead, userIndex, createUser("U003", "Shimu", "simu", "simu123", ADMIN));
+    registerUser(&userHead, userIndex, createUser("U004", "Saif", "saif", "saif123", ADMIN));
+    registerUser(&userHead, userIndex, createUser("U005", "Tushi", "tushi", "tushi123", ADMIN));
 
     /* Sample menu */
     addMenuItem(&menuHead, 1, "Tea", DRINK, 15.0, 50);
     addMenuItem(&menuHead, 2, "Coffee", DRINK, 25.0, 50);
     addMenuItem(&menuHead, 3, "Samosa", FOOD, 20.0, 30);
     addMenuItem(&menuHead, 4, "Sandwich", FOOD, 40.0, 20);
+    MenuIndex *menuIndex = createMenuIndex(menuHead);
+    MenuStore *menuStore = createMenuStore(&menuHead);
+    ComboBook *combos = createComboBook();
+    int teaSamosa[] = {1, 3}, coffeeSandwich[] = {2, 4}, oneEach[] = {1, 1};
+    defineCombo(combos, menuHead, 101, "Tea + Samosa", 30.0, teaSamosa, oneEach, 2);
+    defineCombo(combos, menuHead, 102, "Coffee + Sandwich", 55.0, coffeeSandwich, oneEach, 2);
+    SalesStats *salesStats = createSalesStats();
+    RushMetrics *rushMetrics = createRushMetrics();
+    OrderArchive *archive = createOrderArchive();
+    OrderScheduler *scheduler = createOrderScheduler(NULL);
 
-    char username[50], password[50];
-    User *currentUser = NULL;
-
-    printf("===== CANTEEN MANAGEMENT SYSTEM =====\n");
+    const char *batchPath = NULL, *recordPath = NULL;
+    IntakeLimits limits = { 0 };
+    int status = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--batch") == 0)
+            batchPath = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--record") == 0)
+            recordPath = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--max-queue") == 0)
+            limits.maxQueueDepth = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "--max-wait") == 0)
+            limits.maxWaitNanos = (uint64_t)(atof(argv[++i]) * 60e9);
+        else
+            status = 2;
+    }
+    /* the gate's counters drain through options 26, 27 and 19 (batch: start, ready, serve) */
+    IntakeControl *intake = createIntakeControl(orderQueue, &limits, eta);
+    if (recordPath && status == 0 && startRecording(recordPath, menuHead) != 0)
+        status = 1;
+    /* batch commands print nothing: alerts are queued and listed in the summary */
+    StockForecaster *forecaster = createStockForecaster(10.0, 30.0, 5, batchPath ? NULL : printRestockAlert, NULL);
 
-    /* Login Loop */
-    while (!currentUser)
+    if (status != 0)
+    {
+        if (status == 2)
+            fprintf(stderr, "Usage: %s [--batch <file|->] [--record <file>] [--max-queue <n>] [--max-wait <min>]\n",
+                    argv[0]);
+    }
+    else if (batchPath)
+    {
+        RequestTable *requests = createRequestTable(REQUEST_WINDOW_MINUTES * 60000000000ULL);
+        ReservationBook *reservations = createReservationBook(1000000000ULL);
+        BatchContext batch = {&menuHead, &consumerHead, orderQueue, undoStack, archive, userIndex, NULL, 1,
+                              requests, combos, reservations, intake};
+        BatchResult result;
+        status = runBatchFile(batchPath, &batch, &result) == 0 ? 0 : 1;
+        printBatchSummary(stdout, &result, forecaster);
+        freeReservationBook(reservations);      /* unclaimed holds give their stock back */
+        freeRequestTable(requests);
+    }
+    else
     {
-        printf("Enter username: ");
-        scanf("%s", username);
-        printf("Enter password: ");
-        scanf("%s", password);
+        char username[50], password[50];
+        User *currentUser = NULL;
 
-        currentUser = login(userHead, username, password);
-        if (!currentUser)
+        printf("===== CANTEEN MANAGEMENT SYSTEM =====\n");
+
+        /* Login Loop */
+        while (!currentUser)
         {
-            printf("Invalid username or password. Try again.\n");
+            printf("Enter username: ");
+            scanf("%s", username);
+            printf("Enter password: ");
+            scanf("%s", password);
+
+            currentUser = loginIndexed(userIndex, username, password);
+            if (!currentUser)
+            {
+                printf("Invalid username or password. Try again.\n");
+            }
         }
-    }
 
-    /* Show Role based menu */
-    switch (currentUser->role)
-    {
-    case ADMIN:
-        adminMenu(currentUser, &menuHead, &consumerHead, &userHead, orderQueue, undoStack);
-        break;
+        uint64_t token = openSession(sessions, currentUser, ADMIN_TERMINAL);
+
+        /* Show Role based menu */
+        switch (currentUser->role)
+        {
+        case ADMIN:
+            adminMenu(currentUser, &menuHead, &consumerHead, &userHead, orderQueue, undoStack, menuIndex,
+                      userIndex, sessions, token, salesStats, rushMetrics, forecaster, archive, scheduler, combos, menuStore,
+                      eta, intake);
+            break;
+
+        default:
+            printf("Unknown role.\n");
+        }
 
-    default:
-        printf("Unknown role.\n");
+        closeSession(sessions, token);
+    }
+    if (recordPath && status != 2)
+    {
+        long records = stopRecording();
+        if (records >= 0)
+            printf("%ld operations recorded to %s\n", records, recordPath);
     }
 
     /* Free all resources */
+    freeOrderScheduler(scheduler);
+    freeIntakeControl(intake);
+    freeWaitEstimator(eta);
+    freeSessionTable(sessions);
+    freeUserIndex(userIndex);
+    freeOrderArchive(archive);
+    freeStockForecaster(forecaster);
+    freeRushMetrics(rushMetrics);
+    freeSalesStats(salesStats);
+    freeMenuIndex(menuIndex);
+    freeMenuStore(menuStore);
+    freeComboBook(combos);
     freeMenu(menuHead);
     freeConsumers(consumerHead);
     freeUsers(userHead);
     freeOrderQueue(orderQueue);
     freeOrderStack(undoStack);
 
-    return 0;
+    /* whatever the tracker still holds now was leaked */
+    reportMemoryLeaks(stderr);
+    return status;
 }
 
 /*
    Admin Menu
 */
 void adminMenu(User *user, Menu **menuHead, Consumer **consumerHead,
-               User **userHead, OrderQueue *orderQueue, OrderStack *undoStack)
+               User **userHead, OrderQueue *orderQueue, OrderStack *undoStack,
+               MenuIndex *menuIndex, UserIndex *userIndex, SessionTable *sessions,
+               uint64_t token, SalesStats *salesStats, RushMetrics *rushMetrics,
+               StockForecaster *forecaster, OrderArchive *archive, OrderScheduler *scheduler,
+               ComboBook *combos, MenuStore *menuStore, WaitEstimator *eta, IntakeControl *intake)
 {
     int choice;
     char uid[50], name[50];
     do
     {
+        /* the token must still belong to the user who logged in */
+        if (validateSession(sessions, token, ADMIN_TERMINAL) != user)
+        {
+            printf("Session expired. Please log in again.\n");
+            return;
+        }
         printf("\n--- ADMIN MENU ---\n");
         printf("1. Add Menu Item\n2. Edit Menu Item\n3. Display Menu\n");
         printf("4. Add Consumer\n5. Edit Consumer\n6. Display Consumers\n");
         printf("7. Add User\n8. Edit User\n9. Display Users\n");
         printf("10. Place Order\n11. Undo Last Order\n12. Display Orders\n");
+        printf("13. Display Menu Sorted\n14. Low Stock Items\n15. Remove Menu Item\n");
+        printf("16. Sales Report\n17. Rush Metrics\n18. Stock Forecast\n");
+        printf("19. Serve Next Order\n20. Archived Orders\n21. Export Order History\n22. Revenue Report\n23. Export Orders (CSV/JSON)\n24. Metrics\n25. Memory Usage\n");
+        printf("26. Start Next Order\n27. Mark Order Ready\n28. Order Wait Times\n");
         printf("0. Logout\nChoose option: ");
         scanf("%d", &choice);
         getchar();
@@ -132,7 +270,13 @@ void adminMenu(User *user, Menu **menuHead, Consumer **consumerHead,
             int qty;
             int id;
             scanf("%d %s %d %f %d", &id, name, &typeInt, &price, &qty);
-            addMenuItem(menuHead, id, name, typeInt, price, qty);
+            /* combos share the menu ID space, and a menu item would hide one */
+            if (findMenuItem(*menuHead, id))
+                printf("Menu ID %d already exists.\n", id);
+            else if (findCombo(combos, id))
+                printf("Menu ID %d belongs to a combo.\n", id);
+            else
+                addMenuItem(menuHead, id, name, typeInt, price, qty);
             break;
         case 2:
             printf("Enter Menu ID to edit: ");
@@ -142,20 +286,27 @@ void adminMenu(User *user, Menu **menuHead, Consumer **consumerHead,
             editMenuItem(*menuHead, id, name, typeInt, price);
             break;
         case 3:
-            displayMenu(*menuHead);
+            showMenu(menuStore);
+            displayCombos(combos);
             break;
         case 4:
             printf("Enter UID, Name, Type(0-STUDENT,1-STAFF,2-FACULTY): ");
             int ctype;
             scanf("%s %s %d", uid, name, &ctype);
-            addConsumer(consumerHead, uid, name, ctype);
+            if (ctype < STUDENT || ctype > FACULTY)
+                printf("Invalid consumer type!\n");
+            else
+                addConsumer(consumerHead, uid, name, ctype);
             break;
         case 5:
             printf("Enter UID to edit: ");
             scanf("%s", uid);
             printf("Enter New Name, Type(0-STUDENT,1-STAFF,2-FACULTY): ");
             scanf("%s %d", name, &ctype);
-            editConsumer(*consumerHead, uid, name, ctype);
+            if (ctype < STUDENT || ctype > FACULTY)
+                printf("Invalid consumer type!\n");
+            else
+                editConsumer(*consumerHead, uid, name, ctype);
             break;
         case 6:
             displayConsumers(*consumerHead);
@@ -164,30 +315,141 @@ void adminMenu(User *user, Menu **menuHead, Consumer **consumerHead,
             printf("Enter UID, Name, Username, Password, Role(0-ADMIN,1-MANAGER,2-CASHIER): ");
             char username[50], password[50];
             scanf("%s %s %s %s %d", uid, name, username, password, &ctype);
-            addUser(userHead, createUser(uid, name, username, password, ctype));
+            if (registerUser(userHead, userIndex, createUser(uid, name, username, password, ctype)) != 0)
+                printf("User not added.\n");
             break;
         case 8:
             printf("Enter UID to edit: ");
             scanf("%s", uid);
             printf("Enter New Name, Username, Password, Role(0-ADMIN,1-MANAGER,2-CASHIER): ");
             scanf("%s %s %s %d", name, username, password, &ctype);
-            editUser(*userHead, uid, name, username, password, ctype);
+            if (editIndexedUser(userIndex, uid, name, username, password, ctype) == 0)
+                closeUserSessions(sessions, findUserByUid(userIndex, uid));
             break;
         case 9:
             displayUsers(*userHead);
             break;
         case 10:
-            placeOrder(consumerHead, *menuHead, orderQueue, undoStack);
+            placeOrder(consumerHead, *menuHead, menuStore, combos, orderQueue, undoStack, eta, intake);
             break;
         case 11:
-            if (undoLastOrder(undoStack, orderQueue))
-                printf("Last order undone successfully.\n");
-            else
-                printf("No order to undo.\n");
+            undoLastOrder(undoStack, orderQueue);
             break;
         case 12:
             displayOrders(orderQueue);
             break;
+        case 13:
+            printf("Sort by (0-PRICE,1-TYPE,2-STOCK): ");
+            int order;
+            scanf("%d", &order);
+            if (order < 0 || order >= MENU_ORDER_COUNT)
+                order = MENU_BY_PRICE;
+            displayMenuSorted(menuIndex, order);
+            break;
+        case 14:
+            printf("Show items with stock at or below: ");
+            scanf("%d", &qty);
+            displayMenuRange(menuIndex, MENU_BY_QUANTITY, 0, qty);
+            break;
+        case 15:
+            printf("Enter Menu ID to remove: ");
+            scanf("%d", &id);
+            if (removeMenuItem(menuHead, id) == 0)
+                printf("Menu item removed.\n");
+            break;
+        case 16:
+            displaySalesReport(salesStats, 5);
+            break;
+        case 17:
+            displayRushMetrics(rushMetrics, clockTime());
+            break;
+        case 18:
+            displayStockForecast(forecaster, *menuHead);
+            break;
+        case 19:
+            id = serveNextOrder(orderQueue, undoStack, archive);
+            if (id == -2)
+                printf("Order could not be archived; it stays in the queue.\n");
+            else if (id < 0)
+                printf("No order is ready for pickup.\n");
+            else
+                printf("Order ID %d served and archived.\n", id);
+            break;
+        case 20:
+            printf("Show archived orders from the last how many hours? ");
+            scanf("%d", &qty);
+            time_t now = clockTime();
+            displayArchiveRange(archive, now - (time_t)qty * 3600, now + 1);
+            break;
+        case 21:
+            if (exportHistoryFile(archive, "order_history.bin", 0, clockTime() + 1) != 0)
+                printf("Export failed.\n");
+            break;
+        case 22: {
+            printf("Group by (1=Item, 2=Consumer Type, 3=Day, 4=Hour): ");
+            scanf("%d", &qty);
+            if (qty < 1 || qty > 4) {
+                printf("Invalid grouping!\n");
+                break;
+            }
+            ReportFilter filter = reportFilterRange(0, clockTime() + 1);
+            Report *report = runReport(archive, &filter, (ReportGroup)(qty - 1), 0);
+            if (report) {
+                displayReport(report);
+                freeReport(report);
+            }
+            break;
+        }
+        case 23: {
+            int format;
+            printf("Format (1=CSV, 2=JSON Lines): ");
+            scanf("%d", &format);
+            printf("Orders from the last how many hours (0 = all)? ");
+            scanf("%d", &qty);
+            printf("Consumer UID (- for all): ");
+            scanf("%s", uid);
+            time_t now = clockTime();
+            ExportFilter filter = exportFilterRange(qty > 0 ? now - (time_t)qty * 3600 : 0, now + 1);
+            if (strcmp(uid, "-") != 0) filter.consumerUID = uid;
+            if (format == 2)
+                exportOrdersToFile(archive, orderQueue, "orders.jsonl", EXPORT_JSONL, &filter);
+            else
+                exportOrdersToFile(archive, orderQueue, "orders.csv", EXPORT_CSV, &filter);
+            break;
+        }
+        case 24:
+            dumpMetrics(stdout);
+            break;
+        case 25:
+            displayMemoryUsage(stdout);
+            break;
+        case 26:
+        {
+            /* faculty, staff, students, then bulk, with waiting orders aging up */
+            Order *started = startScheduledOrder(scheduler);
+            if (!started)
+                printf("No order waiting to be started.\n");
+            else
+                printf("Order ID %d is being prepared.\n", started->orderId);
+            break;
+        }
+        case 27:
+        {
+            Order *ready = finishNextOrder(orderQueue);
+            if (!ready)
+                printf("No order is being prepared.\n");
+            else
+                printf("Order ID %d is ready for pickup.\n", ready->orderId);
+            break;
+        }
+        case 28:
+        {
+            displayOrderWaitStats(stdout);
+            long records = dumpOrderTrace("order_trace.csv");
+            if (records >= 0)
+                printf("%ld stage changes written to order_trace.csv\n", records);
+            break;
+        }
         case 0:
             printf("Logging out...\n");
             break;
@@ -200,22 +462,22 @@ void adminMenu(User *user, Menu **menuHead, Consumer **consumerHead,
 /*
    Place Order Function
 */
-void placeOrder(Consumer **consumerHead, Menu *menuHead, OrderQueue *queue, OrderStack *stack)
+void placeOrder(Consumer **consumerHead, Menu *menuHead, MenuStore *menuStore, ComboBook *combos,
+                OrderQueue *queue, OrderStack *stack, WaitEstimator *eta, IntakeControl *intake)
 {
     char uid[50];
     displayConsumers(*consumerHead);
     printf("Enter Consumer UID: ");
     scanf("%s", uid);
-    Consumer *c = *consumerHead;
-    while (c && strcmp(c->uid, uid) != 0)
-        c = c->next;
+    Consumer *c = findConsumer(*consumerHead, uid);
     if (!c)
     {
         printf("Consumer not found!\n");
         return;
     }
 
-    displayMenu(menuHead);
+    showMenu(menuStore);
+    displayCombos(combos);
     int n, menuId, qty;
     printf("How many items? ");
     scanf("%d", &n);
@@ -224,9 +486,25 @@ void placeOrder(Consumer **consumerHead, Menu *menuHead, OrderQueue *queue, Orde
     float total = 0;
     for (int i = 0; i < n; i++)
     {
-        printf("Item %d - Enter Menu ID and Quantity: ", i + 1);
+        printf("Item %d - Enter Menu ID and Quantity (0 0 to cancel): ", i + 1);
         scanf("%d %d", &menuId, &qty);
+        if (menuId == 0)
+        {
+            discardOrderItems(head);
+            printf("Order cancelled.\n");
+            return;
+        }
         Menu *m = findMenuItem(menuHead, menuId);
+        Combo *combo = m ? NULL : findCombo(combos, menuId);
+        if (combo)
+        {
+            if (takeCombo(combo, qty, &head, &tail, &total) != 0)
+            {
+                printf("Combo not available!\n");
+                i--;
+            }
+            continue;
+        }
         if (!m)
         {
             printf("Invalid Menu ID!\n");
@@ -239,7 +517,7 @@ void placeOrder(Consumer **consumerHead, Menu *menuHead, OrderQueue *queue, Orde
             i--;
             continue;
         }
-        m->quantity -= qty;
+        adjustItemQuantity(m, -qty);
 
         OrderItem *item = createOrderItem(m, qty);
         if (!head)
@@ -252,16 +530,57 @@ void placeOrder(Consumer **consumerHead, Menu *menuHead, OrderQueue *queue, Orde
         total += m->price * qty;
     }
 
-    Order *order = (Order *)malloc(sizeof(Order));
-    order->orderId = rand() % 10000 + 1;
-    order->consumerName = strdup(c->name);
-    order->consumerUID = strdup(c->uid);
-    order->items = head;
-    order->totalAmount = total;
-    order->orderTime = time(NULL);
-    order->next = NULL;
+    if (!head)
+    {
+        printf("No items ordered.\n");
+        return;
+    }
 
-    enqueueOrder(queue, order->orderId, order->consumerName, order->consumerUID, head, total);
+    int orderId = clockRandom() % 10000 + 1;
+    IntakeResult result = INTAKE_ACCEPTED;
+    Order *order = intake ? submitOrder(intake, queue, orderId, c, head, total, &result)
+                          : enqueueConsumerOrder(queue, orderId, c, head, total);
+    if (!order)
+    {
+        printf("Order not accepted: %s.\n", intakeResultText(result));
+        if (isIntakeDeferral(result))
+            printf("Start, finish and serve queued orders (options 26, 27, 19), then try again.\n");
+        discardOrderItems(head);
+        return;
+    }
     pushOrder(stack, order);
     printf("Order placed successfully!\n");
+    if (eta)
+    {
+        uint64_t nanos = estimateOrderReadyIn(eta, order);
+        printf("Ready in about %llu min.\n", (unsigned long long)((nanos + 59999999999ULL) / 60000000000ULL));
+    }
+}
+
+/*
+   Menu display from the published snapshot, so edits cannot free what is printed
+*/
+void showMenu(MenuStore *menuStore)
+{
+    int reader = registerMenuReader(menuStore);
+    if (reader < 0)
+        return;
+    refreshMenu(menuStore);
+    displayMenuSnapshot(menuReadBegin(menuStore, reader));
+    menuReadEnd(menuStore, reader);
+    unregisterMenuReader(menuStore, reader);
+}
+
+/*
+   Restock alert callback
+*/
+void printRestockAlert(const RestockAlert *alert, void *context)
+{
+    (void)context;
+    if (alert->reason == RESTOCK_LOW_QUANTITY)
+        printf("** RESTOCK ALERT: %s (ID %d) is down to %d units **\n",
+               alert->name, alert->menuId, alert->quantity);
+    else
+        printf("** RESTOCK ALERT: %s (ID %d) runs out in ~%.0f min at %.1f units/min **\n",
+               alert->name, alert->menuId, alert->minutesToStockout, alert->unitsPerMinute);
 }
@@ -11,7 +11,9 @@
  * - View past orders
  *
  * This module works with shared data structures such as
- * Menu, Consumer, OrderQueue, and OrderStack.
+ * Menu, Consumer, OrderQueue, and OrderStack. The flow itself is the
+ * kiosk session state machine (kiosksession.h); this file feeds it
+ * lines from stdin, for one terminal or several multiplexed.
  */
 
 #include <stdio.h>
@@ -23,217 +25,201 @@
 #include "include/consumer.h"
 #include "include/order.h"
 #include "include/undo.h"
+#include "include/menuindex.h"
+#include "include/menusearch.h"
+#include "include/metrics.h"
+#include "include/memtrack.h"
+#include "include/recorder.h"
+#include "include/kiosksession.h"
+#include "include/combo.h"
+#include "include/reservation.h"
 
 /* ===============================
-   Helper Functions
+   Terminals
    =============================== */
 
-/* Find existing consumer by UID or create a new one */
-Consumer *getOrCreateConsumer(Consumer **head, const char *uid, const char *name)
+#define INPUT_LINE 512
+#define KITCHEN_STATIONS 2                  /* orders prepared at once, for ready-in estimates */
+#define KITCHEN_UNIT_GUESS 60000000000ULL   /* 1 min per unit until the kitchen has been timed */
+
+/* Output of a single-terminal session goes straight to stdout */
+static void writeStdout(void *context, const char *text, size_t length)
 {
-    Consumer *temp = *head;
-    while (temp)
-    {
-        if (strcmp(temp->uid, uid) == 0)
-        {
-            return temp; // Existing consumer
-        }
-        temp = temp->next;
-    }
-    // Create new consumer
-    Consumer *newConsumer = createConsumer(uid, name, STUDENT); // Default type STUDENT
-    addConsumer(head, newConsumer->uid, newConsumer->name, newConsumer->type);
-    printf("New consumer added: %s [%s]\n", name, uid);
-    return newConsumer;
+    (void)context;
+    fwrite(text, 1, length, stdout);
 }
 
-/* Place a new order */
-void placeOrder(Consumer *c, Menu *menuHead, OrderQueue *queue, OrderStack *stack, int *nextOrderId)
+/* With several kiosks every output line is tagged with its kiosk number */
+typedef struct
 {
-    int itemCount;
-    printf("\n--- Place Order for %s [%s] ---\n", c->name, c->uid);
-    displayMenu(menuHead);
-
-    printf("How many items to order? ");
-    scanf("%d", &itemCount);
-    if (itemCount <= 0)
-        return;
-
-    OrderItem *itemsHead = NULL;
-    OrderItem *itemsTail = NULL;
-    float total = 0;
-
-    for (int i = 0; i < itemCount; i++)
-    {
-        int menuId, qty;
-        printf("\nItem %d - Enter Menu ID: ", i + 1);
-        scanf("%d", &menuId);
-        printf("Quantity: ");
-        scanf("%d", &qty);
-
-        Menu *menuItem = findMenuItem(menuHead, menuId);
-        if (!menuItem)
-        {
-            printf("Invalid Menu ID!\n");
-            i--; // retry
-            continue;
-        }
-        if (menuItem->quantity < qty)
-        {
-            printf("Insufficient stock! Available: %d\n", menuItem->quantity);
-            i--; // retry
-            continue;
-        }
-
-        menuItem->quantity -= qty;
+    int number;
+    int atLineStart;
+} KioskTerminal;
 
-        OrderItem *newItem = createOrderItem(menuItem, qty);
-        if (!itemsHead)
-        {
-            itemsHead = itemsTail = newItem;
-        }
-        else
-        {
-            itemsTail->next = newItem;
-            itemsTail = newItem;
-        }
-        total += menuItem->price * qty;
-    }
-
-    if (!itemsHead)
+static void writeTagged(void *context, const char *text, size_t length)
+{
+    KioskTerminal *terminal = (KioskTerminal *)context;
+    for (size_t i = 0; i < length; i++)
     {
-        printf("No valid items ordered.\n");
-        return;
+        if (terminal->atLineStart)
+            printf("[%d] ", terminal->number);
+        putchar(text[i]);
+        terminal->atLineStart = text[i] == '\n';
     }
-
-    // Create order and enqueue
-    enqueueOrder(queue, (*nextOrderId)++, c->name, c->uid, itemsHead, total);
-    pushOrder(stack, queue->rear); // Push last order for undo
-    printf("Order placed successfully! Total: %.2f\n", total);
 }
 
-/* Undo last order for this consumer */
-void cancelLastOrder(Consumer *c, OrderStack *stack, OrderQueue *queue)
+/* One consumer at the terminal on stdin */
+void consumerInterface(KioskCanteen *canteen)
 {
-    if (!stack->top)
-    {
-        printf("No order to cancel.\n");
-        return;
-    }
+    KioskSession session;
+    char line[INPUT_LINE];
 
-    Order *lastOrder = stack->top->order;
-    if (strcmp(lastOrder->consumerUID, c->uid) != 0)
+    kioskStart(&session, canteen, writeStdout, NULL);
+    while (fgets(line, sizeof(line), stdin))
     {
-        printf("Last order does not belong to you. Cannot cancel.\n");
-        return;
+        if (!kioskInput(&session, line))
+            break;
     }
+    kioskEnd(&session);
+}
 
-    printf("\nCancelling Order ID: %d\n", lastOrder->orderId);
-    printf("Total Amount: %.2f\n", lastOrder->totalAmount);
+/*
+ * Serves several kiosks from one thread. Each input line is
+ * "<kiosk> <answer>"; when a consumer exits, the kiosk starts over
+ * for the next one.
+ */
+void multiplexKiosks(KioskCanteen *canteen, int kiosks)
+{
+    KioskSession *sessions = (KioskSession *)calloc(kiosks, sizeof(KioskSession));
+    KioskTerminal *terminals = (KioskTerminal *)calloc(kiosks, sizeof(KioskTerminal));
+    char line[INPUT_LINE];
 
-    int result = undoLastOrder(stack, queue);
-    if (result == 0)
+    if (!sessions || !terminals)
     {
-        printf("Order cancelled successfully! Amount refunded.\n");
+        fprintf(stderr, "Memory allocation failed\n");
+        free(sessions);
+        free(terminals);
+        return;
     }
-    else
+    for (int k = 0; k < kiosks; k++)
     {
-        printf("Failed to cancel order.\n");
+        terminals[k].number = k + 1;
+        terminals[k].atLineStart = 1;
+        kioskStart(&sessions[k], canteen, writeTagged, &terminals[k]);
+        printf("\n");
+        terminals[k].atLineStart = 1;
     }
-}
-/* View all past orders for this consumer */
-void viewConsumerOrders(Consumer *c, OrderQueue *queue)
-{
-    printf("\n--- Past Orders for %s [%s] ---\n", c->name, c->uid);
-    Order *temp = queue->front;
-    int found = 0;
-    while (temp)
+    while (fgets(line, sizeof(line), stdin))
     {
-        if (strcmp(temp->consumerUID, c->uid) == 0)
+        char *answer;
+        long k = strtol(line, &answer, 10);
+        if (answer == line || k < 1 || k > kiosks)
         {
-            found = 1;
-            printBill(temp);
+            fprintf(stderr, "Expected \"<kiosk 1-%d> <input>\"\n", kiosks);
+            continue;
+        }
+        KioskSession *session = &sessions[k - 1];
+        KioskTerminal *terminal = &terminals[k - 1];
+        if (!kioskInput(session, answer))
+            kioskStart(session, canteen, writeTagged, terminal);
+        if (!terminal->atLineStart)
+        {
+            printf("\n");      /* prompts end mid-line */
+            terminal->atLineStart = 1;
         }
-        temp = temp->next;
-    }
-    if (!found)
-    {
-        printf("No past orders.\n");
     }
+    for (int k = 0; k < kiosks; k++)
+        kioskEnd(&sessions[k]);
+    free(sessions);
+    free(terminals);
 }
 
 /* ===============================
-   Main Consumer Interface
-   =============================== */
-void consumerInterface(Consumer **consumerHead, Menu *menuHead,
-                       OrderQueue *queue, OrderStack *stack, int *nextOrderId)
-{
-    char name[50], uid[20];
-    printf("Enter your name: ");
-    scanf(" %[^\n]", name);
-    printf("Enter your UID: ");
-    scanf("%s", uid);
+   Standalone Main
 
-    Consumer *c = getOrCreateConsumer(consumerHead, uid, name);
+   Kiosk.exe [--record <file>] [--kiosks <n>]
+     --record captures the session for replay
+     --kiosks serves n terminals from stdin, lines "<kiosk> <input>"
 
-    int choice;
-    do
+   Intake limits belong to CanteenApp: nothing here starts or serves an
+   order, so a limit reached here would never clear.
+   =============================== */
+int main(int argc, char *argv[])
+{
+    const char *recordPath = NULL;
+    int kiosks = 0;
+    for (int i = 1; i < argc; i++)
     {
-        printf("\n--- Consumer Menu ---\n");
-        printf("1. View Menu\n");
-        printf("2. Place Order\n");
-        printf("3. Cancel Last Order\n");
-        printf("4. View My Orders\n");
-        printf("0. Exit\n");
-        printf("Enter choice: ");
-        scanf("%d", &choice);
-
-        switch (choice)
+        if (i + 1 < argc && strcmp(argv[i], "--record") == 0)
+            recordPath = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--kiosks") == 0)
+            kiosks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-queue") == 0 || strcmp(argv[i], "--max-wait") == 0)
         {
-        case 1:
-            displayMenu(menuHead);
-            break;
-        case 2:
-            placeOrder(c, menuHead, queue, stack, nextOrderId);
-            break;
-        case 3:
-            cancelLastOrder(c, stack, queue);
-            break;
-        case 4:
-            viewConsumerOrders(c, queue);
-            break;
-        case 0:
-            printf("Exiting Consumer Interface...\n");
-            break;
-        default:
-            printf("Invalid choice!\n");
+            fprintf(stderr, "%s: the kiosk never drains its queue; give %s to CanteenApp\n", argv[0], argv[i]);
+            return 2;
         }
-    } while (choice != 0);
-}
+        else
+            kiosks = -1;
+    }
+    if (kiosks < 0)
+    {
+        fprintf(stderr, "Usage: %s [--record <file>] [--kiosks <n>]\n", argv[0]);
+        return 2;
+    }
+
+    /* kill -USR1 <pid> dumps metrics to stderr */
+    if (metricsEnabled())
+        startMetricsSignalDump();
 
-/* ===============================
-   Standalone Main
-   =============================== */
-int main()
-{
     Consumer *consumerHead = NULL;
     Menu *menuHead = NULL;
     OrderQueue *queue = createOrderQueue();
     OrderStack *stack = createOrderStack();
-    int nextOrderId = 1;
 
     /* Sample Menu Items */
     addMenuItem(&menuHead, 1, "Burger", FOOD, 150.0, 10);
     addMenuItem(&menuHead, 2, "Coke", DRINK, 50.0, 20);
     addMenuItem(&menuHead, 3, "Cake", DESERT, 120.0, 5);
+    ComboBook *combos = createComboBook();
+    int burgerCoke[] = {1, 2}, oneEach[] = {1, 1};
+    defineCombo(combos, menuHead, 101, "Burger + Coke", 180.0, burgerCoke, oneEach, 2);
+    MenuIndex *menuIndex = createMenuIndex(menuHead);
+    MenuSearch *menuSearch = createMenuSearch(menuHead);
+    MenuStore *menuStore = createMenuStore(&menuHead);
+    if (recordPath && startRecording(recordPath, menuHead) != 0)
+        recordPath = NULL;
+
+    /*
+     * Nothing in this program starts or serves an order, so the estimator
+     * never learns and never drains: estimates stay at KITCHEN_UNIT_GUESS
+     * per unit and count every order placed here as still ahead.
+     */
+    WaitEstimator *eta = createWaitEstimator(KITCHEN_STATIONS, KITCHEN_UNIT_GUESS);
+    ReservationBook *reservations = createReservationBook(1000000000ULL);
+    KioskCanteen canteen = { &consumerHead, menuHead, menuIndex, menuSearch, queue, stack, 1, eta, NULL, combos,
+                             menuStore, reservations };
+    if (kiosks > 0)
+        multiplexKiosks(&canteen, kiosks);
+    else
+        consumerInterface(&canteen);
 
-    consumerInterface(&consumerHead, menuHead, queue, stack, &nextOrderId);
+    if (recordPath)
+        printf("%ld operations recorded to %s\n", stopRecording(), recordPath);
 
     /* Free memory */
+    freeReservationBook(reservations);      /* unclaimed pre-orders give their stock back */
+    freeWaitEstimator(eta);
     freeConsumers(consumerHead);
+    freeMenuSearch(menuSearch);
+    freeMenuIndex(menuIndex);
+    freeMenuStore(menuStore);
+    freeComboBook(combos);
     freeMenu(menuHead);
     freeOrderQueue(queue);
     freeOrderStack(stack);
 
+    /* whatever the tracker still holds now was leaked */
+    reportMemoryLeaks(stderr);
     return 0;
 }
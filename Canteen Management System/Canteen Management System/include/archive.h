@@ -0,0 +1,203 @@
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <stdint.h>
+#include <time.h>
+#include "order.h"
+#include "undo.h"
+
+/**
+ * @file archive.h
+ * @brief Time-partitioned columnar archive of completed orders.
+ *
+ * This header file defines the order history store. Served orders
+ * leave the live OrderQueue and are appended to one segment per day
+ * (UTC). A segment keeps each field in its own array: timestamps,
+ * order IDs, consumer handles, consumer types and totals for orders,
+ * plus menu IDs, quantities and unit prices for order lines. Rows
+ * are kept sorted by orderTime, so time-range queries use a binary
+ * search over segments and then over timestamps. Consumer UIDs are
+ * stored once in a dictionary and referenced by a small handle.
+ */
+
+/** Seconds in one archive partition. */
+#define ARCHIVE_DAY_SECONDS 86400
+
+/**
+ * @struct ArchiveSegment
+ * @brief Columns of all orders archived for one day.
+ *
+ * Lines of order i are lineStart[i] .. lineStart[i + 1] - 1.
+ */
+typedef struct {
+    long day;                 /**< Days since the epoch */
+    int count;                /**< Number of orders */
+    int capacity;             /**< Allocated order rows */
+    time_t *times;            /**< orderTime, non-decreasing */
+    uint16_t *orderIds;       /**< Order IDs */
+    int32_t *consumers;       /**< Handles into the consumer dictionary */
+    uint8_t *consumerTypes;   /**< ConsumerType per order */
+    float *totals;            /**< Order totals */
+    int32_t *lineStart;       /**< First line of each order (count + 1 entries) */
+    int lineCount;            /**< Number of lines */
+    int lineCapacity;         /**< Allocated line rows */
+    int32_t *menuIds;         /**< Menu item ID per line */
+    int32_t *quantities;      /**< Quantity per line */
+    float *unitPrices;        /**< Unit price per line */
+} ArchiveSegment;
+
+/**
+ * @struct OrderArchive
+ * @brief Day segments sorted by day plus the consumer dictionary.
+ */
+typedef struct {
+    ArchiveSegment **segments;   /**< Segments ordered by day */
+    int segmentCount;            /**< Number of segments */
+    int segmentCapacity;         /**< Allocated segment pointers */
+    char **consumerUids;         /**< Dictionary: handle -> UID */
+    char **consumerNames;        /**< Dictionary: handle -> name */
+    int consumerCount;           /**< Number of dictionary entries */
+    int consumerCapacity;        /**< Allocated dictionary entries */
+    int32_t *consumerSlots;      /**< Hash table: UID -> handle + 1, 0 if free */
+    int slotCapacity;            /**< Hash table size (power of two) */
+    long totalOrders;            /**< Orders across all segments */
+    long failedOrders;           /**< Serves refused because the order could not be archived */
+} OrderArchive;
+
+/**
+ * @struct ArchivedOrder
+ * @brief Read-only view of one archived order.
+ *
+ * Pointers refer into the archive and stay valid until the
+ * next change to it.
+ */
+typedef struct {
+    time_t orderTime;            /**< Order timestamp */
+    int orderId;                 /**< Order ID */
+    const char *consumerUID;     /**< Consumer UID */
+    const char *consumerName;    /**< Consumer name */
+    ConsumerType consumerType;   /**< Consumer type */
+    float totalAmount;           /**< Order total */
+    int lineCount;               /**< Number of lines */
+    const int32_t *menuIds;      /**< Menu item ID per line */
+    const int32_t *quantities;   /**< Quantity per line */
+    const float *unitPrices;     /**< Unit price per line */
+} ArchivedOrder;
+
+/**
+ * @struct ArchiveCursor
+ * @brief Position of a time-range walk over the archive.
+ */
+typedef struct {
+    const OrderArchive *archive; /**< Archive being walked */
+    int segment;                 /**< Current segment index */
+    int row;                     /**< Current row within the segment */
+    time_t to;                   /**< Exclusive upper time bound */
+} ArchiveCursor;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Creates an empty archive.
+ *
+ * @return Pointer to the new OrderArchive, or NULL on failure.
+ */
+OrderArchive* createOrderArchive(void);
+
+/**
+ * @brief Copies an order into the archive.
+ *
+ * The order itself is not modified or freed.
+ *
+ * @param archive Pointer to the archive.
+ * @param order   Order to copy.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+int archiveOrder(OrderArchive *archive, const Order *order);
+
+/**
+ * @brief Serves the order that has been ready for pickup the longest.
+ *
+ * Dequeues it, drops it from the undo stack, copies it into the
+ * archive and frees it, so the live queue only holds pending orders.
+ * Orders the kitchen has not marked ready (see finishNextOrder())
+ * are never served, wherever they are in the queue.
+ *
+ * @param queue   Pointer to the order queue.
+ * @param stack   Pointer to the undo stack (may be NULL).
+ * @param archive Pointer to the archive.
+ *
+ * @return ID of the served order, -1 if no order is ready, or -2 if
+ *         the order could not be archived (it then stays queued).
+ */
+int serveNextOrder(OrderQueue *queue, OrderStack *stack, OrderArchive *archive);
+
+/**
+ * @brief Serves a given order, wherever it is in the queue.
+ *
+ * Same as serveNextOrder() for a caller that picks the order itself.
+ * Marks it collected, and started/ready as well if the kitchen never
+ * marked those stages.
+ *
+ * @param queue   Pointer to the order queue.
+ * @param stack   Pointer to the undo stack (may be NULL).
+ * @param archive Pointer to the archive.
+ * @param order   Order in the queue.
+ *
+ * @return ID of the served order, -1 if it is not in the queue, or -2
+ *         if it could not be archived (it then stays queued).
+ */
+int serveOrder(OrderQueue *queue, OrderStack *stack, OrderArchive *archive, Order *order);
+
+/**
+ * @brief Starts a walk over orders with from <= orderTime < to.
+ *
+ * @param archive Pointer to the archive.
+ * @param from    Inclusive lower bound.
+ * @param to      Exclusive upper bound.
+ * @param cursor  Cursor to initialise.
+ */
+void archiveSeek(const OrderArchive *archive, time_t from, time_t to, ArchiveCursor *cursor);
+
+/**
+ * @brief Returns the next order of a range walk.
+ *
+ * @param cursor Cursor from archiveSeek().
+ * @param out    Receives the order view.
+ *
+ * @return 1 if an order was returned, 0 at the end of the range.
+ */
+int archiveNext(ArchiveCursor *cursor, ArchivedOrder *out);
+
+/**
+ * @brief Counts orders and revenue in a time range.
+ *
+ * @param archive Pointer to the archive.
+ * @param from    Inclusive lower bound.
+ * @param to      Exclusive upper bound.
+ * @param revenue Receives the revenue (may be NULL).
+ *
+ * @return Number of orders in the range.
+ */
+long archiveRangeTotals(const OrderArchive *archive, time_t from, time_t to, double *revenue);
+
+/**
+ * @brief Prints the orders of a time range.
+ *
+ * @param archive Pointer to the archive.
+ * @param from    Inclusive lower bound.
+ * @param to      Exclusive upper bound.
+ */
+void displayArchiveRange(const OrderArchive *archive, time_t from, time_t to);
+
+/**
+ * @brief Frees the archive and all its segments.
+ *
+ * @param archive Pointer to the archive.
+ */
+void freeOrderArchive(OrderArchive *archive);
+
+#endif /* ARCHIVE_H */
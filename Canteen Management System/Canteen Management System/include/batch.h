@@ -0,0 +1,135 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "menuitem.h"
+#include "consumer.h"
+#include "order.h"
+#include "undo.h"
+#include "archive.h"
+#include "userindex.h"
+#include "idempotency.h"
+#include "combo.h"
+#include "stockalert.h"
+#include "reservation.h"
+#include "intake.h"
+
+/**
+ * @file batch.h
+ * @brief Non-interactive command processor.
+ *
+ * This header file defines batch mode: a stream of one-line commands
+ * run against the library without prompts. Successful commands print
+ * nothing; a failed command writes one line with its line number to
+ * the error stream and the batch carries on.
+ *
+ * Commands (names may contain spaces, types are numbers or names):
+ * @code
+ * login <username> <password>               must come first
+ * menu add <id> <type> <price> <qty> <name>
+ * menu edit <id> <type> <price> <name>
+ * menu restock <id> <change>                 change may be negative
+ * menu remove <id>
+ * consumer add <uid> <type> <name>
+ * consumer edit <uid> <type> <name>
+ * order <uid> [key=<key>] <menuId>:<qty> [<menuId>:<qty> ...]
+ * reserve <uid> <minutes> <menuId>:<qty> [<menuId>:<qty> ...]
+ * claim <reservationId>
+ * undo
+ * start                                      oldest order not yet started
+ * ready                                      oldest order being prepared
+ * serve                                      order ready for the longest
+ * # comment
+ * @endcode
+ *
+ * An order line may name a combo instead of a menu item. Combos share
+ * the menu ID space, so menu add refuses an ID a combo already uses.
+ * An order is all or nothing: if any line fails, no stock is taken.
+ * An order whose key placed an order in the last REQUEST_WINDOW_MINUTES
+ * is a no-op, so a client streaming commands to stdin can resend an
+ * order it got no answer for without placing it twice. An order the
+ * intake gate refuses fails with the reason and takes no stock.
+ *
+ * reserve holds the stock of a pre-order for the given minutes;
+ * claim turns the hold into a queued order. Reservations are numbered
+ * from 1 in the order they are made. Holds past their deadline are
+ * released before each command.
+ */
+
+/** How long batch mode remembers order keys. */
+#define REQUEST_WINDOW_MINUTES 15
+
+/** Longest command line accepted. */
+#define BATCH_MAX_LINE 4096
+
+/**
+ * @struct BatchContext
+ * @brief State the commands operate on.
+ */
+typedef struct {
+    Menu **menuHead;          /**< Menu list */
+    Consumer **consumerHead;  /**< Consumer list */
+    OrderQueue *queue;        /**< Live order queue */
+    OrderStack *stack;        /**< Undo stack */
+    OrderArchive *archive;    /**< Archive for served orders */
+    UserIndex *userIndex;     /**< Users allowed to run batches */
+    User *user;               /**< Logged-in user, NULL until login */
+    int nextOrderId;          /**< ID given to the next order */
+    RequestTable *requests;   /**< Idempotency keys, NULL to ignore key= */
+    ComboBook *combos;        /**< Combos order lines may name, or NULL */
+    ReservationBook *reservations; /**< Pre-order holds, NULL to refuse reserve and claim */
+    IntakeControl *intake;    /**< Admission gate for orders, NULL to accept every order */
+} BatchContext;
+
+/**
+ * @struct BatchResult
+ * @brief Outcome of a batch run.
+ */
+typedef struct {
+    long lines;               /**< Lines read */
+    long commands;            /**< Commands executed (comments and blanks excluded) */
+    long errors;              /**< Commands that failed */
+    uint64_t elapsedNanos;    /**< Wall time of the run */
+} BatchResult;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Runs every command of a stream.
+ *
+ * @param in      Command stream (buffered with a large buffer).
+ * @param context State to operate on.
+ * @param errors  Where failed commands are reported.
+ * @param result  Receives the counts and run time.
+ *
+ * @return 0 if every command succeeded, -1 otherwise.
+ */
+int runBatch(FILE *in, BatchContext *context, FILE *errors, BatchResult *result);
+
+/**
+ * @brief Runs a command file.
+ *
+ * @param path    File to read, or "-" for stdin.
+ * @param context State to operate on.
+ * @param result  Receives the counts and run time.
+ *
+ * @return 0 if every command succeeded, -1 otherwise.
+ */
+int runBatchFile(const char *path, BatchContext *context, BatchResult *result);
+
+/**
+ * @brief Prints the summary line of a batch run.
+ *
+ * Restock alerts raised during the run are listed after it, once,
+ * so commands themselves stay silent.
+ *
+ * @param out        Destination.
+ * @param result     Result of runBatch().
+ * @param forecaster Forecaster queueing alerts (no callback), or NULL.
+ */
+void printBatchSummary(FILE *out, const BatchResult *result, StockForecaster *forecaster);
+
+#endif /* BATCH_H */
@@ -0,0 +1,102 @@
+#ifndef CLOCKSOURCE_H
+#define CLOCKSOURCE_H
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @file clocksource.h
+ * @brief Injectable clock and randomness.
+ *
+ * This header file defines where the library takes the time and its
+ * random numbers from. By default that is the system (time(), the
+ * monotonic clock and rand()). A simulation installs a VirtualClock
+ * instead: time only moves when the driver advances it and random
+ * numbers come from a seeded generator, so a run can be repeated
+ * bit for bit.
+ *
+ * Order timestamps, lifecycle stages and demand forecasts follow the
+ * installed source. Metric latencies and session expiry always use
+ * the real clock, since they measure the host and guard logins.
+ */
+
+/**
+ * @struct ClockSource
+ * @brief Callbacks that supply time and randomness.
+ */
+typedef struct {
+    time_t (*wallTime)(void *context);        /**< Calendar time in seconds */
+    uint64_t (*monotonicNanos)(void *context); /**< Monotonic time in nanoseconds */
+    uint32_t (*random)(void *context);        /**< Next random number */
+    void *context;                            /**< Passed to every callback */
+} ClockSource;
+
+/**
+ * @struct VirtualClock
+ * @brief Clock that only moves when advanced, with a seeded generator.
+ */
+typedef struct {
+    time_t epoch;             /**< Calendar time at nanos == 0 */
+    uint64_t nanos;           /**< Virtual nanoseconds since the epoch */
+    uint64_t state;           /**< xorshift64* state */
+} VirtualClock;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Installs a clock source.
+ *
+ * Not synchronised: call it while no other thread uses the library.
+ *
+ * @param source Source to copy, or NULL to return to the system clock.
+ */
+void setClockSource(const ClockSource *source);
+
+/**
+ * @brief Returns the calendar time of the installed source.
+ *
+ * @return Seconds since the epoch.
+ */
+time_t clockTime(void);
+
+/**
+ * @brief Returns the monotonic time of the installed source.
+ *
+ * @return Nanoseconds since an arbitrary fixed point (never 0).
+ */
+uint64_t clockNanos(void);
+
+/**
+ * @brief Returns a random number from the installed source.
+ *
+ * @return Random number in 0 .. 2^31 - 1.
+ */
+uint32_t clockRandom(void);
+
+/**
+ * @brief Initialises a virtual clock.
+ *
+ * @param clock Clock to initialise.
+ * @param epoch Calendar time the clock starts at.
+ * @param seed  Seed of the generator (0 is replaced by 1).
+ */
+void initVirtualClock(VirtualClock *clock, time_t epoch, uint64_t seed);
+
+/**
+ * @brief Installs a virtual clock as the clock source.
+ *
+ * @param clock Clock to use; must outlive its use.
+ */
+void useVirtualClock(VirtualClock *clock);
+
+/**
+ * @brief Moves a virtual clock forward.
+ *
+ * @param clock Clock to advance.
+ * @param nanos Nanoseconds to add.
+ */
+void advanceVirtualClock(VirtualClock *clock, uint64_t nanos);
+
+#endif /* CLOCKSOURCE_H */
@@ -0,0 +1,147 @@
+#ifndef COMBO_H
+#define COMBO_H
+
+#include "menuitem.h"
+#include "order.h"
+
+/**
+ * @file combo.h
+ * @brief Combo meals made of existing menu items.
+ *
+ * This header file defines combos such as "Tea + Samosa". A combo is
+ * resolved once when it is defined: its components point straight at
+ * their Menu items, and its price is split over the components up
+ * front, so ordering a combo needs no findMenuItem() calls and no
+ * pricing work. The split is redone only when a component is edited.
+ *
+ * Ordering a combo checks every component first and only then takes
+ * the stock, so it either takes all of it or none. The order gets one
+ * line per component, priced at its share of the combo price, so
+ * reports by item keep adding up.
+ *
+ * Combo IDs share the menu ID space. A combo is withdrawn when one of
+ * its components is removed from the menu. The book follows the menu
+ * through menu observers; only one book should exist at a time.
+ */
+
+/** Most distinct menu items in one combo. */
+#define MAX_COMBO_PARTS 8
+
+/**
+ * @struct ComboPart
+ * @brief One component of a combo.
+ */
+typedef struct {
+    Menu *item;               /**< Menu item (referenced, see retainMenuItem()) */
+    int quantity;             /**< Units per combo */
+    float unitPrice;          /**< Share of the combo price per unit */
+} ComboPart;
+
+/**
+ * @struct Combo
+ * @brief A combo meal.
+ */
+typedef struct Combo {
+    int id;                   /**< Combo ID (not used by any menu item) */
+    char *name;               /**< Name shown on the menu */
+    float price;              /**< Combo price */
+    float listPrice;          /**< Price of the components bought separately */
+    int withdrawn;            /**< 1 once a component left the menu */
+    int partCount;            /**< Number of components */
+    ComboPart parts[MAX_COMBO_PARTS]; /**< Components, one per menu item */
+    struct Combo *next;       /**< Next combo */
+} Combo;
+
+/**
+ * @struct ComboBook
+ * @brief All combos, in definition order.
+ */
+typedef struct {
+    Combo *head;              /**< First combo */
+    Combo *tail;              /**< Last combo */
+    int count;                /**< Number of combos */
+} ComboBook;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Creates an empty combo book and starts following the menu.
+ *
+ * @return Pointer to the new ComboBook, or NULL on failure.
+ */
+ComboBook* createComboBook(void);
+
+/**
+ * @brief Defines a combo.
+ *
+ * Components naming the same item are merged.
+ *
+ * @param book       Pointer to the combo book.
+ * @param menuHead   Menu the components are looked up in.
+ * @param id         Combo ID, unused by menu items and other combos.
+ *                   Callers adding menu items must keep clear of it
+ *                   (see findCombo()), since a menu item of the same
+ *                   ID would hide the combo from order lines.
+ * @param name       Combo name.
+ * @param price      Combo price, or 0 for the price of the components.
+ * @param menuIds    Menu IDs of the components.
+ * @param quantities Units of each component.
+ * @param count      Number of components.
+ *
+ * @return The new Combo, or NULL if the ID is taken, a component is
+ *         unknown or there are too many components.
+ */
+Combo* defineCombo(ComboBook *book, Menu *menuHead, int id, const char *name, float price,
+                   const int *menuIds, const int *quantities, int count);
+
+/**
+ * @brief Finds a combo by ID.
+ *
+ * @param book Pointer to the combo book.
+ * @param id   Combo ID.
+ *
+ * @return The combo, or NULL if not found.
+ */
+Combo* findCombo(const ComboBook *book, int id);
+
+/**
+ * @brief Returns how many servings of a combo the stock allows.
+ *
+ * @param combo Pointer to the combo.
+ *
+ * @return Servings the scarcest component allows, 0 if withdrawn.
+ */
+int comboAvailability(const Combo *combo);
+
+/**
+ * @brief Takes the stock for some servings of a combo and adds the lines to a basket.
+ *
+ * All or nothing: if any component is short, no stock is taken.
+ *
+ * @param combo    Pointer to the combo.
+ * @param servings Number of combos ordered.
+ * @param head     Head of the basket's line list.
+ * @param tail     Tail of the basket's line list.
+ * @param total    Basket total, increased by the combo price.
+ *
+ * @return 0 on success, -1 if the combo is withdrawn, out of stock or a line could not be allocated.
+ */
+int takeCombo(const Combo *combo, int servings, OrderItem **head, OrderItem **tail, float *total);
+
+/**
+ * @brief Displays all combos with their current availability.
+ *
+ * @param book Pointer to the combo book.
+ */
+void displayCombos(const ComboBook *book);
+
+/**
+ * @brief Stops following the menu and frees the book.
+ *
+ * @param book Pointer to the combo book.
+ */
+void freeComboBook(ComboBook *book);
+
+#endif /* COMBO_H */
@@ -64,6 +64,16 @@ Consumer* createConsumer(const char *uid, const char *name, ConsumerType type);
  */
 void addConsumer(Consumer **head, const char *uid, const char *name, ConsumerType type);
 
+/**
+ * @brief Finds a consumer by UID.
+ *
+ * @param head Pointer to the head of the consumer list.
+ * @param uid  Unique identifier to search for.
+ *
+ * @return Pointer to the consumer, or NULL if not found.
+ */
+Consumer* findConsumer(Consumer *head, const char *uid);
+
 /**
  * @brief Displays all consumers in the list.
  *
@@ -0,0 +1,199 @@
+#ifndef HISTORYFILE_H
+#define HISTORYFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "archive.h"
+
+/**
+ * @file historyfile.h
+ * @brief Compressed on-disk encoding of archived orders.
+ *
+ * This header file defines a block-based binary format for order
+ * history. Inside a block, timestamps and order IDs are delta
+ * encoded, every number is a LEB128 varint (zig-zag for signed
+ * deltas), amounts are stored in cents, and consumer UIDs and
+ * (menu ID, price) pairs are dictionary coded: the first use
+ * writes the value, later uses write a small reference. Each
+ * block carries its record count and a CRC-32 of its payload and
+ * starts with empty dictionaries, so a reader only ever holds one
+ * block in memory.
+ *
+ * Layout: "CMSH" + version byte, then blocks of
+ * [u32 payload length][u32 record count][u32 crc32][payload].
+ */
+
+/** Payload size at which the writer closes a block. */
+#define HISTORY_BLOCK_SIZE (64 * 1024)
+
+/**
+ * @struct HistoryStats
+ * @brief Size and record counters of a history file.
+ */
+typedef struct {
+    long records;             /**< Orders written or read */
+    long lines;               /**< Order lines written or read */
+    long blocks;              /**< Blocks written or read */
+    long rawBytes;            /**< Size of the same data as fixed-width columns */
+    long encodedBytes;        /**< Bytes in the file */
+} HistoryStats;
+
+/**
+ * @struct HistoryDictEntry
+ * @brief Consumer dictionary entry of the current block.
+ */
+typedef struct {
+    char *uid;                /**< Consumer UID */
+    char *name;               /**< Consumer name */
+    ConsumerType type;        /**< Consumer type */
+} HistoryDictEntry;
+
+/**
+ * @struct HistoryItemEntry
+ * @brief (menu ID, unit price) dictionary entry of the current block.
+ */
+typedef struct {
+    int32_t menuId;           /**< Menu item ID */
+    int32_t priceCents;       /**< Unit price in cents */
+} HistoryItemEntry;
+
+/**
+ * @struct HistoryCodec
+ * @brief Per-block state shared by the writer and the reader.
+ */
+typedef struct {
+    uint8_t *buffer;              /**< Block payload */
+    size_t length;                /**< Bytes used in buffer */
+    size_t capacity;              /**< Allocated bytes in buffer */
+    size_t position;              /**< Read position (reader only) */
+    long blockRecords;            /**< Records in the current block */
+    int64_t lastTime;             /**< Previous timestamp in the block */
+    int64_t lastOrderId;          /**< Previous order ID in the block */
+    HistoryDictEntry *consumers;  /**< Consumer dictionary */
+    int consumerCount;            /**< Entries in the consumer dictionary */
+    int consumerCapacity;         /**< Allocated consumer entries */
+    HistoryItemEntry *items;      /**< Item dictionary */
+    int itemCount;                /**< Entries in the item dictionary */
+    int itemCapacity;             /**< Allocated item entries */
+    int32_t *consumerSlots;       /**< Writer hash: UID -> entry + 1 */
+    int32_t *itemSlots;           /**< Writer hash: (ID, price) -> entry + 1 */
+    int slotCapacity;             /**< Size of both hash tables (power of two) */
+} HistoryCodec;
+
+/**
+ * @struct HistoryWriter
+ * @brief Streaming encoder writing to a file.
+ */
+typedef struct {
+    FILE *file;               /**< Output file */
+    HistoryCodec codec;       /**< Current block */
+    HistoryStats stats;       /**< Running counters */
+} HistoryWriter;
+
+/**
+ * @struct HistoryReader
+ * @brief Streaming decoder reading one block at a time.
+ */
+typedef struct {
+    FILE *file;               /**< Input file */
+    HistoryCodec codec;       /**< Current block */
+    HistoryStats stats;       /**< Running counters */
+    int32_t *menuIds;         /**< Line buffer for the current record */
+    int32_t *quantities;      /**< Line buffer for the current record */
+    float *unitPrices;        /**< Line buffer for the current record */
+    int lineCapacity;         /**< Allocated lines in the buffers */
+} HistoryReader;
+
+/* ===============================
+   Writer
+   =============================== */
+
+/**
+ * @brief Creates a history file and writes its header.
+ *
+ * @param path File to create.
+ *
+ * @return Pointer to the writer, or NULL on failure.
+ */
+HistoryWriter* openHistoryWriter(const char *path);
+
+/**
+ * @brief Appends one order.
+ *
+ * @param writer Pointer to the writer.
+ * @param order  Order to encode.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int writeHistoryOrder(HistoryWriter *writer, const ArchivedOrder *order);
+
+/**
+ * @brief Appends every archived order with from <= orderTime < to.
+ *
+ * @param writer  Pointer to the writer.
+ * @param archive Pointer to the archive.
+ * @param from    Inclusive lower bound.
+ * @param to      Exclusive upper bound.
+ *
+ * @return Number of orders written, or -1 on failure.
+ */
+long writeHistoryRange(HistoryWriter *writer, const OrderArchive *archive, time_t from, time_t to);
+
+/**
+ * @brief Flushes the last block, closes the file and frees the writer.
+ *
+ * @param writer Pointer to the writer.
+ * @param stats  Receives the final counters (may be NULL).
+ *
+ * @return 0 on success, -1 on a write error.
+ */
+int closeHistoryWriter(HistoryWriter *writer, HistoryStats *stats);
+
+/* ===============================
+   Reader
+   =============================== */
+
+/**
+ * @brief Opens a history file and checks its header.
+ *
+ * @param path File to read.
+ *
+ * @return Pointer to the reader, or NULL on failure.
+ */
+HistoryReader* openHistoryReader(const char *path);
+
+/**
+ * @brief Decodes the next order.
+ *
+ * Pointers in the result stay valid until the next call.
+ *
+ * @param reader Pointer to the reader.
+ * @param out    Receives the order.
+ *
+ * @return 1 if an order was read, 0 at end of file, -1 on a corrupt block.
+ */
+int readHistoryOrder(HistoryReader *reader, ArchivedOrder *out);
+
+/**
+ * @brief Closes the file and frees the reader.
+ *
+ * @param reader Pointer to the reader.
+ * @param stats  Receives the counters (may be NULL).
+ */
+void closeHistoryReader(HistoryReader *reader, HistoryStats *stats);
+
+/**
+ * @brief Writes a time range of the archive to a file and reads it back.
+ *
+ * Prints the compression ratio and the decode throughput.
+ *
+ * @param archive Pointer to the archive.
+ * @param path    File to create.
+ * @param from    Inclusive lower bound.
+ * @param to      Exclusive upper bound.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int exportHistoryFile(const OrderArchive *archive, const char *path, time_t from, time_t to);
+
+#endif /* HISTORYFILE_H */
@@ -0,0 +1,100 @@
+#ifndef IDEMPOTENCY_H
+#define IDEMPOTENCY_H
+
+#include <stdint.h>
+#include "order.h"
+
+/**
+ * @file idempotency.h
+ * @brief Duplicate detection for order submissions.
+ *
+ * This header file defines the request table that remembers which
+ * client-supplied idempotency keys have already placed an order. A
+ * client sends the same key with every retry of one submission; the
+ * first one places the order, later ones find it here and get the
+ * original order back instead of paying and taking stock twice.
+ *
+ * Keys are kept for a fixed window after they are first seen. Entries
+ * are chained in a hash table and also linked oldest-first, so expired
+ * ones are dropped from the front as new lookups come in: lookups cost
+ * O(1) and memory is bounded by the keys seen in one window.
+ *
+ * The table follows the queue through order observers and forgets an
+ * entry's Order once it is served or undone; the entry still blocks
+ * duplicates until it expires. Only one table should exist at a time.
+ */
+
+/** Longest idempotency key (including the terminator). */
+#define REQUEST_KEY_LENGTH 40
+
+/**
+ * @struct RequestEntry
+ * @brief One remembered submission.
+ */
+typedef struct RequestEntry {
+    char key[REQUEST_KEY_LENGTH];     /**< Idempotency key */
+    uint32_t hash;                    /**< Hash of the key */
+    uint16_t orderId;                 /**< ID of the order it placed */
+    Order *order;                     /**< That order, NULL once it left the queue */
+    uint64_t expiresNanos;            /**< When the key is forgotten */
+    struct RequestEntry *chainNext;   /**< Next entry in the same bucket */
+    struct RequestEntry *ageNext;     /**< Next newer entry */
+} RequestEntry;
+
+/**
+ * @struct RequestTable
+ * @brief Hash table of recent idempotency keys.
+ */
+typedef struct {
+    uint64_t windowNanos;             /**< How long keys are remembered */
+    RequestEntry **buckets;           /**< Chains by key hash */
+    int bucketCount;                  /**< Number of buckets (a power of two) */
+    int count;                        /**< Keys remembered */
+    RequestEntry *oldest;             /**< Next entry to expire */
+    RequestEntry *newest;             /**< Entry added last */
+} RequestTable;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Creates a request table and starts following the order queue.
+ *
+ * @param windowNanos How long a key is remembered after it is first seen.
+ *
+ * @return Pointer to the new RequestTable, or NULL on failure.
+ */
+RequestTable* createRequestTable(uint64_t windowNanos);
+
+/**
+ * @brief Checks whether a key has already placed an order.
+ *
+ * Drops expired keys first.
+ *
+ * @param table Pointer to the request table.
+ * @param key   Idempotency key.
+ *
+ * @return The entry for the key, or NULL if the key is new.
+ */
+const RequestEntry* findRequest(RequestTable *table, const char *key);
+
+/**
+ * @brief Remembers that a key placed an order.
+ *
+ * @param table Pointer to the request table.
+ * @param key   Idempotency key not in the table.
+ * @param order The order it placed.
+ *
+ * @return 0 on success, -1 if the key is empty, too long or out of memory.
+ */
+int rememberRequest(RequestTable *table, const char *key, Order *order);
+
+/**
+ * @brief Stops following the queue and frees the table.
+ *
+ * @param table Pointer to the request table.
+ */
+void freeRequestTable(RequestTable *table);
+
+#endif /* IDEMPOTENCY_H */
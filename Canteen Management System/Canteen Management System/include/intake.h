@@ -0,0 +1,141 @@
+#ifndef INTAKE_H
+#define INTAKE_H
+
+#include <stdint.h>
+#include "order.h"
+#include "waitestimate.h"
+
+/**
+ * @file intake.h
+ * @brief Admission control for new orders.
+ *
+ * This header file defines the intake gate that orders pass before they
+ * are queued. It refuses an order when the kitchen is over one of its
+ * limits:
+ *  - queue depth: orders in the queue,
+ *  - station load: units not yet prepared per item type (each type
+ *    stands for one kitchen station: grill, drinks, desserts),
+ *  - predicted wait: the ready-in estimate of the basket.
+ *
+ * Every refusal carries a reason. A basket that could never fit (more
+ * units than a station's limit, or more work than the wait limit on its
+ * own) is rejected; any other refusal is a deferral, and the same
+ * basket will be admitted once the kitchen catches up.
+ *
+ * The checks use counters kept up to date through order observers, so
+ * the cost of an intake decision depends only on the basket, never on
+ * the queue. Only one intake gate should exist at a time.
+ */
+
+/** Number of kitchen stations: one per ItemType. */
+#define INTAKE_STATIONS (DESERT + 1)
+
+/**
+ * @enum IntakeResult
+ * @brief Outcome of an intake check.
+ */
+typedef enum {
+    INTAKE_ACCEPTED,          /**< Order may be queued */
+    INTAKE_QUEUE_FULL,        /**< Deferred: too many orders queued */
+    INTAKE_STATION_FULL,      /**< Deferred: a station has too many units outstanding */
+    INTAKE_WAIT_TOO_LONG,     /**< Deferred: predicted wait is over the limit */
+    INTAKE_TOO_LARGE,         /**< Rejected: the basket alone is over a limit */
+    INTAKE_RESULT_COUNT       /**< Number of results */
+} IntakeResult;
+
+/**
+ * @struct IntakeLimits
+ * @brief Limits checked at intake; 0 means no limit.
+ */
+typedef struct {
+    int maxQueueDepth;                   /**< Orders in the queue */
+    int maxStationUnits[INTAKE_STATIONS]; /**< Units not yet prepared, per station */
+    uint64_t maxWaitNanos;               /**< Predicted ready-in time (needs an estimator) */
+} IntakeLimits;
+
+/**
+ * @struct IntakeControl
+ * @brief Limits plus the live counters they are checked against.
+ */
+typedef struct {
+    IntakeLimits limits;                 /**< Limits in use */
+    const OrderQueue *queue;             /**< Queue the orders join */
+    const WaitEstimator *eta;            /**< Wait predictions, NULL to skip the wait limit */
+    int stationUnits[INTAKE_STATIONS];   /**< Units queued and not yet ready, per station */
+    long decisions[INTAKE_RESULT_COUNT]; /**< Intake decisions so far, by result */
+} IntakeControl;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Creates an intake gate and starts following the order queue.
+ *
+ * Orders already in the queue are counted once here.
+ *
+ * @param queue  Queue that admitted orders join.
+ * @param limits Limits to enforce.
+ * @param eta    Wait estimator for the wait limit, or NULL.
+ *
+ * @return Pointer to the new IntakeControl, or NULL on failure.
+ */
+IntakeControl* createIntakeControl(const OrderQueue *queue, const IntakeLimits *limits,
+                                   const WaitEstimator *eta);
+
+/**
+ * @brief Decides whether a basket may be queued now.
+ *
+ * @param control Pointer to the intake gate.
+ * @param items   Lines of the basket.
+ *
+ * @return INTAKE_ACCEPTED, or the reason the basket is refused.
+ */
+IntakeResult checkIntake(const IntakeControl *control, const OrderItem *items);
+
+/**
+ * @brief Queues a basket if the intake gate admits it.
+ *
+ * On refusal nothing is queued and the caller keeps the items, e.g. to
+ * discard them or to try again later.
+ *
+ * @param control     Pointer to the intake gate.
+ * @param queue       Pointer to the order queue.
+ * @param orderId     Unique order ID.
+ * @param consumer    Consumer placing the order.
+ * @param items       Lines of the basket.
+ * @param totalAmount Total order amount.
+ * @param result      Receives the intake decision (may be NULL).
+ *
+ * @return The queued Order, or NULL if it was refused.
+ */
+Order* submitOrder(IntakeControl *control, OrderQueue *queue, int orderId,
+                   const Consumer *consumer, OrderItem *items, float totalAmount,
+                   IntakeResult *result);
+
+/**
+ * @brief Tells whether a refusal is temporary.
+ *
+ * @param result An intake decision.
+ *
+ * @return 1 if the same basket may be admitted later, 0 otherwise.
+ */
+int isIntakeDeferral(IntakeResult result);
+
+/**
+ * @brief Returns a short description of an intake decision.
+ *
+ * @param result An intake decision.
+ *
+ * @return Text such as "kitchen queue is full".
+ */
+const char* intakeResultText(IntakeResult result);
+
+/**
+ * @brief Stops following the queue and frees the intake gate.
+ *
+ * @param control Pointer to the intake gate.
+ */
+void freeIntakeControl(IntakeControl *control);
+
+#endif /* INTAKE_H */
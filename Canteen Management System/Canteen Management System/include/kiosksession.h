@@ -0,0 +1,142 @@
+#ifndef KIOSKSESSION_H
+#define KIOSKSESSION_H
+
+#include <stddef.h>
+#include "menuitem.h"
+#include "consumer.h"
+#include "order.h"
+#include "undo.h"
+#include "menuindex.h"
+#include "menusnapshot.h"
+#include "menusearch.h"
+#include "waitestimate.h"
+#include "intake.h"
+#include "combo.h"
+#include "reservation.h"
+
+/**
+ * @file kiosksession.h
+ * @brief Resumable consumer sessions driven by input lines.
+ *
+ * This header file defines the consumer flow (identify, view menu,
+ * build a basket, place, cancel, view orders, search, pre-order and
+ * collect) as a state
+ * machine. A session never blocks: the caller hands it one line of
+ * input at a time and it answers through a writer callback, ending
+ * with the next prompt. One thread can therefore interleave any
+ * number of sessions, e.g. one per kiosk terminal.
+ *
+ * Sessions share one KioskCanteen and are not thread-safe; drive all
+ * sessions of a canteen from the same thread. Stock for a basket line
+ * is taken when the line is entered, so concurrent baskets never
+ * oversell; kioskEnd() gives back the stock of an unfinished basket.
+ */
+
+/** Longest consumer name kept by a session (including the terminator). */
+#define KIOSK_NAME_LENGTH 50
+
+/** Minutes a kiosk pre-order holds its stock before it is released. */
+#define KIOSK_PREORDER_MINUTES 30
+
+/**
+ * @enum KioskState
+ * @brief Which answer a session is waiting for.
+ */
+typedef enum {
+    KIOSK_ASK_NAME,           /**< Consumer name */
+    KIOSK_ASK_UID,            /**< Consumer UID */
+    KIOSK_ASK_CHOICE,         /**< Main menu choice */
+    KIOSK_ASK_ITEM_COUNT,     /**< Number of lines to order */
+    KIOSK_ASK_ITEM_ID,        /**< Menu ID of the current line (0 cancels) */
+    KIOSK_ASK_QUANTITY,       /**< Quantity of the current line */
+    KIOSK_ASK_SEARCH,         /**< Search text */
+    KIOSK_ASK_RESERVATION,    /**< Pre-order ID to collect */
+    KIOSK_FINISHED            /**< Consumer chose Exit */
+} KioskState;
+
+/**
+ * @brief Receives a session's output.
+ *
+ * @param context Value given to kioskStart().
+ * @param text    Output text (not NUL-terminated).
+ * @param length  Bytes in text.
+ */
+typedef void (*KioskWriter)(void *context, const char *text, size_t length);
+
+/**
+ * @struct KioskCanteen
+ * @brief State shared by all sessions of one canteen.
+ */
+typedef struct {
+    Consumer **consumerHead;  /**< Consumer list (new consumers are added) */
+    Menu *menuHead;           /**< Menu list */
+    MenuIndex *menuIndex;     /**< Sorted menu views */
+    MenuSearch *menuSearch;   /**< Name search */
+    OrderQueue *queue;        /**< Live order queue */
+    OrderStack *stack;        /**< Undo stack */
+    int nextOrderId;          /**< ID given to the next order */
+    WaitEstimator *eta;       /**< Ready-in estimates, NULL to show none (static unless orders are started and served) */
+    IntakeControl *intake;    /**< Admission limits, NULL to accept every order (only useful if orders are served) */
+    ComboBook *combos;        /**< Combos on offer, or NULL */
+    MenuStore *menuStore;     /**< Snapshots the menu is shown from, NULL to walk menuHead */
+    ReservationBook *reservations; /**< Pre-order holds, NULL to offer no pre-orders */
+} KioskCanteen;
+
+/**
+ * @struct KioskSession
+ * @brief One consumer's progress through the flow.
+ */
+typedef struct {
+    KioskState state;                 /**< Answer awaited */
+    KioskCanteen *canteen;            /**< Shared canteen */
+    KioskWriter write;                /**< Output callback */
+    void *context;                    /**< Passed to write */
+    Consumer *consumer;               /**< Identified consumer, NULL before the UID */
+    OrderItem *basketHead;            /**< Lines entered so far */
+    OrderItem *basketTail;            /**< Last line entered */
+    float basketTotal;                /**< Total of the basket */
+    int linesWanted;                  /**< Lines the consumer asked to order */
+    int linesEntered;                 /**< Lines entered so far */
+    int pendingMenuId;                /**< Menu ID awaiting its quantity */
+    int preorder;                     /**< Basket is held for pickup rather than queued */
+    char name[KIOSK_NAME_LENGTH];     /**< Name until the consumer is identified */
+} KioskSession;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Starts a session and writes the first prompt.
+ *
+ * @param session Session to initialise.
+ * @param canteen Shared canteen.
+ * @param write   Output callback.
+ * @param context Passed to write.
+ */
+void kioskStart(KioskSession *session, KioskCanteen *canteen, KioskWriter write, void *context);
+
+/**
+ * @brief Feeds one line of input to a session.
+ *
+ * Runs the step the line answers and writes the result followed by
+ * the next prompt. Trailing newline and surrounding blanks are ignored.
+ *
+ * @param session Session that received the line.
+ * @param line    Input line.
+ *
+ * @return 1 while the session continues, 0 once the consumer has exited.
+ */
+int kioskInput(KioskSession *session, const char *line);
+
+/**
+ * @brief Ends a session, e.g. when its terminal disconnects.
+ *
+ * Returns the stock held by an unfinished basket. The session may be
+ * started again afterwards.
+ *
+ * @param session Session to end.
+ */
+void kioskEnd(KioskSession *session);
+
+#endif /* KIOSKSESSION_H */
@@ -0,0 +1,147 @@
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/**
+ * @file memtrack.h
+ * @brief Allocation accounting by subsystem.
+ *
+ * This header file defines tagged allocation functions used for the
+ * core data structures. Every block carries a small header with its
+ * size, subsystem tag and allocation site, so the accounting can
+ * report live bytes and blocks, high-water marks and, at shutdown,
+ * which subsystem and which source line still own memory.
+ *
+ * Blocks from memAlloc()/memRealloc()/memStrdup() must be released
+ * with memFree().
+ * The accounting takes no lock: counters are atomics, and a call site
+ * is found by hashing its __FILE__ pointer and line, so threads that
+ * allocate at the same time never wait for each other.
+ */
+
+/**
+ * @enum MemTag
+ * @brief Subsystem that owns an allocation.
+ */
+typedef enum {
+    MEM_MENU,                 /**< Menu items, their names, index, search trie and snapshots */
+    MEM_CONSUMERS,            /**< Consumers */
+    MEM_USERS,                /**< Users and the user index */
+    MEM_ORDERS,               /**< Orders, order items and the queue */
+    MEM_UNDO,                 /**< Undo stack */
+    MEM_ARCHIVE,              /**< Order archive and history file codecs */
+    MEM_REPORTS,              /**< Sales, rush and stock aggregates and reports */
+    MEM_TAG_COUNT             /**< Number of tags */
+} MemTag;
+
+/** Allocation sites tracked individually; later sites are only counted per tag. */
+#define MEM_MAX_SITES 128
+
+/**
+ * @struct MemUsage
+ * @brief Counters of one subsystem.
+ */
+typedef struct {
+    long liveBytes;           /**< Bytes currently allocated */
+    long liveBlocks;          /**< Blocks currently allocated */
+    long peakBytes;           /**< Highest liveBytes seen */
+    long peakBlocks;          /**< Highest liveBlocks seen */
+    long allocations;         /**< Blocks allocated so far */
+    long frees;               /**< Blocks freed so far */
+} MemUsage;
+
+/** Allocates size bytes owned by tag. */
+#define memAlloc(tag, size)     trackedAlloc((tag), (size), 0, __FILE__, __LINE__)
+
+/** Allocates count zeroed elements owned by tag. */
+#define memCalloc(tag, count, size) trackedAlloc((tag), (count) * (size), 1, __FILE__, __LINE__)
+
+/** Resizes a tracked block (or allocates one owned by tag if ptr is NULL). */
+#define memRealloc(tag, ptr, size) trackedRealloc((tag), (ptr), (size), __FILE__, __LINE__)
+
+/** Duplicates a string owned by tag. */
+#define memStrdup(tag, s)       trackedStrdup((tag), (s), __FILE__, __LINE__)
+
+/** Frees a tracked block (NULL is ignored). */
+#define memFree(ptr)            trackedFree(ptr)
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Allocates a tracked block. Use memAlloc()/memCalloc().
+ *
+ * @param tag  Owning subsystem.
+ * @param size Bytes to allocate.
+ * @param zero Non-zero to clear the block.
+ * @param file Source file of the call.
+ * @param line Source line of the call.
+ *
+ * @return Pointer to the block, or NULL on failure.
+ */
+void* trackedAlloc(MemTag tag, size_t size, int zero, const char *file, int line);
+
+/**
+ * @brief Resizes a tracked block. Use memRealloc().
+ *
+ * The block keeps its tag and allocation site; only its size changes.
+ *
+ * @param tag  Owning subsystem if ptr is NULL.
+ * @param ptr  Block from trackedAlloc(), or NULL.
+ * @param size New size in bytes.
+ * @param file Source file of the call.
+ * @param line Source line of the call.
+ *
+ * @return Pointer to the resized block, or NULL on failure (ptr is then unchanged).
+ */
+void* trackedRealloc(MemTag tag, void *ptr, size_t size, const char *file, int line);
+
+/**
+ * @brief Duplicates a string into a tracked block. Use memStrdup().
+ *
+ * @param tag  Owning subsystem.
+ * @param s    String to copy.
+ * @param file Source file of the call.
+ * @param line Source line of the call.
+ *
+ * @return Pointer to the copy, or NULL on failure.
+ */
+char* trackedStrdup(MemTag tag, const char *s, const char *file, int line);
+
+/**
+ * @brief Frees a tracked block. Use memFree().
+ *
+ * @param ptr Block from trackedAlloc() or trackedStrdup(), or NULL.
+ */
+void trackedFree(void *ptr);
+
+/**
+ * @brief Returns the counters of one subsystem.
+ *
+ * @param tag   Subsystem.
+ * @param usage Receives the counters.
+ */
+void getMemoryUsage(MemTag tag, MemUsage *usage);
+
+/**
+ * @brief Prints live and peak usage per subsystem.
+ *
+ * @param out Destination.
+ */
+void displayMemoryUsage(FILE *out);
+
+/**
+ * @brief Prints every allocation site that still owns memory.
+ *
+ * Meant to be called at shutdown after everything was freed.
+ *
+ * @param out Destination.
+ *
+ * @return Number of leaked blocks.
+ */
+long reportMemoryLeaks(FILE *out);
+
+#endif /* MEMTRACK_H */
@@ -0,0 +1,141 @@
+#ifndef MENUINDEX_H
+#define MENUINDEX_H
+
+#include <stdint.h>
+#include "menuitem.h"
+
+/**
+ * @file menuindex.h
+ * @brief Sorted secondary indexes over the menu list.
+ *
+ * This header file defines skip-list based indexes that keep the
+ * menu ordered by price, by type and by remaining quantity. The
+ * indexes register themselves as menu observers, so addMenuItem(),
+ * editMenuItem() and stock changes update them in O(log n) and
+ * sorted views never need a copy-and-sort of the whole menu.
+ */
+
+/** Maximum height of a skip list tower. */
+#define MENU_INDEX_MAX_LEVEL 16
+
+/**
+ * @enum MenuOrder
+ * @brief Sort orders maintained by the index.
+ */
+typedef enum {
+    MENU_BY_PRICE,      /**< Ascending price */
+    MENU_BY_TYPE,       /**< Grouped by type, then ascending price */
+    MENU_BY_QUANTITY,   /**< Ascending stock (lowest first) */
+    MENU_ORDER_COUNT    /**< Number of sort orders */
+} MenuOrder;
+
+/**
+ * @struct MenuIndexNode
+ * @brief Node of a skip list referencing one menu item.
+ */
+typedef struct MenuIndexNode {
+    Menu *item;                          /**< Indexed menu item */
+    int level;                           /**< Height of this node */
+    struct MenuIndexNode *forward[];     /**< Next node on each level */
+} MenuIndexNode;
+
+/**
+ * @struct MenuIndex
+ * @brief One skip list per sort order.
+ */
+typedef struct MenuIndex {
+    MenuIndexNode *heads[MENU_ORDER_COUNT];  /**< Sentinel head of each list */
+    int levels[MENU_ORDER_COUNT];            /**< Current height of each list */
+    int count;                               /**< Number of indexed items */
+    uint32_t seed;                           /**< State for level generation */
+} MenuIndex;
+
+/**
+ * @struct MenuIndexCursor
+ * @brief Position inside one of the sorted lists, used for range walks.
+ */
+typedef struct {
+    MenuIndexNode *node;      /**< Current node, NULL when exhausted */
+} MenuIndexCursor;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Builds an index over an existing menu.
+ *
+ * Indexes every item in the list and registers a menu observer
+ * so later changes are applied incrementally.
+ *
+ * @param head Pointer to the head of the menu list.
+ *
+ * @return Pointer to the new MenuIndex, or NULL on failure.
+ */
+MenuIndex* createMenuIndex(Menu *head);
+
+/**
+ * @brief Positions a cursor on the first item whose key is >= fromKey.
+ *
+ * The key is the price for MENU_BY_PRICE, the ItemType value for
+ * MENU_BY_TYPE and the quantity for MENU_BY_QUANTITY.
+ *
+ * @param index   Pointer to the index.
+ * @param order   Sort order to walk.
+ * @param fromKey Lower bound of the range.
+ * @param cursor  Cursor to initialise.
+ *
+ * @return The first matching item, or NULL if none.
+ */
+Menu* menuIndexSeek(MenuIndex *index, MenuOrder order, float fromKey, MenuIndexCursor *cursor);
+
+/**
+ * @brief Advances a cursor to the next item in sort order.
+ *
+ * @param cursor Cursor returned by menuIndexSeek().
+ *
+ * @return The next item, or NULL at the end of the list.
+ */
+Menu* menuIndexNext(MenuIndexCursor *cursor);
+
+/**
+ * @brief Returns the sort key of an item for a given order.
+ *
+ * @param item  Pointer to the menu item.
+ * @param order Sort order.
+ *
+ * @return Primary key value used by the index.
+ */
+float menuIndexKey(const Menu *item, MenuOrder order);
+
+/**
+ * @brief Displays the menu in the given sort order.
+ *
+ * @param index Pointer to the index.
+ * @param order Sort order.
+ */
+void displayMenuSorted(MenuIndex *index, MenuOrder order);
+
+/**
+ * @brief Displays items whose key lies in [lo, hi].
+ *
+ * Useful for price bands on the kiosk or the low-stock
+ * restock screen (MENU_BY_QUANTITY, 0, threshold).
+ *
+ * @param index Pointer to the index.
+ * @param order Sort order.
+ * @param lo    Inclusive lower bound.
+ * @param hi    Inclusive upper bound.
+ */
+void displayMenuRange(MenuIndex *index, MenuOrder order, float lo, float hi);
+
+/**
+ * @brief Frees the index and unregisters its observer.
+ *
+ * Menu items themselves are not freed.
+ *
+ * @param index Pointer to the index.
+ */
+void freeMenuIndex(MenuIndex *index);
+
+#endif /* MENUINDEX_H */
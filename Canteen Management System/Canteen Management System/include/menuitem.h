@@ -38,10 +38,49 @@ typedef struct Menu {
     ItemType type;            /**< Type/category of the item */
     float price;              /**< Price of the item */
     uint16_t quantity;        /**< Available stock quantity */
+    int refCount;             /**< Order lines still referencing this item */
+    int retired;              /**< 1 once removed from the menu list */
     struct Menu *prev;        /**< Pointer to the previous item */
     struct Menu *next;        /**< Pointer to the next item */
 } Menu;
 
+/**
+ * @enum MenuEvent
+ * @brief Change notifications delivered to menu observers.
+ *
+ * "-ING" events fire before the item is modified so observers can
+ * still see the old values; "-ED" events fire after the change.
+ */
+typedef enum {
+    MENU_ITEM_ADDED,       /**< Item was appended to the menu */
+    MENU_ITEM_EDITING,     /**< Name, type or price is about to change */
+    MENU_ITEM_EDITED,      /**< Name, type or price has changed */
+    MENU_STOCK_CHANGING,   /**< Quantity is about to change */
+    MENU_STOCK_CHANGED,    /**< Quantity has changed */
+    MENU_ITEM_REMOVING     /**< Item is about to be unlinked from the menu */
+} MenuEvent;
+
+/**
+ * @brief Callback invoked on menu changes.
+ *
+ * @param item    The affected menu item.
+ * @param event   Kind of change.
+ * @param context User pointer given at registration.
+ */
+typedef void (*MenuObserver)(Menu *item, MenuEvent event, void *context);
+
+/**
+ * @brief Callback that takes over a name replaced by editMenuItem().
+ *
+ * @param name    The old name; the callback must memFree() it once no
+ *                reader can still hold it.
+ * @param context User pointer given at registration.
+ */
+typedef void (*MenuNameReclaimer)(char *name, void *context);
+
+/** Maximum number of observers that can be registered at once. */
+#define MAX_MENU_OBSERVERS 8
+
 /* ===============================
    Menu item creation and insertion
    =============================== */
@@ -110,6 +149,8 @@ void displayMenu(Menu *head);
  * @brief Edits an existing menu item.
  *
  * Updates the name, type, and price of the specified menu item.
+ * The old name goes to the name reclaimer (see setMenuNameReclaimer()),
+ * or is freed at once if none is set.
  *
  * @param head     Pointer to the head of the menu list.
  * @param id       ID of the menu item to be edited.
@@ -131,6 +172,93 @@ void editMenuItem(Menu *head, int id, const char *newName, ItemType newType, flo
  */
 void updateQuantity(Menu *head, int id, int change);
 
+/**
+ * @brief Adjusts the stock of a known menu item.
+ *
+ * Same as updateQuantity() but without the ID lookup. All stock
+ * changes (orders, undo, restock) should go through this function
+ * so that registered observers stay in sync.
+ *
+ * @param item   Pointer to the menu item.
+ * @param change Quantity change (positive or negative).
+ *
+ * @return 0 on success, -1 if the result would be out of range.
+ */
+int adjustItemQuantity(Menu *item, int change);
+
+/* ===============================
+   Item removal and references
+   =============================== */
+
+/**
+ * @brief Removes a menu item from the list.
+ *
+ * The item is unlinked and marked retired. If pending order
+ * lines still reference it, the memory is kept until the last
+ * reference is released; otherwise it is freed immediately.
+ *
+ * @param head Pointer to the head pointer of the menu list.
+ * @param id   ID of the menu item to remove.
+ *
+ * @return 0 on success, -1 if the item was not found.
+ */
+int removeMenuItem(Menu **head, int id);
+
+/**
+ * @brief Takes a reference on a menu item.
+ *
+ * Called for every order line that points at the item.
+ *
+ * @param item Pointer to the menu item.
+ */
+void retainMenuItem(Menu *item);
+
+/**
+ * @brief Drops a reference on a menu item.
+ *
+ * Frees the item if it has been removed from the menu and
+ * this was the last reference.
+ *
+ * @param item Pointer to the menu item.
+ */
+void releaseMenuItem(Menu *item);
+
+/* ===============================
+   Change observers
+   =============================== */
+
+/**
+ * @brief Registers an observer for menu changes.
+ *
+ * @param observer Callback to invoke.
+ * @param context  User pointer passed back to the callback.
+ *
+ * @return 0 on success, -1 if the observer table is full.
+ */
+int addMenuObserver(MenuObserver observer, void *context);
+
+/**
+ * @brief Unregisters a previously added observer.
+ *
+ * @param observer Callback that was registered.
+ * @param context  Context it was registered with.
+ */
+void removeMenuObserver(MenuObserver observer, void *context);
+
+/**
+ * @brief Sets who frees names replaced by editMenuItem().
+ *
+ * A reclaimer can delay the free until concurrent readers are done,
+ * e.g. the menu store's epochs (see menusnapshot.h).
+ *
+ * @param reclaimer Callback, or NULL to free old names at once again.
+ * @param context   User pointer passed back to the callback; to unset,
+ *                  the context the reclaimer was set with.
+ *
+ * @return 0 on success, -1 if another reclaimer is already set.
+ */
+int setMenuNameReclaimer(MenuNameReclaimer reclaimer, void *context);
+
 /* ===============================
    Memory cleanup
    =============================== */
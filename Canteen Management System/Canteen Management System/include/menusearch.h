@@ -0,0 +1,109 @@
+#ifndef MENUSEARCH_H
+#define MENUSEARCH_H
+
+#include <stdint.h>
+#include "menuitem.h"
+
+/**
+ * @file menusearch.h
+ * @brief Prefix and typo-tolerant name search over the menu.
+ *
+ * This header file defines a trie built from menu item names.
+ * Every word of a name is indexed, so "sand" finds "Chicken
+ * Sandwich". Queries walk the trie with a Levenshtein row per
+ * level and prune branches that exceed the allowed edits, which
+ * keeps lookups in the microsecond range on large catalogues.
+ * The trie observes the menu, so it follows addMenuItem() and
+ * editMenuItem() incrementally.
+ */
+
+/** Number of distinct child slots: a-z, 0-9 and one for anything else. */
+#define MENU_SEARCH_ALPHABET 37
+
+/** Longest query that is considered; longer input is truncated. */
+#define MENU_SEARCH_MAX_QUERY 32
+
+/**
+ * @struct MenuSearchNode
+ * @brief Trie node; items are stored on the node where a word ends.
+ */
+typedef struct MenuSearchNode {
+    struct MenuSearchNode *children[MENU_SEARCH_ALPHABET]; /**< Child per character slot */
+    uint64_t childMask;        /**< Bit c set when children[c] exists */
+    Menu **items;              /**< Items whose indexed word ends here */
+    int itemCount;             /**< Number of entries in items */
+    int itemCapacity;          /**< Allocated size of items */
+    int subtreeCount;          /**< Entries in this node and all descendants */
+} MenuSearchNode;
+
+/**
+ * @struct MenuSearch
+ * @brief Name search index over one menu.
+ */
+typedef struct {
+    MenuSearchNode *root;      /**< Root of the trie */
+} MenuSearch;
+
+/**
+ * @struct MenuSearchHit
+ * @brief One ranked search result.
+ */
+typedef struct {
+    Menu *item;                /**< Matching menu item */
+    int distance;              /**< Edits needed to match the query as a prefix */
+    int exact;                 /**< 1 if the query equals the name from a word start to its end */
+} MenuSearchHit;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Builds a search index over an existing menu.
+ *
+ * Indexes every item and registers a menu observer to keep
+ * the index current.
+ *
+ * @param head Pointer to the head of the menu list.
+ *
+ * @return Pointer to the new MenuSearch, or NULL on failure.
+ */
+MenuSearch* createMenuSearch(Menu *head);
+
+/**
+ * @brief Searches item names by prefix with optional typo tolerance.
+ *
+ * Results are ranked by edit distance, then exact word matches,
+ * then shorter names. Each item appears at most once.
+ *
+ * @param search   Pointer to the search index.
+ * @param query    Text typed by the user (case-insensitive).
+ * @param maxEdits Allowed edits (0 for a pure prefix search).
+ * @param hits     Output array of at least k entries.
+ * @param k        Maximum number of results.
+ *
+ * @return Number of hits written.
+ */
+int searchMenuByName(MenuSearch *search, const char *query, int maxEdits,
+                     MenuSearchHit *hits, int k);
+
+/**
+ * @brief Prints the best matches for a query.
+ *
+ * Tries an exact prefix search first and falls back to one,
+ * then two, edits when nothing matches.
+ *
+ * @param search Pointer to the search index.
+ * @param query  Text typed by the user.
+ * @param k      Maximum number of results to print.
+ */
+void displaySearchResults(MenuSearch *search, const char *query, int k);
+
+/**
+ * @brief Frees the search index and unregisters its observer.
+ *
+ * @param search Pointer to the search index.
+ */
+void freeMenuSearch(MenuSearch *search);
+
+#endif /* MENUSEARCH_H */
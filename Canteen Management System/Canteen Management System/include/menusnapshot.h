@@ -0,0 +1,188 @@
+#ifndef MENUSNAPSHOT_H
+#define MENUSNAPSHOT_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include "menuitem.h"
+
+/**
+ * @file menusnapshot.h
+ * @brief Copy-on-write menu snapshots for lock-free readers.
+ *
+ * This header file defines a read-copy-update style menu store.
+ * Writers build an immutable copy of the menu and publish it with
+ * a single atomic pointer swap. Readers pin the current epoch,
+ * use the snapshot without taking any lock and unpin when done.
+ * Replaced snapshots are reclaimed once no reader pinned an epoch
+ * old enough to still see them.
+ *
+ * The store observes the menu: adding, editing and removing items
+ * publishes a new version automatically. Stock changes are too
+ * frequent to copy the menu each time, so they only mark the
+ * snapshot stale; call refreshMenu() before showing quantities.
+ *
+ * The admin console and the kiosk display the menu from the store,
+ * so what they print never points into a Menu an edit may free.
+ * The store is also the menu's name reclaimer: a name replaced by
+ * editMenuItem() is freed by the same epochs, so a reader pinned while
+ * it looks at a live item's name keeps that name alive.
+ */
+
+/** Maximum number of concurrently registered reader threads. */
+#define MAX_MENU_READERS 64
+
+/**
+ * @struct MenuEntry
+ * @brief Immutable copy of one menu item inside a snapshot.
+ */
+typedef struct {
+    int id;                   /**< Menu item ID */
+    char *name;               /**< Private copy of the name */
+    ItemType type;            /**< Type/category of the item */
+    float price;              /**< Price of the item */
+    uint16_t quantity;        /**< Stock at publish time */
+} MenuEntry;
+
+/**
+ * @struct MenuSnapshot
+ * @brief One published version of the menu, sorted by ID.
+ */
+typedef struct MenuSnapshot {
+    uint64_t version;                  /**< Monotonic version number */
+    int count;                         /**< Number of entries */
+    MenuEntry *entries;                /**< Entries sorted by ID */
+    uint64_t retireEpoch;              /**< Epoch at which it was replaced */
+    struct MenuSnapshot *nextRetired;  /**< Link in the retired list */
+} MenuSnapshot;
+
+/**
+ * @struct RetiredName
+ * @brief A replaced item name waiting for its readers to finish.
+ */
+typedef struct RetiredName {
+    char *name;                        /**< Old name, freed with memFree() */
+    uint64_t retireEpoch;              /**< Epoch at which it was replaced */
+    struct RetiredName *next;          /**< Link in the retired list */
+} RetiredName;
+
+/**
+ * @struct MenuStore
+ * @brief Holder of the current snapshot and the reclamation state.
+ *
+ * Only one writer may publish at a time; readers need no lock.
+ */
+typedef struct {
+    _Atomic(MenuSnapshot *) current;            /**< Latest published snapshot */
+    atomic_uint_fast64_t epoch;                 /**< Global epoch counter */
+    atomic_uint_fast64_t readers[MAX_MENU_READERS]; /**< Pinned epoch per reader, 0 if idle */
+    atomic_int readerUsed[MAX_MENU_READERS];    /**< 1 if the reader slot is taken */
+    MenuSnapshot *retired;                      /**< Snapshots waiting to be freed */
+    RetiredName *retiredNames;                  /**< Item names waiting to be freed */
+    Menu **head;                                /**< Menu list being mirrored */
+    int stale;                                  /**< 1 if stock changed since publish */
+} MenuStore;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Creates a store and publishes the first snapshot.
+ *
+ * Also becomes the name reclaimer (see setMenuNameReclaimer()), so
+ * only one store should exist at a time.
+ *
+ * @param head Pointer to the head pointer of the menu list.
+ *
+ * @return Pointer to the new MenuStore, or NULL on failure.
+ */
+MenuStore* createMenuStore(Menu **head);
+
+/**
+ * @brief Copies the current menu and publishes it atomically.
+ *
+ * Also frees replaced snapshots no reader can still observe.
+ * Must only be called from the writer thread.
+ *
+ * @param store Pointer to the menu store.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+int publishMenu(MenuStore *store);
+
+/**
+ * @brief Publishes the menu again if stock changed since the last publish.
+ *
+ * Must only be called from the writer thread.
+ *
+ * @param store Pointer to the menu store.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+int refreshMenu(MenuStore *store);
+
+/**
+ * @brief Claims a reader slot for the calling thread.
+ *
+ * @param store Pointer to the menu store.
+ *
+ * @return Slot number, or -1 if all slots are taken.
+ */
+int registerMenuReader(MenuStore *store);
+
+/**
+ * @brief Gives a reader slot back.
+ *
+ * @param store Pointer to the menu store.
+ * @param slot  Slot returned by registerMenuReader().
+ */
+void unregisterMenuReader(MenuStore *store, int slot);
+
+/**
+ * @brief Pins the current snapshot for reading.
+ *
+ * The snapshot stays valid until menuReadEnd() is called
+ * for the same slot.
+ *
+ * @param store Pointer to the menu store.
+ * @param slot  Reader slot of the calling thread.
+ *
+ * @return The current snapshot.
+ */
+const MenuSnapshot* menuReadBegin(MenuStore *store, int slot);
+
+/**
+ * @brief Unpins the snapshot obtained with menuReadBegin().
+ *
+ * @param store Pointer to the menu store.
+ * @param slot  Reader slot of the calling thread.
+ */
+void menuReadEnd(MenuStore *store, int slot);
+
+/**
+ * @brief Finds an entry by ID in a snapshot (binary search).
+ *
+ * @param snapshot Pointer to a pinned snapshot.
+ * @param id       Menu item ID.
+ *
+ * @return Pointer to the entry, or NULL if not present.
+ */
+const MenuEntry* findSnapshotEntry(const MenuSnapshot *snapshot, int id);
+
+/**
+ * @brief Displays a snapshot in the same layout as displayMenu().
+ *
+ * @param snapshot Pointer to a pinned snapshot.
+ */
+void displayMenuSnapshot(const MenuSnapshot *snapshot);
+
+/**
+ * @brief Frees the store and every snapshot it owns.
+ *
+ * No reader may be active when this is called.
+ *
+ * @param store Pointer to the menu store.
+ */
+void freeMenuStore(MenuStore *store);
+
+#endif /* MENUSNAPSHOT_H */
@@ -0,0 +1,194 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * @file metrics.h
+ * @brief Latency histograms and event counters for hot-path operations.
+ *
+ * This header file defines low-overhead instrumentation. Every thread
+ * records into its own shard (thread-local storage), so recording
+ * takes no locks; shards are summed only when a report is requested.
+ *
+ * Latencies go into HDR-style log-linear histograms: values below 16 ns
+ * are exact, larger values fall into 16 linear sub-buckets per power of
+ * two, so any recorded value is known to within about 6%.
+ *
+ * The METRIC_* macros compile to nothing unless CANTEEN_METRICS is
+ * defined (make METRICS=1), so an ordinary build carries no cost.
+ */
+
+/** Linear sub-buckets per power of two. */
+#define METRIC_SUB_BUCKETS 16
+
+/** Largest power of two tracked (2^47 ns, about 39 hours). */
+#define METRIC_MAX_EXPONENT 47
+
+/** Number of histogram buckets. */
+#define METRIC_BUCKETS ((METRIC_MAX_EXPONENT - 2) * METRIC_SUB_BUCKETS)
+
+/**
+ * @enum MetricOp
+ * @brief Timed operations.
+ */
+typedef enum {
+    METRIC_ORDER_PLACE,       /**< Enqueueing an order, observers included */
+    METRIC_STOCK_UPDATE,      /**< adjustItemQuantity() */
+    METRIC_MENU_LOOKUP,       /**< findMenuItem() */
+    METRIC_MENU_SEARCH,       /**< searchMenuByName() */
+    METRIC_CONSUMER_LOOKUP,   /**< findConsumer() */
+    METRIC_UNDO,              /**< undoLastOrder() */
+    METRIC_BILL_RENDER,       /**< printBill() */
+    METRIC_OP_COUNT           /**< Number of operations */
+} MetricOp;
+
+/**
+ * @enum MetricCounter
+ * @brief Counted events.
+ */
+typedef enum {
+    COUNTER_ORDERS_PLACED,    /**< Orders enqueued */
+    COUNTER_ORDERS_UNDONE,    /**< Orders undone */
+    COUNTER_UNDO_MISSES,      /**< Undo with nothing to undo */
+    COUNTER_STOCK_REJECTED,   /**< Stock changes refused as out of range */
+    COUNTER_MENU_MISSES,      /**< Menu lookups that found nothing */
+    COUNTER_CONSUMER_MISSES,  /**< Consumer lookups that found nothing */
+    METRIC_COUNTER_COUNT      /**< Number of counters */
+} MetricCounter;
+
+/**
+ * @struct LatencyHistogram
+ * @brief Log-linear histogram of latencies in nanoseconds.
+ */
+typedef struct {
+    uint64_t counts[METRIC_BUCKETS];  /**< Samples per bucket */
+    uint64_t total;                   /**< Number of samples */
+    uint64_t sum;                     /**< Sum of all samples */
+    uint64_t min;                     /**< Smallest sample, UINT64_MAX if none */
+    uint64_t max;                     /**< Largest sample */
+} LatencyHistogram;
+
+/* ===============================
+   Instrumentation macros
+   =============================== */
+
+#ifdef CANTEEN_METRICS
+#define METRIC_START(t)     uint64_t t = metricNanos()
+#define METRIC_STOP(op, t)  recordLatency((op), metricNanos() - (t))
+#define METRIC_COUNT(c, n)  countMetric((c), (n))
+#else
+#define METRIC_START(t)     ((void)0)
+#define METRIC_STOP(op, t)  ((void)0)
+#define METRIC_COUNT(c, n)  ((void)0)
+#endif
+
+/* ===============================
+   Histogram functions
+   =============================== */
+
+/**
+ * @brief Clears a histogram.
+ *
+ * @param histogram Histogram to clear.
+ */
+void resetHistogram(LatencyHistogram *histogram);
+
+/**
+ * @brief Adds one sample.
+ *
+ * @param histogram Histogram to update.
+ * @param nanos     Sample in nanoseconds.
+ */
+void histogramRecord(LatencyHistogram *histogram, uint64_t nanos);
+
+/**
+ * @brief Returns the value at a percentile.
+ *
+ * @param histogram  Histogram to query.
+ * @param percentile Percentile in 0..100.
+ *
+ * @return Upper bound of the bucket holding the percentile, 0 if empty.
+ */
+uint64_t histogramPercentile(const LatencyHistogram *histogram, double percentile);
+
+/* ===============================
+   Recording and reporting
+   =============================== */
+
+/**
+ * @brief Returns a monotonic timestamp in nanoseconds.
+ *
+ * @return Nanoseconds since an arbitrary fixed point.
+ */
+uint64_t metricNanos(void);
+
+/**
+ * @brief Records one latency sample in the calling thread's shard.
+ *
+ * @param op    Operation timed.
+ * @param nanos Elapsed nanoseconds.
+ */
+void recordLatency(MetricOp op, uint64_t nanos);
+
+/**
+ * @brief Adds to a counter in the calling thread's shard.
+ *
+ * @param counter Counter to update.
+ * @param n       Amount to add.
+ */
+void countMetric(MetricCounter counter, uint64_t n);
+
+/**
+ * @brief Sums one operation's histogram over all threads.
+ *
+ * @param op  Operation.
+ * @param out Receives the merged histogram.
+ */
+void collectLatency(MetricOp op, LatencyHistogram *out);
+
+/**
+ * @brief Sums one counter over all threads.
+ *
+ * @param counter Counter.
+ *
+ * @return Current total.
+ */
+uint64_t collectCounter(MetricCounter counter);
+
+/**
+ * @brief Clears all histograms and counters of every thread.
+ */
+void resetMetrics(void);
+
+/**
+ * @brief Returns 1 if this build records metrics (CANTEEN_METRICS).
+ *
+ * @return 1 if enabled, 0 otherwise.
+ */
+int metricsEnabled(void);
+
+/**
+ * @brief Writes all metrics as text.
+ *
+ * One line per operation with count, mean, min, p50, p90, p99,
+ * p99.9 and max, then one line per counter.
+ *
+ * @param out Destination.
+ */
+void dumpMetrics(FILE *out);
+
+/**
+ * @brief Dumps metrics to stderr whenever SIGUSR1 is received.
+ *
+ * Blocks SIGUSR1 in the calling thread and starts a thread that waits
+ * for it, so the dump never runs inside a signal handler. Call it from
+ * main() before any other thread is started. Does nothing on platforms
+ * without SIGUSR1.
+ *
+ * @return 0 on success, -1 if unsupported or the thread failed to start.
+ */
+int startMetricsSignalDump(void);
+
+#endif /* METRICS_H */
@@ -4,6 +4,7 @@
 #include <time.h>
 #include <stdint.h>
 #include "menuitem.h"
+#include "consumer.h"
 
 /**
  * @file order.h
@@ -28,9 +29,29 @@
 typedef struct OrderItem {
     Menu *menuItem;           /**< Pointer to the menu item */
     int quantity;             /**< Quantity ordered */
+    float unitPrice;          /**< Price of the item when it was ordered */
+    char *name;               /**< Name of the item when it was ordered, for bills */
     struct OrderItem *next;   /**< Pointer to the next order item */
 } OrderItem;
 
+/* ===============================
+   Order lifecycle
+   =============================== */
+
+/**
+ * @enum OrderStage
+ * @brief Points in an order's life that are timestamped.
+ */
+typedef enum {
+    STAGE_PLACED,             /**< Order was created */
+    STAGE_QUEUED,             /**< Order joined the queue (observers done) */
+    STAGE_STARTED,            /**< Kitchen started preparing it */
+    STAGE_READY,              /**< Ready for pickup */
+    STAGE_COLLECTED,          /**< Handed over and archived */
+    STAGE_CANCELLED,          /**< Undone before it was served */
+    ORDER_STAGE_COUNT         /**< Number of stages */
+} OrderStage;
+
 /* ===============================
    Order Node (Queue node)
    =============================== */
@@ -46,9 +67,20 @@ typedef struct Order {
     uint16_t orderId;         /**< Unique order ID */
     char *consumerName;       /**< Consumer name (dynamically allocated) */
     char *consumerUID;        /**< Consumer UID (dynamically allocated) */
+    ConsumerType consumerType; /**< Type of the consumer */
     OrderItem *items;         /**< Linked list of order items */
     float totalAmount;        /**< Total order amount */
     time_t orderTime;         /**< Order timestamp */
+    uint64_t stageNanos[ORDER_STAGE_COUNT]; /**< Monotonic time of each stage, 0 if not reached */
+    int priorityClass;        /**< Scheduler class while waiting to be started, -1 otherwise */
+    uint64_t deadlineNanos;   /**< Scheduler deadline (see scheduler.h) */
+    uint64_t workNanos;       /**< Estimated preparation time (see waitestimate.h) */
+    uint64_t workAheadNanos;  /**< Estimated work placed before this order */
+    struct RequestEntry *request; /**< Idempotency key that placed it (see idempotency.h), or NULL */
+    struct OrderStackNode *undoNode; /**< Undo stack node holding it (see undo.h), or NULL */
+    struct Order *classPrev;  /**< Previous order of the same scheduler class */
+    struct Order *classNext;  /**< Next order of the same scheduler class */
+    struct Order *prev;       /**< Pointer to the previous order in queue */
     struct Order *next;       /**< Pointer to the next order in queue */
 } Order;
 
@@ -60,7 +92,8 @@ typedef struct Order {
  * @struct OrderQueue
  * @brief FIFO queue for managing orders.
  *
- * Orders are processed in the order they are placed.
+ * Orders are processed in the order they are placed. The list is
+ * doubly linked so any order can be taken out in O(1).
  */
 typedef struct {
     Order *front;             /**< Pointer to the front of the queue */
@@ -68,6 +101,34 @@ typedef struct {
     int count;                /**< Number of orders in the queue */
 } OrderQueue;
 
+/* ===============================
+   Order events
+   =============================== */
+
+/**
+ * @enum OrderEvent
+ * @brief Queue changes delivered to order observers.
+ */
+typedef enum {
+    ORDER_ENQUEUED,           /**< Order was added to the queue */
+    ORDER_DEQUEUED,           /**< Order left the queue (served) */
+    ORDER_CANCELLED,          /**< Order was undone; it is freed right after */
+    ORDER_STARTED,            /**< Kitchen started the order (STAGE_STARTED) */
+    ORDER_READY               /**< Order is ready for pickup (STAGE_READY) */
+} OrderEvent;
+
+/**
+ * @brief Callback invoked on order queue changes.
+ *
+ * @param order   The affected order.
+ * @param event   Kind of change.
+ * @param context User pointer given at registration.
+ */
+typedef void (*OrderObserver)(Order *order, OrderEvent event, void *context);
+
+/** Maximum number of order observers that can be registered at once. */
+#define MAX_ORDER_OBSERVERS 8
+
 /* ===============================
    Function Declarations
    =============================== */
@@ -82,10 +143,13 @@ OrderQueue* createOrderQueue(void);
 /**
  * @brief Creates a new order item.
  *
+ * Copies the item's current name and price, so bills show what was
+ * ordered even after the item is edited or removed.
+ *
  * @param menuItem Pointer to the menu item.
  * @param quantity Quantity ordered.
  *
- * @return Pointer to the newly created OrderItem.
+ * @return Pointer to the newly created OrderItem, or NULL on failure.
  */
 OrderItem* createOrderItem(Menu *menuItem, int quantity);
 
@@ -93,7 +157,8 @@ OrderItem* createOrderItem(Menu *menuItem, int quantity);
  * @brief Enqueues a new order into the order queue.
  *
  * Adds an order to the rear of the queue and assigns
- * the current timestamp.
+ * the current timestamp. The consumer type is recorded
+ * as STUDENT; use enqueueConsumerOrder() when it is known.
  *
  * @param queue        Pointer to the order queue.
  * @param orderId      Unique order ID.
@@ -110,6 +175,25 @@ Order* enqueueOrder(OrderQueue *queue, int orderId,
                     OrderItem *items,
                     float totalAmount);
 
+/**
+ * @brief Enqueues an order placed by a known consumer.
+ *
+ * Same as enqueueOrder() but also records the consumer type,
+ * which reporting uses to split sales by STUDENT/STAFF/FACULTY.
+ *
+ * @param queue       Pointer to the order queue.
+ * @param orderId     Unique order ID.
+ * @param consumer    Consumer placing the order.
+ * @param items       Linked list of order items.
+ * @param totalAmount Total order amount.
+ *
+ * @return Pointer to the created Order.
+ */
+Order* enqueueConsumerOrder(OrderQueue *queue, int orderId,
+                            const Consumer *consumer,
+                            OrderItem *items,
+                            float totalAmount);
+
 /**
  * @brief Dequeues an order from the front of the queue.
  *
@@ -119,6 +203,39 @@ Order* enqueueOrder(OrderQueue *queue, int orderId,
  */
 Order* dequeueOrder(OrderQueue *queue);
 
+/**
+ * @brief Takes an order out of the queue wherever it is.
+ *
+ * Notifies observers with ORDER_DEQUEUED like dequeueOrder().
+ *
+ * @param queue Pointer to the order queue.
+ * @param order Order in that queue.
+ *
+ * @return The order, or NULL if it is not in the queue.
+ */
+Order* takeOrder(OrderQueue *queue, Order *order);
+
+/**
+ * @brief Tells whether an order is in a queue.
+ *
+ * @param queue Pointer to the order queue.
+ * @param order Order to check.
+ *
+ * @return 1 if the order is queued there, 0 otherwise.
+ */
+int isQueued(const OrderQueue *queue, const Order *order);
+
+/**
+ * @brief Unlinks a queued order without notifying observers.
+ *
+ * For callers that report the removal themselves, e.g. undo with
+ * ORDER_CANCELLED. The order must be in the queue (see isQueued()).
+ *
+ * @param queue Pointer to the order queue.
+ * @param order Order to unlink.
+ */
+void removeQueuedOrder(OrderQueue *queue, Order *order);
+
 /**
  * @brief Restores stock levels after undoing an order.
  *
@@ -151,6 +268,16 @@ void printBill(Order *order);
  */
 void freeOrderItems(OrderItem *items);
 
+/**
+ * @brief Abandons order items that were never enqueued.
+ *
+ * Gives the reserved quantities back to the menu stock, then frees
+ * the list.
+ *
+ * @param items Pointer to the head of the order item list.
+ */
+void discardOrderItems(OrderItem *items);
+
 /**
  * @brief Frees the entire order queue.
  *
@@ -160,6 +287,35 @@ void freeOrderItems(OrderItem *items);
  */
 void freeOrderQueue(OrderQueue *queue);
 
+/**
+ * @brief Registers an observer for order queue changes.
+ *
+ * @param observer Callback to invoke.
+ * @param context  User pointer passed back to the callback.
+ *
+ * @return 0 on success, -1 if the observer table is full.
+ */
+int addOrderObserver(OrderObserver observer, void *context);
+
+/**
+ * @brief Unregisters a previously added order observer.
+ *
+ * @param observer Callback that was registered.
+ * @param context  Context it was registered with.
+ */
+void removeOrderObserver(OrderObserver observer, void *context);
+
+/**
+ * @brief Delivers an order event to all registered observers.
+ *
+ * Used by modules outside order.c (e.g. undo) that change
+ * the queue.
+ *
+ * @param order Affected order.
+ * @param event Kind of change.
+ */
+void notifyOrderObservers(Order *order, OrderEvent event);
+
 /**
  * @brief Frees a single order.
  *
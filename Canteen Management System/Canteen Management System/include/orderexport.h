@@ -0,0 +1,162 @@
+#ifndef ORDEREXPORT_H
+#define ORDEREXPORT_H
+
+#include <stdio.h>
+#include <time.h>
+#include "archive.h"
+
+/**
+ * @file orderexport.h
+ * @brief Streaming CSV / JSON Lines export of orders.
+ *
+ * This header file defines an exporter that writes orders and their
+ * lines through one fixed-size buffer, so memory use does not depend
+ * on the size of the export. Numbers, amounts and timestamps are
+ * formatted by hand instead of printf, and the date part of the
+ * timestamp is cached per day.
+ *
+ * CSV writes one row per order line, repeating the order fields:
+ * order_id,order_time,consumer_uid,consumer_name,consumer_type,
+ * order_total,menu_id,quantity,unit_price,line_total
+ *
+ * JSON Lines writes one object per order with a "lines" array.
+ * Times are UTC in ISO 8601, amounts have two decimals.
+ */
+
+/** Size of the output buffer. */
+#define EXPORT_BUFFER_SIZE (64 * 1024)
+
+/** Size of the cached CSV order prefix. */
+#define EXPORT_PREFIX_SIZE 512
+
+/**
+ * @enum ExportFormat
+ * @brief Output format of an export.
+ */
+typedef enum {
+    EXPORT_CSV,               /**< Comma separated, one row per line */
+    EXPORT_JSONL              /**< JSON Lines, one object per order */
+} ExportFormat;
+
+/**
+ * @struct ExportFilter
+ * @brief Orders an export includes.
+ */
+typedef struct {
+    time_t from;              /**< Inclusive lower time bound */
+    time_t to;                /**< Exclusive upper time bound */
+    const char *consumerUID;  /**< Only this consumer, or NULL for all */
+} ExportFilter;
+
+/**
+ * @struct OrderExporter
+ * @brief Buffered writer for one export.
+ */
+typedef struct {
+    FILE *file;                         /**< Destination, not owned */
+    ExportFormat format;                /**< Output format */
+    char buffer[EXPORT_BUFFER_SIZE];    /**< Pending output */
+    size_t length;                      /**< Bytes pending in buffer */
+    char prefix[EXPORT_PREFIX_SIZE];    /**< CSV order fields of the current order */
+    size_t prefixLength;                /**< Bytes in prefix, 0 if it did not fit */
+    long cachedDay;                     /**< Day of cachedDate, -1 if none */
+    char cachedDate[11];                /**< "YYYY-MM-DD" of cachedDay */
+    long orders;                        /**< Orders written */
+    long lines;                         /**< Lines written */
+    long long bytes;                    /**< Bytes written to the file */
+    int failed;                         /**< Set after a write error */
+} OrderExporter;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Returns a filter over [from, to) for all consumers.
+ *
+ * @param from Inclusive lower time bound.
+ * @param to   Exclusive upper time bound.
+ *
+ * @return The filter.
+ */
+ExportFilter exportFilterRange(time_t from, time_t to);
+
+/**
+ * @brief Starts an export to an open file and writes the CSV header.
+ *
+ * @param file   Destination file; it is not closed by the exporter.
+ * @param format Output format.
+ *
+ * @return Pointer to the exporter, or NULL on failure.
+ */
+OrderExporter* openOrderExporter(FILE *file, ExportFormat format);
+
+/**
+ * @brief Writes one archived order.
+ *
+ * @param exporter Pointer to the exporter.
+ * @param order    Order to write.
+ *
+ * @return 0 on success, -1 on a write error.
+ */
+int exportArchivedOrder(OrderExporter *exporter, const ArchivedOrder *order);
+
+/**
+ * @brief Writes one live order with its OrderItem lines.
+ *
+ * @param exporter Pointer to the exporter.
+ * @param order    Order to write.
+ *
+ * @return 0 on success, -1 on a write error.
+ */
+int exportLiveOrder(OrderExporter *exporter, const Order *order);
+
+/**
+ * @brief Writes the archived orders that match a filter.
+ *
+ * @param exporter Pointer to the exporter.
+ * @param archive  Pointer to the archive.
+ * @param filter   Orders to include.
+ *
+ * @return Number of orders written, or -1 on a write error.
+ */
+long exportArchive(OrderExporter *exporter, const OrderArchive *archive, const ExportFilter *filter);
+
+/**
+ * @brief Writes the queued orders that match a filter.
+ *
+ * @param exporter Pointer to the exporter.
+ * @param queue    Pointer to the order queue.
+ * @param filter   Orders to include.
+ *
+ * @return Number of orders written, or -1 on a write error.
+ */
+long exportQueue(OrderExporter *exporter, const OrderQueue *queue, const ExportFilter *filter);
+
+/**
+ * @brief Flushes pending output and frees the exporter.
+ *
+ * @param exporter Pointer to the exporter.
+ *
+ * @return 0 if every write succeeded, -1 otherwise.
+ */
+int closeOrderExporter(OrderExporter *exporter);
+
+/**
+ * @brief Exports archived and queued orders to a file.
+ *
+ * Prints the number of orders, lines and bytes written and the
+ * throughput.
+ *
+ * @param archive Pointer to the archive (may be NULL).
+ * @param queue   Pointer to the order queue (may be NULL).
+ * @param path    File to create.
+ * @param format  Output format.
+ * @param filter  Orders to include.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int exportOrdersToFile(const OrderArchive *archive, const OrderQueue *queue, const char *path,
+                       ExportFormat format, const ExportFilter *filter);
+
+#endif /* ORDEREXPORT_H */
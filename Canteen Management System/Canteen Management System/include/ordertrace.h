@@ -0,0 +1,134 @@
+#ifndef ORDERTRACE_H
+#define ORDERTRACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "order.h"
+#include "metrics.h"
+
+/**
+ * @file ordertrace.h
+ * @brief Order lifecycle tracing and wait-time distributions.
+ *
+ * This header file defines the stage tracker for orders. Marking a
+ * stage stores a monotonic timestamp in the order itself and appends
+ * a compact record to a fixed-size ring, which keeps the most recent
+ * TRACE_RING_CAPACITY stage changes and can be dumped to a file.
+ *
+ * Three distributions are kept as the stages arrive:
+ *  - queue wait:  queued  -> started
+ *  - service:     started -> ready
+ *  - turnaround:  placed  -> collected
+ */
+
+/** Stage changes kept by the trace ring (a power of two). */
+#define TRACE_RING_CAPACITY 4096
+
+/**
+ * @struct OrderTraceRecord
+ * @brief One stage change in the trace ring.
+ */
+typedef struct {
+    uint64_t nanos;           /**< Monotonic time of the stage */
+    uint32_t elapsedMicros;   /**< Time since the order's previous stage */
+    uint16_t orderId;         /**< Order ID */
+    uint8_t stage;            /**< OrderStage */
+    uint8_t consumerType;     /**< ConsumerType of the order */
+} OrderTraceRecord;
+
+/**
+ * @struct OrderWaitStats
+ * @brief Latency distributions derived from the stages.
+ */
+typedef struct {
+    LatencyHistogram queueWait;   /**< queued -> started */
+    LatencyHistogram service;     /**< started -> ready */
+    LatencyHistogram turnaround;  /**< placed -> collected */
+} OrderWaitStats;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Timestamps a stage of an order and traces it.
+ *
+ * Each stage is stamped once; marking it again does nothing.
+ *
+ * @param order Order that reached the stage.
+ * @param stage Stage reached.
+ *
+ * @return 0 if the stage was stamped, -1 if it already was.
+ *
+ * Stamping STAGE_STARTED or STAGE_READY also notifies order observers
+ * (ORDER_STARTED, ORDER_READY).
+ */
+int markOrderStage(Order *order, OrderStage stage);
+
+/**
+ * @brief Returns the time between two stages of an order.
+ *
+ * @param order Order to inspect.
+ * @param from  Earlier stage.
+ * @param to    Later stage.
+ *
+ * @return Nanoseconds between the stages, 0 if either was not reached.
+ */
+uint64_t orderStageNanos(const Order *order, OrderStage from, OrderStage to);
+
+/**
+ * @brief Returns the name of a stage ("placed", "queued", ...).
+ *
+ * @param stage Stage.
+ *
+ * @return Static string.
+ */
+const char* orderStageName(OrderStage stage);
+
+/**
+ * @brief Marks the oldest queued order that is not being prepared as started.
+ *
+ * @param queue Order queue.
+ *
+ * @return The order, or NULL if every queued order is already started.
+ */
+Order* startNextOrder(OrderQueue *queue);
+
+/**
+ * @brief Marks the oldest order being prepared as ready for pickup.
+ *
+ * @param queue Order queue.
+ *
+ * @return The order, or NULL if no order is being prepared.
+ */
+Order* finishNextOrder(OrderQueue *queue);
+
+/**
+ * @brief Copies the wait-time distributions.
+ *
+ * @param stats Receives the distributions.
+ */
+void getOrderWaitStats(OrderWaitStats *stats);
+
+/**
+ * @brief Prints the wait-time distributions in milliseconds.
+ *
+ * @param out Destination.
+ */
+void displayOrderWaitStats(FILE *out);
+
+/**
+ * @brief Writes the trace ring to a CSV file, oldest record first.
+ *
+ * @param path File to create.
+ *
+ * @return Number of records written, or -1 if the file failed.
+ */
+long dumpOrderTrace(const char *path);
+
+/**
+ * @brief Empties the trace ring and clears the distributions.
+ */
+void resetOrderTrace(void);
+
+#endif /* ORDERTRACE_H */
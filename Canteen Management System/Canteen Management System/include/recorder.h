@@ -0,0 +1,171 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "menuitem.h"
+#include "order.h"
+
+/**
+ * @file recorder.h
+ * @brief Capture of library operations into a compact binary trace.
+ *
+ * This header file defines the operation recorder and the reader used
+ * to replay its traces. While recording, the library appends one
+ * record per menu lookup, menu item added, order placed (with its
+ * lines), undo and serve. Recording starts with a snapshot of the menu,
+ * so a replay can rebuild the same menu before re-issuing the traffic.
+ *
+ * Layout: "CMSR" + version byte + start time (8 bytes, seconds), then
+ * records of [u8 type][varint nanos since previous record][payload].
+ * Numbers are LEB128 varints (zig-zag where signed), strings are a
+ * varint length followed by the bytes.
+ *
+ * RECORD_OP() costs one branch while no recording is active.
+ */
+
+/** Longest string (UID or name) stored in a trace. */
+#define RECORDER_MAX_STRING 255
+
+/** Most lines one order record may carry. */
+#define RECORDER_MAX_LINES 256
+
+/**
+ * @enum RecordType
+ * @brief Kind of a recorded operation.
+ */
+typedef enum {
+    RECORD_MENU_ITEM = 1,     /**< Menu item present or added */
+    RECORD_MENU_LOOKUP,       /**< findMenuItem() */
+    RECORD_ORDER_PLACED,      /**< Order enqueued, with its lines */
+    RECORD_UNDO,              /**< Last order undone (cancel) */
+    RECORD_SERVE              /**< Front order served */
+} RecordType;
+
+/**
+ * @struct RecordedOp
+ * @brief One decoded record.
+ *
+ * Strings and line arrays point into the reader and stay valid until
+ * the next call to nextRecordedOp().
+ */
+typedef struct {
+    RecordType type;          /**< Kind of operation */
+    uint64_t nanos;           /**< Nanoseconds since recording started */
+    int menuId;               /**< Menu item (MENU_ITEM, MENU_LOOKUP) */
+    int itemType;             /**< ItemType (MENU_ITEM) */
+    float price;              /**< Price (MENU_ITEM) */
+    int quantity;             /**< Stock (MENU_ITEM) */
+    const char *name;         /**< Item name (MENU_ITEM) */
+    int orderId;              /**< Order ID (ORDER_PLACED) */
+    const char *consumerUID;  /**< Consumer UID (ORDER_PLACED) */
+    int consumerType;         /**< ConsumerType (ORDER_PLACED) */
+    int lineCount;            /**< Lines (ORDER_PLACED) */
+    const int32_t *menuIds;   /**< Menu ID per line (ORDER_PLACED) */
+    const int32_t *quantities; /**< Quantity per line (ORDER_PLACED) */
+} RecordedOp;
+
+/**
+ * @struct RecordingReader
+ * @brief Streaming decoder of a trace file.
+ */
+typedef struct {
+    FILE *file;                               /**< Input file */
+    int64_t startTime;                        /**< Calendar time the recording began */
+    uint64_t nanos;                           /**< Time of the last record read */
+    long records;                             /**< Records read so far */
+    char name[RECORDER_MAX_STRING + 1];       /**< Name buffer */
+    char uid[RECORDER_MAX_STRING + 1];        /**< UID buffer */
+    int32_t menuIds[RECORDER_MAX_LINES];      /**< Line buffer */
+    int32_t quantities[RECORDER_MAX_LINES];   /**< Line buffer */
+} RecordingReader;
+
+/** Non-zero while a recording is active; read by RECORD_OP(). */
+extern volatile int recorderActive;
+
+/** Runs a record call only while recording. */
+#define RECORD_OP(call) do { if (recorderActive) { call; } } while (0)
+
+/* ===============================
+   Recording
+   =============================== */
+
+/**
+ * @brief Starts recording to a new file.
+ *
+ * Writes the header and one MENU_ITEM record per item of the menu.
+ *
+ * @param path     File to create.
+ * @param menuHead Current menu (may be NULL).
+ *
+ * @return 0 on success, -1 if a recording is active or the file failed.
+ */
+int startRecording(const char *path, Menu *menuHead);
+
+/**
+ * @brief Stops recording and closes the file.
+ *
+ * @return Number of records written, or -1 if nothing was recording
+ *         or the final write failed.
+ */
+long stopRecording(void);
+
+/**
+ * @brief Records a menu item that was added.
+ *
+ * @param item The new item.
+ */
+void recordMenuItem(const Menu *item);
+
+/**
+ * @brief Records a menu lookup.
+ *
+ * @param menuId ID looked up.
+ */
+void recordMenuLookup(int menuId);
+
+/**
+ * @brief Records a placed order with its lines.
+ *
+ * @param order The enqueued order.
+ */
+void recordOrderPlaced(const Order *order);
+
+/**
+ * @brief Records an operation without payload (undo, serve).
+ *
+ * @param type RECORD_UNDO or RECORD_SERVE.
+ */
+void recordEvent(RecordType type);
+
+/* ===============================
+   Reading
+   =============================== */
+
+/**
+ * @brief Opens a trace and checks its header.
+ *
+ * @param path File to read.
+ *
+ * @return Pointer to the reader, or NULL on failure.
+ */
+RecordingReader* openRecording(const char *path);
+
+/**
+ * @brief Decodes the next record.
+ *
+ * @param reader Pointer to the reader.
+ * @param op     Receives the record.
+ *
+ * @return 1 if a record was read, 0 at the end, -1 if the trace is corrupt.
+ */
+int nextRecordedOp(RecordingReader *reader, RecordedOp *op);
+
+/**
+ * @brief Closes the trace and frees the reader.
+ *
+ * @param reader Pointer to the reader.
+ */
+void closeRecording(RecordingReader *reader);
+
+#endif /* RECORDER_H */
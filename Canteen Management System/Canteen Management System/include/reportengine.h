@@ -0,0 +1,131 @@
+#ifndef REPORTENGINE_H
+#define REPORTENGINE_H
+
+#include <stdint.h>
+#include <time.h>
+#include "archive.h"
+
+/**
+ * @file reportengine.h
+ * @brief Parallel group-by reports over the order archive.
+ *
+ * This header file defines the report engine used for finance
+ * reports. The archived rows of a time range are split into equal
+ * contiguous slices, one per worker thread. Each worker scans the
+ * archive columns of its slice, applies the filter and aggregates
+ * into its own hash table, so workers share nothing while running.
+ * The main thread then merges the per-worker tables and returns the
+ * groups sorted by key.
+ *
+ * Revenue is always the sum of quantity * unit price over the
+ * matching lines, so filtering by item and grouping by day or
+ * consumer type stay consistent with each other.
+ */
+
+/** Rows below which an extra worker thread is not worth starting. */
+#define REPORT_MIN_ROWS_PER_THREAD 4096
+
+/** Upper bound on worker threads. */
+#define REPORT_MAX_THREADS 64
+
+/**
+ * @enum ReportGroup
+ * @brief Key that report rows are grouped by.
+ */
+typedef enum {
+    REPORT_BY_ITEM,           /**< Menu item ID */
+    REPORT_BY_CONSUMER_TYPE,  /**< ConsumerType */
+    REPORT_BY_DAY,            /**< Days since the epoch (UTC) */
+    REPORT_BY_HOUR            /**< Hour of the day, 0-23 (UTC) */
+} ReportGroup;
+
+/**
+ * @struct ReportFilter
+ * @brief Rows a report includes.
+ */
+typedef struct {
+    time_t from;              /**< Inclusive lower time bound */
+    time_t to;                /**< Exclusive upper time bound */
+    unsigned typeMask;        /**< Bit (1 << ConsumerType) per included type, 0 for all */
+    int menuId;               /**< Only lines of this item, 0 for all */
+    float minTotal;           /**< Only orders with at least this total */
+} ReportFilter;
+
+/**
+ * @struct ReportRow
+ * @brief Aggregates of one group.
+ */
+typedef struct {
+    long key;                 /**< Group key (see ReportGroup) */
+    long orders;              /**< Orders with at least one matching line */
+    long units;               /**< Units on matching lines */
+    double revenue;           /**< Revenue of matching lines */
+} ReportRow;
+
+/**
+ * @struct Report
+ * @brief Result of a report run.
+ */
+typedef struct {
+    ReportGroup group;        /**< Grouping used */
+    ReportRow *rows;          /**< Groups sorted by key */
+    int count;                /**< Number of groups */
+    long scannedOrders;       /**< Archived orders in the time range */
+    int threads;              /**< Worker threads used */
+    double seconds;           /**< Wall-clock time of the scan and merge */
+} Report;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Returns a filter over [from, to) with no other conditions.
+ *
+ * @param from Inclusive lower time bound.
+ * @param to   Exclusive upper time bound.
+ *
+ * @return The filter.
+ */
+ReportFilter reportFilterRange(time_t from, time_t to);
+
+/**
+ * @brief Runs a grouped report over the archive.
+ *
+ * The archive must not change while the report runs.
+ *
+ * @param archive Pointer to the archive.
+ * @param filter  Rows to include.
+ * @param group   Grouping key.
+ * @param threads Worker threads, or 0 for one per online core.
+ *
+ * @return Pointer to the new Report, or NULL on failure.
+ */
+Report* runReport(const OrderArchive *archive, const ReportFilter *filter,
+                  ReportGroup group, int threads);
+
+/**
+ * @brief Finds the row of one group.
+ *
+ * @param report Pointer to the report.
+ * @param key    Group key.
+ *
+ * @return Pointer to the row, or NULL if the group is empty.
+ */
+const ReportRow* findReportRow(const Report *report, long key);
+
+/**
+ * @brief Prints a report as a table with a grand total.
+ *
+ * @param report Pointer to the report.
+ */
+void displayReport(const Report *report);
+
+/**
+ * @brief Frees a report.
+ *
+ * @param report Pointer to the report.
+ */
+void freeReport(Report *report);
+
+#endif /* REPORTENGINE_H */
@@ -0,0 +1,142 @@
+#ifndef RESERVATION_H
+#define RESERVATION_H
+
+#include <stdint.h>
+#include "order.h"
+#include "timerwheel.h"
+
+/**
+ * @file reservation.h
+ * @brief Pre-orders that hold stock until a pickup deadline.
+ *
+ * This header file defines the reservation book. A pre-order takes its
+ * stock when it is made, like a basket, and keeps it until the consumer
+ * claims it (it then joins the order queue) or until its deadline
+ * passes. Unclaimed holds are released automatically through
+ * discardOrderItems(), the same adjustItemQuantity() path that
+ * restoreStockLevels() uses, so stock observers see the stock return.
+ *
+ * Deadlines live in a hierarchical timing wheel (see timerwheel.h):
+ * reserving, claiming, cancelling and expiring are all O(1) per
+ * reservation, however many holds are outstanding. Reservations are
+ * also hashed by ID, so a consumer can claim one by the number shown.
+ */
+
+/** Buckets of the reservation ID hash (power of two). */
+#define RESERVATION_BUCKETS 4096
+
+/**
+ * @struct Reservation
+ * @brief One pre-order holding stock.
+ */
+typedef struct Reservation {
+    TimerNode timer;              /**< Hold deadline (keep first) */
+    int reservationId;            /**< ID shown to the consumer */
+    const Consumer *consumer;     /**< Consumer who pre-ordered */
+    OrderItem *items;             /**< Lines holding stock */
+    float totalAmount;            /**< Total of the lines */
+    uint64_t deadlineNanos;       /**< Hold is released at this monotonic time */
+    struct Reservation *idPrev;   /**< Previous reservation in the ID bucket */
+    struct Reservation *idNext;   /**< Next reservation in the ID bucket */
+} Reservation;
+
+/**
+ * @struct ReservationBook
+ * @brief Outstanding reservations and their deadlines.
+ */
+typedef struct {
+    TimingWheel wheel;            /**< Deadlines of the outstanding holds */
+    int nextReservationId;        /**< ID given to the next reservation */
+    long held;                    /**< Reservations holding stock */
+    long claimed;                 /**< Reservations turned into orders */
+    long expired;                 /**< Reservations released unclaimed */
+    long unitsReleased;           /**< Units given back by expired holds */
+    Reservation *byId[RESERVATION_BUCKETS]; /**< Held reservations hashed by ID */
+} ReservationBook;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Creates an empty reservation book.
+ *
+ * @param tickNanos Deadline resolution; holds are released within one tick after their deadline.
+ *
+ * @return Pointer to the new ReservationBook, or NULL on failure.
+ */
+ReservationBook* createReservationBook(uint64_t tickNanos);
+
+/**
+ * @brief Holds a basket until a deadline.
+ *
+ * The stock must already be taken (see discardOrderItems() for how it
+ * is given back). The book owns the items from now on. Holds already
+ * past their deadline are released first.
+ *
+ * @param book          Pointer to the reservation book.
+ * @param consumer      Consumer pre-ordering.
+ * @param items         Lines of the basket.
+ * @param totalAmount   Total of the basket.
+ * @param deadlineNanos Monotonic time the hold is released if unclaimed.
+ *
+ * @return The reservation, or NULL on failure (the caller keeps the items).
+ */
+Reservation* reserveStock(ReservationBook *book, const Consumer *consumer,
+                          OrderItem *items, float totalAmount, uint64_t deadlineNanos);
+
+/**
+ * @brief Finds a held reservation by its ID.
+ *
+ * Call expireReservations() first so that a hold past its deadline
+ * is not found.
+ *
+ * @param book          Pointer to the reservation book.
+ * @param reservationId ID given when the stock was reserved.
+ *
+ * @return The reservation, or NULL if it is not held (claimed, cancelled or expired).
+ */
+Reservation* findReservation(const ReservationBook *book, int reservationId);
+
+/**
+ * @brief Turns a held reservation into a queued order.
+ *
+ * The reservation is freed; its items move to the order.
+ *
+ * @param book        Pointer to the reservation book.
+ * @param reservation A reservation still held.
+ * @param queue       Pointer to the order queue.
+ * @param orderId     Unique order ID.
+ *
+ * @return The queued Order.
+ */
+Order* claimReservation(ReservationBook *book, Reservation *reservation,
+                        OrderQueue *queue, int orderId);
+
+/**
+ * @brief Cancels a held reservation and gives its stock back.
+ *
+ * @param book        Pointer to the reservation book.
+ * @param reservation A reservation still held; it is freed.
+ */
+void cancelReservation(ReservationBook *book, Reservation *reservation);
+
+/**
+ * @brief Releases every hold whose deadline has passed.
+ *
+ * Call it regularly, e.g. once per second or before showing stock.
+ *
+ * @param book Pointer to the reservation book.
+ *
+ * @return Number of holds released.
+ */
+long expireReservations(ReservationBook *book);
+
+/**
+ * @brief Releases every outstanding hold and frees the book.
+ *
+ * @param book Pointer to the reservation book.
+ */
+void freeReservationBook(ReservationBook *book);
+
+#endif /* RESERVATION_H */
@@ -0,0 +1,144 @@
+#ifndef RUSHMETRICS_H
+#define RUSHMETRICS_H
+
+#include <time.h>
+#include "order.h"
+
+/**
+ * @file rushmetrics.h
+ * @brief Sliding time-window order metrics for the rush-hour screen.
+ *
+ * This header file defines bucketed ring counters over order
+ * timestamps. Each window is a ring of fixed-width buckets with
+ * running sums; advancing time clears only the buckets that fell
+ * out of the window, so recording an order or reading a window
+ * costs O(1) amortised and the queue is never rescanned.
+ *
+ * Windows: 1 minute (60 x 1 s), 15 minutes (90 x 10 s) and
+ * 1 hour (60 x 1 min). Per-item demand uses 1-minute buckets.
+ */
+
+/**
+ * @enum RushSpan
+ * @brief Window lengths that can be queried.
+ */
+typedef enum {
+    RUSH_1_MIN,               /**< Last minute */
+    RUSH_15_MIN,              /**< Last 15 minutes */
+    RUSH_1_HOUR,              /**< Last hour */
+    RUSH_SPAN_COUNT           /**< Number of windows */
+} RushSpan;
+
+/** Number of 1-minute buckets kept per menu item. */
+#define RUSH_ITEM_BUCKETS 60
+
+/**
+ * @struct RushWindow
+ * @brief Ring of time buckets with running totals.
+ */
+typedef struct {
+    int bucketSeconds;        /**< Width of one bucket */
+    int bucketCount;          /**< Number of buckets in the ring */
+    long *orders;             /**< Orders per bucket */
+    double *revenue;          /**< Revenue per bucket */
+    long totalOrders;         /**< Sum over the live buckets */
+    double totalRevenue;      /**< Sum over the live buckets */
+    long latestSlot;          /**< Newest bucket number (time / width) */
+} RushWindow;
+
+/**
+ * @struct ItemDemand
+ * @brief Per-minute unit counts of one menu item over the last hour.
+ */
+typedef struct {
+    int menuId;                        /**< Menu item ID, 0 if the slot is free */
+    long units[RUSH_ITEM_BUCKETS];     /**< Units per minute bucket */
+    long totalUnits;                   /**< Sum over the live buckets */
+    long latestSlot;                   /**< Newest minute number */
+} ItemDemand;
+
+/**
+ * @struct RushMetrics
+ * @brief All rush-hour windows plus per-item demand.
+ */
+typedef struct {
+    RushWindow windows[RUSH_SPAN_COUNT]; /**< One window per RushSpan */
+    ItemDemand *items;        /**< Open-addressing table keyed by menu ID */
+    int capacity;             /**< Number of item slots (power of two) */
+    int count;                /**< Items with demand recorded */
+} RushMetrics;
+
+/**
+ * @struct RushRates
+ * @brief Result of a window query.
+ */
+typedef struct {
+    long orders;              /**< Orders in the window */
+    double revenue;           /**< Revenue in the window */
+    double ordersPerMinute;   /**< Orders divided by window minutes */
+    double revenuePerMinute;  /**< Revenue divided by window minutes */
+} RushRates;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Creates the windows and starts observing the order queue.
+ *
+ * @return Pointer to the new RushMetrics, or NULL on failure.
+ */
+RushMetrics* createRushMetrics(void);
+
+/**
+ * @brief Counts (sign = 1) or removes (sign = -1) an order at its orderTime.
+ *
+ * Orders older than a window are ignored by that window.
+ *
+ * @param rush  Pointer to the metrics.
+ * @param order Order to account for.
+ * @param sign  1 to add, -1 to remove.
+ */
+void recordRushOrder(RushMetrics *rush, const Order *order, int sign);
+
+/**
+ * @brief Reads one window as of a given time.
+ *
+ * @param rush Pointer to the metrics.
+ * @param span Window to read.
+ * @param now  Current time.
+ *
+ * @return Totals and per-minute rates.
+ */
+RushRates getRushRates(RushMetrics *rush, RushSpan span, time_t now);
+
+/**
+ * @brief Returns units of one item ordered within a window.
+ *
+ * The 1-minute span reports the current minute bucket.
+ *
+ * @param rush   Pointer to the metrics.
+ * @param menuId Menu item ID.
+ * @param span   Window to read.
+ * @param now    Current time.
+ *
+ * @return Units ordered.
+ */
+long getItemDemand(RushMetrics *rush, int menuId, RushSpan span, time_t now);
+
+/**
+ * @brief Prints the window rates and the per-minute curve of the last 15 minutes.
+ *
+ * @param rush Pointer to the metrics.
+ * @param now  Current time.
+ */
+void displayRushMetrics(RushMetrics *rush, time_t now);
+
+/**
+ * @brief Stops observing orders and frees the metrics.
+ *
+ * @param rush Pointer to the metrics.
+ */
+void freeRushMetrics(RushMetrics *rush);
+
+#endif /* RUSHMETRICS_H */
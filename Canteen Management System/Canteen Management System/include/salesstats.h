@@ -0,0 +1,135 @@
+#ifndef SALESSTATS_H
+#define SALESSTATS_H
+
+#include "order.h"
+
+/**
+ * @file salesstats.h
+ * @brief Incrementally maintained sales aggregates.
+ *
+ * This header file defines running counters for units and revenue
+ * per menu item and per consumer type. They observe the order queue:
+ * every enqueued order is added and every undone order is subtracted,
+ * so reports never rescan orders. Top-N bestsellers are selected with
+ * a bounded min-heap over the per-item counters.
+ */
+
+/** Number of consumer types (STUDENT, STAFF, FACULTY). */
+#define CONSUMER_TYPE_COUNT 3
+
+/**
+ * @struct ItemSales
+ * @brief Running totals for one menu item.
+ */
+typedef struct {
+    int menuId;               /**< Menu item ID, 0 if the slot is free */
+    char *name;               /**< Item name when it was first sold */
+    long units;               /**< Units sold */
+    double revenue;           /**< Revenue from this item */
+} ItemSales;
+
+/**
+ * @struct SalesTotals
+ * @brief Running totals for a group of orders.
+ */
+typedef struct {
+    long orders;              /**< Number of orders */
+    long units;               /**< Units across all lines */
+    double revenue;           /**< Sum of order totals */
+} SalesTotals;
+
+/**
+ * @enum SalesRanking
+ * @brief Ranking used for bestseller queries.
+ */
+typedef enum {
+    RANK_BY_UNITS,            /**< Most units sold first */
+    RANK_BY_REVENUE           /**< Highest revenue first */
+} SalesRanking;
+
+/**
+ * @struct SalesStats
+ * @brief Hash table of per-item counters plus per-type totals.
+ */
+typedef struct {
+    ItemSales *items;                           /**< Open-addressing table keyed by menu ID */
+    int capacity;                               /**< Number of slots (power of two) */
+    int count;                                  /**< Distinct items sold */
+    SalesTotals byType[CONSUMER_TYPE_COUNT];    /**< Totals per ConsumerType */
+    SalesTotals overall;                        /**< Totals over all orders */
+} SalesStats;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Creates empty sales counters and starts observing orders.
+ *
+ * @return Pointer to the new SalesStats, or NULL on failure.
+ */
+SalesStats* createSalesStats(void);
+
+/**
+ * @brief Adds (sign = 1) or subtracts (sign = -1) one order.
+ *
+ * Called automatically for enqueued and undone orders; exposed
+ * for replaying history into a fresh set of counters.
+ *
+ * @param stats Pointer to the sales counters.
+ * @param order Order to account for.
+ * @param sign  1 to add, -1 to reverse.
+ */
+void recordOrderSales(SalesStats *stats, const Order *order, int sign);
+
+/**
+ * @brief Returns the counters of one menu item.
+ *
+ * @param stats  Pointer to the sales counters.
+ * @param menuId Menu item ID.
+ *
+ * @return Pointer to the counters, or NULL if the item never sold.
+ */
+const ItemSales* getItemSales(const SalesStats *stats, int menuId);
+
+/**
+ * @brief Returns the totals for one consumer type.
+ *
+ * @param stats Pointer to the sales counters.
+ * @param type  Consumer type.
+ *
+ * @return Totals for that type.
+ */
+SalesTotals getConsumerTypeSales(const SalesStats *stats, ConsumerType type);
+
+/**
+ * @brief Selects the top-N items.
+ *
+ * Runs in O(M log N) over M distinct items, independent of the
+ * number of orders.
+ *
+ * @param stats   Pointer to the sales counters.
+ * @param n       Number of items wanted.
+ * @param ranking Units or revenue.
+ * @param out     Output array of at least n entries, best first.
+ *
+ * @return Number of entries written.
+ */
+int topSellers(const SalesStats *stats, int n, SalesRanking ranking, ItemSales *out);
+
+/**
+ * @brief Prints totals per consumer type and the top-N items.
+ *
+ * @param stats Pointer to the sales counters.
+ * @param n     Number of bestsellers to list.
+ */
+void displaySalesReport(const SalesStats *stats, int n);
+
+/**
+ * @brief Stops observing orders and frees the counters.
+ *
+ * @param stats Pointer to the sales counters.
+ */
+void freeSalesStats(SalesStats *stats);
+
+#endif /* SALESSTATS_H */
@@ -0,0 +1,143 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include "order.h"
+
+/**
+ * @file scheduler.h
+ * @brief Priority scheduling of queued orders, with aging.
+ *
+ * This header file defines the kitchen scheduler that picks which
+ * waiting order is started next. Each order gets a priority class from
+ * its consumer type and size, and a deadline of "queued time + the
+ * class's target wait". The order with the earliest deadline is
+ * started first.
+ *
+ * Deadlines give aging for free: an order of a slow class outranks
+ * newer orders of a faster class once it has waited the difference of
+ * the two targets, so no class can starve another. Within one class
+ * deadlines are in arrival order, so each class is a FIFO list and
+ * picking the next order compares only the class heads: scheduling,
+ * starting and cancelling are all O(1) per order.
+ *
+ * The scheduler follows the queue through order observers, so orders
+ * are scheduled when enqueued and dropped when started, served or
+ * undone. Only one scheduler should exist at a time.
+ */
+
+/**
+ * @enum PriorityClass
+ * @brief Scheduling classes, most urgent first.
+ */
+typedef enum {
+    PRIORITY_FACULTY,         /**< Faculty orders of normal size */
+    PRIORITY_STAFF,           /**< Staff orders of normal size */
+    PRIORITY_STUDENT,         /**< Student orders of normal size */
+    PRIORITY_BULK,            /**< Large orders from anyone */
+    PRIORITY_CLASS_COUNT      /**< Number of classes */
+} PriorityClass;
+
+/**
+ * @struct SchedulerConfig
+ * @brief Class targets and the bulk threshold.
+ */
+typedef struct {
+    uint64_t targetNanos[PRIORITY_CLASS_COUNT];  /**< Target wait of each class */
+    int bulkUnits;                               /**< Orders with at least this many units are bulk */
+} SchedulerConfig;
+
+/**
+ * @struct OrderScheduler
+ * @brief One FIFO list of waiting orders per class.
+ *
+ * The lists are linked through the orders' classPrev/classNext.
+ */
+typedef struct {
+    SchedulerConfig config;                  /**< Targets in use */
+    Order *heads[PRIORITY_CLASS_COUNT];      /**< Oldest waiting order of each class */
+    Order *tails[PRIORITY_CLASS_COUNT];      /**< Newest waiting order of each class */
+    int counts[PRIORITY_CLASS_COUNT];        /**< Waiting orders per class */
+    int count;                               /**< Waiting orders in all classes */
+} OrderScheduler;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Returns the default targets.
+ *
+ * @return Faculty 3 min, staff 6 min, student 10 min, bulk 20 min;
+ *         orders of 10 units or more are bulk.
+ */
+SchedulerConfig defaultSchedulerConfig(void);
+
+/**
+ * @brief Returns the class an order belongs to.
+ *
+ * @param config Targets and bulk threshold.
+ * @param order  The order.
+ *
+ * @return Its priority class.
+ */
+PriorityClass classifyOrder(const SchedulerConfig *config, const Order *order);
+
+/**
+ * @brief Returns the name of a class.
+ *
+ * @param priorityClass The class.
+ *
+ * @return "faculty", "staff", "student" or "bulk".
+ */
+const char* priorityClassName(PriorityClass priorityClass);
+
+/**
+ * @brief Creates a scheduler and starts following the order queue.
+ *
+ * Orders already queued are not scheduled.
+ *
+ * @param config Targets to use, or NULL for the defaults.
+ *
+ * @return Pointer to the new OrderScheduler, or NULL on failure.
+ */
+OrderScheduler* createOrderScheduler(const SchedulerConfig *config);
+
+/**
+ * @brief Adds a waiting order (done automatically on enqueue).
+ *
+ * @param scheduler Pointer to the scheduler.
+ * @param order     Order to schedule.
+ */
+void scheduleOrder(OrderScheduler *scheduler, Order *order);
+
+/**
+ * @brief Drops a waiting order (done automatically on start, serve and undo).
+ *
+ * Does nothing if the order is not scheduled.
+ *
+ * @param scheduler Pointer to the scheduler.
+ * @param order     Order to drop.
+ */
+void unscheduleOrder(OrderScheduler *scheduler, Order *order);
+
+/**
+ * @brief Starts the waiting order with the earliest deadline.
+ *
+ * Removes it from the scheduler and marks it STAGE_STARTED. The order
+ * stays in the queue until it is served.
+ *
+ * @param scheduler Pointer to the scheduler.
+ *
+ * @return The started order, or NULL if nothing is waiting.
+ */
+Order* startScheduledOrder(OrderScheduler *scheduler);
+
+/**
+ * @brief Stops following the queue and frees the scheduler.
+ *
+ * @param scheduler Pointer to the scheduler.
+ */
+void freeOrderScheduler(OrderScheduler *scheduler);
+
+#endif /* SCHEDULER_H */
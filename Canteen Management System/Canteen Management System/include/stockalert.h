@@ -0,0 +1,150 @@
+#ifndef STOCKALERT_H
+#define STOCKALERT_H
+
+#include <time.h>
+#include "menuitem.h"
+
+/**
+ * @file stockalert.h
+ * @brief Per-item demand estimation and restock alerts.
+ *
+ * This header file defines a forecaster that observes stock changes
+ * and keeps an exponentially decayed demand rate per menu item
+ * (units per second with a configurable half-life). From the rate
+ * it predicts the time until the item runs out and raises a restock
+ * alert once, when the prediction drops below a horizon or stock
+ * falls under a minimum. Work is done only on the changed item, so
+ * the menu is never scanned.
+ */
+
+/** Number of undelivered alerts kept when no callback is set. */
+#define RESTOCK_QUEUE_SIZE 32
+
+/**
+ * @enum RestockReason
+ * @brief Why an alert was raised.
+ */
+typedef enum {
+    RESTOCK_LOW_QUANTITY,         /**< Stock is at or below the minimum */
+    RESTOCK_PREDICTED_STOCKOUT    /**< Predicted to run out within the horizon */
+} RestockReason;
+
+/**
+ * @struct RestockAlert
+ * @brief A restock alert for one item.
+ */
+typedef struct {
+    int menuId;                   /**< Menu item ID */
+    char name[32];                /**< Item name (truncated) */
+    int quantity;                 /**< Stock when the alert fired */
+    double unitsPerMinute;        /**< Estimated demand */
+    double minutesToStockout;     /**< Predicted time left, negative if unknown */
+    RestockReason reason;         /**< Why the alert fired */
+    time_t when;                  /**< Time of the alert */
+} RestockAlert;
+
+/**
+ * @brief Callback receiving restock alerts as they fire.
+ *
+ * @param alert   The alert.
+ * @param context User pointer given to the forecaster.
+ */
+typedef void (*RestockCallback)(const RestockAlert *alert, void *context);
+
+/**
+ * @struct ItemRate
+ * @brief Demand state of one menu item.
+ */
+typedef struct {
+    int menuId;                   /**< Menu item ID, 0 if the slot is free */
+    double rate;                  /**< Decayed demand in units per second */
+    time_t updated;               /**< Time the rate was last decayed */
+    int alerted;                  /**< 1 while an alert is outstanding */
+} ItemRate;
+
+/**
+ * @struct StockForecaster
+ * @brief Demand rates for all items plus alert settings.
+ */
+typedef struct {
+    ItemRate *items;              /**< Open-addressing table keyed by menu ID */
+    int capacity;                 /**< Number of slots (power of two) */
+    int count;                    /**< Items tracked */
+    double tau;                   /**< Decay time constant in seconds */
+    double horizonMinutes;        /**< Alert when stockout is predicted sooner */
+    int minQuantity;              /**< Alert when stock is at or below this */
+    int changingFrom;             /**< Quantity seen in the last STOCK_CHANGING */
+    RestockCallback callback;     /**< Alert callback, or NULL to queue */
+    void *context;                /**< Passed to the callback */
+    RestockAlert pending[RESTOCK_QUEUE_SIZE]; /**< Queued alerts */
+    int pendingHead;              /**< Index of the oldest queued alert */
+    int pendingCount;             /**< Number of queued alerts */
+} StockForecaster;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Creates a forecaster and starts observing stock changes.
+ *
+ * @param halfLifeMinutes Half-life of the demand average.
+ * @param horizonMinutes  Alert when stockout is predicted within this time.
+ * @param minQuantity     Alert when stock is at or below this amount.
+ * @param callback        Alert callback, or NULL to queue alerts.
+ * @param context         User pointer passed to the callback.
+ *
+ * @return Pointer to the new StockForecaster, or NULL on failure.
+ */
+StockForecaster* createStockForecaster(double halfLifeMinutes, double horizonMinutes,
+                                       int minQuantity, RestockCallback callback,
+                                       void *context);
+
+/**
+ * @brief Returns the current demand estimate of an item.
+ *
+ * @param forecaster Pointer to the forecaster.
+ * @param menuId     Menu item ID.
+ * @param now        Current time.
+ *
+ * @return Units per minute.
+ */
+double getDemandRate(StockForecaster *forecaster, int menuId, time_t now);
+
+/**
+ * @brief Predicts how long the current stock of an item will last.
+ *
+ * @param forecaster Pointer to the forecaster.
+ * @param item       Menu item.
+ * @param now        Current time.
+ *
+ * @return Minutes until stockout, or a negative value if there is no demand.
+ */
+double predictStockout(StockForecaster *forecaster, const Menu *item, time_t now);
+
+/**
+ * @brief Takes the oldest queued alert.
+ *
+ * @param forecaster Pointer to the forecaster.
+ * @param alert      Receives the alert.
+ *
+ * @return 1 if an alert was returned, 0 if the queue is empty.
+ */
+int pollRestockAlert(StockForecaster *forecaster, RestockAlert *alert);
+
+/**
+ * @brief Prints demand and predicted stockout for every menu item.
+ *
+ * @param forecaster Pointer to the forecaster.
+ * @param head       Pointer to the head of the menu list.
+ */
+void displayStockForecast(StockForecaster *forecaster, Menu *head);
+
+/**
+ * @brief Stops observing the menu and frees the forecaster.
+ *
+ * @param forecaster Pointer to the forecaster.
+ */
+void freeStockForecaster(StockForecaster *forecaster);
+
+#endif /* STOCKALERT_H */
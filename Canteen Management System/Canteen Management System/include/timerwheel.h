@@ -0,0 +1,130 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <stdint.h>
+
+/**
+ * @file timerwheel.h
+ * @brief Hierarchical timing wheel for large numbers of timers.
+ *
+ * This header file defines a four-level timing wheel with 64 slots per
+ * level. Level 0 holds timers due within 64 ticks, level 1 within 64^2
+ * ticks, and so on; each time a level wraps, the next slot of the level
+ * above is cascaded down. Arming and cancelling a timer are O(1), and
+ * each timer is moved at most once per level before it fires, so
+ * expiry is O(1) per timer as well: nothing ever scans the pending
+ * timers for due ones.
+ *
+ * With one-second ticks the wheel reaches 194 days; later deadlines
+ * wait in the last slot and are cascaded again until they are due.
+ *
+ * Timers are intrusive: embed a TimerNode in the timed object and
+ * recover the object in the callback. The wheel is not thread-safe.
+ */
+
+#define WHEEL_LEVELS 4            /**< Levels of the wheel */
+#define WHEEL_SLOT_BITS 6         /**< log2 of the slots per level */
+#define WHEEL_SLOTS (1 << WHEEL_SLOT_BITS) /**< Slots per level */
+
+/**
+ * @struct TimerNode
+ * @brief A timer, linked into one wheel slot while armed.
+ *
+ * A zeroed TimerNode is not armed.
+ */
+typedef struct TimerNode {
+    uint64_t expiresTick;         /**< Tick the timer fires at */
+    struct TimerNode *prev;       /**< Previous timer in the slot */
+    struct TimerNode *next;       /**< Next timer in the slot */
+} TimerNode;
+
+/**
+ * @brief Called when a timer fires.
+ *
+ * The timer is already disarmed; the callback may arm it again, arm or
+ * cancel other timers, or free the object that holds it.
+ *
+ * @param timer   The timer that fired.
+ * @param context Value given to initTimingWheel().
+ */
+typedef void (*TimerCallback)(TimerNode *timer, void *context);
+
+/**
+ * @struct TimingWheel
+ * @brief Slots of all levels plus the current tick.
+ */
+typedef struct {
+    uint64_t tickNanos;                          /**< Length of a tick */
+    uint64_t currentTick;                        /**< Last tick processed */
+    TimerNode slots[WHEEL_LEVELS][WHEEL_SLOTS];  /**< List heads of each slot */
+    long count;                                  /**< Armed timers */
+    TimerCallback fire;                          /**< Expiry callback */
+    void *context;                               /**< Passed to fire */
+} TimingWheel;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Initialises an empty wheel.
+ *
+ * @param wheel     Wheel to initialise.
+ * @param tickNanos Resolution; timers fire on the first tick at or after their deadline.
+ * @param nowNanos  Current monotonic time.
+ * @param fire      Expiry callback.
+ * @param context   Passed to fire.
+ */
+void initTimingWheel(TimingWheel *wheel, uint64_t tickNanos, uint64_t nowNanos,
+                     TimerCallback fire, void *context);
+
+/**
+ * @brief Arms a timer, in O(1).
+ *
+ * A deadline already past fires on the next advance.
+ *
+ * @param wheel         Pointer to the wheel.
+ * @param timer         A timer that is not armed.
+ * @param deadlineNanos Monotonic time to fire at.
+ */
+void armTimer(TimingWheel *wheel, TimerNode *timer, uint64_t deadlineNanos);
+
+/**
+ * @brief Disarms a timer, in O(1).
+ *
+ * Does nothing if the timer is not armed.
+ *
+ * @param wheel Pointer to the wheel.
+ * @param timer The timer.
+ */
+void cancelTimer(TimingWheel *wheel, TimerNode *timer);
+
+/**
+ * @brief Tells whether a timer is armed.
+ *
+ * @param timer The timer.
+ *
+ * @return 1 if armed, 0 otherwise.
+ */
+int isTimerArmed(const TimerNode *timer);
+
+/**
+ * @brief Fires every timer due by a given time.
+ *
+ * @param wheel    Pointer to the wheel.
+ * @param nowNanos Current monotonic time.
+ *
+ * @return Number of timers fired.
+ */
+long advanceTimingWheel(TimingWheel *wheel, uint64_t nowNanos);
+
+/**
+ * @brief Fires every armed timer now, e.g. to release what they guard at shutdown.
+ *
+ * @param wheel Pointer to the wheel.
+ *
+ * @return Number of timers fired.
+ */
+long fireAllTimers(TimingWheel *wheel);
+
+#endif /* TIMERWHEEL_H */
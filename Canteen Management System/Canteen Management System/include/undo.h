@@ -21,11 +21,13 @@
  * @struct OrderStackNode
  * @brief Node of the undo stack.
  *
- * Each node stores a pointer to an order and links to
- * the next node in the stack.
+ * Each node stores a pointer to an order and links to the
+ * nodes above and below it. The order points back at its node,
+ * so an order leaving the queue is dropped from the stack in O(1).
  */
 typedef struct OrderStackNode {
     Order *order;                 /**< Pointer to the last placed order */
+    struct OrderStackNode *prev;  /**< Node above this one, NULL at the top */
     struct OrderStackNode *next;  /**< Pointer to the next stack node */
 } OrderStackNode;
 
@@ -73,11 +75,26 @@ void pushOrder(OrderStack *stack, Order *order);
  */
 Order* popOrder(OrderStack *stack);
 
+/**
+ * @brief Undoes the most recently placed order without printing.
+ *
+ * Same as undoLastOrder(), for callers with their own reporting.
+ *
+ * @param stack Pointer to the undo stack.
+ * @param queue Pointer to the order queue.
+ *
+ * @return ID of the undone order, -1 if the stack is empty, -2 if
+ *         the order had already left the queue, or -3 if the kitchen
+ *         has started it (the order is left as it is).
+ */
+int revertLastOrder(OrderStack *stack, OrderQueue *queue);
+
 /**
  * @brief Undoes the most recently placed order.
  *
  * Restores stock levels, removes the order from the order queue,
- * and frees the order memory.
+ * and frees the order memory. An order the kitchen has started
+ * (see markOrderStage()) can no longer be undone.
  *
  * @param stack Pointer to the undo stack.
  * @param queue Pointer to the order queue.
@@ -86,6 +103,20 @@ Order* popOrder(OrderStack *stack);
  */
 int undoLastOrder(OrderStack *stack, OrderQueue *queue);
 
+/**
+ * @brief Removes an order from the undo stack without undoing it.
+ *
+ * Used when an order leaves the queue (e.g. it was served), so
+ * that undo can no longer reach an order that has been freed.
+ * Runs in O(1) through the order's undoNode.
+ *
+ * @param stack Pointer to the undo stack.
+ * @param order Order to forget.
+ *
+ * @return 0 if the order was on the stack, -1 otherwise.
+ */
+int forgetOrder(OrderStack *stack, Order *order);
+
 /**
  * @brief Frees the undo stack.
  *
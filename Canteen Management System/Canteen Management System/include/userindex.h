@@ -0,0 +1,204 @@
+#ifndef USERINDEX_H
+#define USERINDEX_H
+
+#include <stdint.h>
+#include <time.h>
+#include "user.h"
+
+/**
+ * @file userindex.h
+ * @brief Hashed user lookup and login session cache.
+ *
+ * This header file defines an open-addressing hash index over the
+ * user list, keyed by username and by UID, which also enforces that
+ * both are unique. A session table maps opaque tokens to logged-in
+ * users so that repeated requests from the same terminal are
+ * validated in O(1) without re-checking credentials.
+ */
+
+/* ===============================
+   User Index
+   =============================== */
+
+/**
+ * @struct UserIndex
+ * @brief Two hash tables (username, UID) pointing into the user list.
+ */
+typedef struct {
+    User **byUsername;        /**< Slots keyed by username */
+    User **byUid;             /**< Slots keyed by UID */
+    int capacity;             /**< Number of slots (power of two) */
+    int count;                /**< Number of indexed users */
+} UserIndex;
+
+/**
+ * @brief Builds an index over an existing user list.
+ *
+ * Users whose username or UID is already taken are reported
+ * and left out of the index.
+ *
+ * @param head Pointer to the head of the user list.
+ *
+ * @return Pointer to the new UserIndex, or NULL on failure.
+ */
+UserIndex* createUserIndex(User *head);
+
+/**
+ * @brief Adds a user to the list if its username and UID are unique.
+ *
+ * On a conflict the user is freed and nothing is added.
+ *
+ * @param head  Pointer to the head pointer of the user list.
+ * @param index Pointer to the user index.
+ * @param user  Newly created user.
+ *
+ * @return 0 on success, -1 on duplicate or failure.
+ */
+int registerUser(User **head, UserIndex *index, User *user);
+
+/**
+ * @brief Finds a user by username in O(1).
+ *
+ * @param index    Pointer to the user index.
+ * @param username Username to look up.
+ *
+ * @return Pointer to the User, or NULL if not found.
+ */
+User* findIndexedUser(UserIndex *index, const char *username);
+
+/**
+ * @brief Finds a user by UID in O(1).
+ *
+ * @param index Pointer to the user index.
+ * @param uid   UID to look up.
+ *
+ * @return Pointer to the User, or NULL if not found.
+ */
+User* findUserByUid(UserIndex *index, const char *uid);
+
+/**
+ * @brief Authenticates a user through the index.
+ *
+ * @param index    Pointer to the user index.
+ * @param username Login username.
+ * @param password Login password.
+ *
+ * @return Pointer to the authenticated User, or NULL on failure.
+ */
+User* loginIndexed(UserIndex *index, const char *username, const char *password);
+
+/**
+ * @brief Edits a user and keeps the index consistent.
+ *
+ * Fails without changing anything if the new username belongs
+ * to another user.
+ *
+ * @param index       Pointer to the user index.
+ * @param uid         UID of the user to edit.
+ * @param newName     New name of the user.
+ * @param newUsername New username.
+ * @param newPassword New password.
+ * @param newRole     New role.
+ *
+ * @return 0 on success, -1 if the user is missing or the username is taken.
+ */
+int editIndexedUser(UserIndex *index, const char *uid, const char *newName,
+                    const char *newUsername, const char *newPassword, Role newRole);
+
+/**
+ * @brief Frees the index. Users themselves are not freed.
+ *
+ * @param index Pointer to the user index.
+ */
+void freeUserIndex(UserIndex *index);
+
+/* ===============================
+   Session Table
+   =============================== */
+
+/** Number of session slots; at most half of them are used. */
+#define SESSION_TABLE_SIZE 256
+
+/**
+ * @struct Session
+ * @brief An authenticated terminal.
+ */
+typedef struct {
+    uint64_t token;           /**< Opaque session token, 0 if the slot is free */
+    User *user;               /**< Logged-in user */
+    int terminalId;           /**< Terminal the session is bound to */
+    time_t expires;           /**< Expiry time, extended on each use */
+} Session;
+
+/**
+ * @struct SessionTable
+ * @brief Open-addressing table of active sessions keyed by token.
+ */
+typedef struct {
+    Session slots[SESSION_TABLE_SIZE]; /**< Session slots */
+    int count;                /**< Number of active sessions */
+    int ttlSeconds;           /**< Idle time before a session expires */
+} SessionTable;
+
+/**
+ * @brief Creates an empty session table.
+ *
+ * @param ttlSeconds Idle timeout of a session.
+ *
+ * @return Pointer to the new SessionTable, or NULL on failure.
+ */
+SessionTable* createSessionTable(int ttlSeconds);
+
+/**
+ * @brief Opens a session for an authenticated user.
+ *
+ * Tokens are drawn from the operating system's random source, so they
+ * cannot be predicted from earlier tokens or the start time. Expiry
+ * follows clockTime(). When the table is full, expired sessions are
+ * dropped before a new one is refused.
+ *
+ * @param table      Pointer to the session table.
+ * @param user       User returned by a successful login.
+ * @param terminalId Terminal the user logged in from.
+ *
+ * @return The session token, or 0 if the table is full or no random source is available.
+ */
+uint64_t openSession(SessionTable *table, User *user, int terminalId);
+
+/**
+ * @brief Validates a session token in O(1).
+ *
+ * Extends the session on success and drops it if it expired.
+ *
+ * @param table      Pointer to the session table.
+ * @param token      Token from openSession().
+ * @param terminalId Terminal presenting the token.
+ *
+ * @return The session's user, or NULL if invalid or expired.
+ */
+User* validateSession(SessionTable *table, uint64_t token, int terminalId);
+
+/**
+ * @brief Ends a session.
+ *
+ * @param table Pointer to the session table.
+ * @param token Token to revoke.
+ */
+void closeSession(SessionTable *table, uint64_t token);
+
+/**
+ * @brief Ends every session of a user, e.g. after a password change.
+ *
+ * @param table Pointer to the session table.
+ * @param user  User whose sessions are revoked.
+ */
+void closeUserSessions(SessionTable *table, const User *user);
+
+/**
+ * @brief Frees the session table.
+ *
+ * @param table Pointer to the session table.
+ */
+void freeSessionTable(SessionTable *table);
+
+#endif /* USERINDEX_H */
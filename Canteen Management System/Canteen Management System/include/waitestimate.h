@@ -0,0 +1,129 @@
+#ifndef WAITESTIMATE_H
+#define WAITESTIMATE_H
+
+#include <stdint.h>
+#include "order.h"
+
+/**
+ * @file waitestimate.h
+ * @brief Constant-time "ready in ~N min" estimates.
+ *
+ * This header file defines the wait estimator. It keeps a preparation
+ * time per unit of each menu item, learned from how long the kitchen
+ * actually takes (started -> ready), and running sums of the work in
+ * the queue:
+ *  - placed:  estimated work of every order placed,
+ *  - drained: work of the orders that stopped waiting,
+ *  - active:  work, start-time sum and count of orders being prepared.
+ *
+ * Each order remembers its own work and the placed sum when it was
+ * queued, so the work still ahead of it is that sum minus the drained
+ * sum. Both estimates below are O(1) and refresh themselves as the
+ * queue drains; only costing a new basket walks its own lines.
+ *
+ * The estimate assumes FIFO preparation on a fixed number of stations.
+ * Undoing the newest order takes its work back out of the placed sum;
+ * other early removals count as drained.
+ *
+ * The estimator follows the queue through order observers. Only one
+ * estimator should exist at a time.
+ */
+
+/** Kitchen runs shorter than this are serves without a kitchen and are not learned from. */
+#define ETA_MIN_SAMPLE_NANOS 1000000000ULL
+
+/** Share of a kitchen run's estimation error corrected per run. */
+#define ETA_LEARNING_RATE 0.2
+
+/**
+ * @struct PrepEstimate
+ * @brief Learned preparation time of one menu item.
+ */
+typedef struct {
+    int menuId;               /**< Menu item ID */
+    int used;                 /**< 1 if the slot holds an item */
+    double unitNanos;         /**< Preparation time per unit */
+} PrepEstimate;
+
+/**
+ * @struct WaitEstimator
+ * @brief Item estimates plus the queue's work sums.
+ */
+typedef struct {
+    int stations;             /**< Orders prepared in parallel */
+    double defaultUnitNanos;  /**< Estimate for items not seen yet */
+    PrepEstimate *items;      /**< Open-addressed table by menu ID */
+    int itemCapacity;         /**< Table slots (a power of two) */
+    int itemCount;            /**< Items in the table */
+    uint64_t placedWork;      /**< Work of all orders placed */
+    uint64_t drainedWork;     /**< Work that stopped waiting */
+    uint64_t activeWork;      /**< Work of orders being prepared */
+    uint64_t activeStartSum;  /**< Sum of their start times */
+    int activeCount;          /**< Orders being prepared */
+    long samples;             /**< Kitchen runs learned from */
+} WaitEstimator;
+
+/* ===============================
+   Function Declarations
+   =============================== */
+
+/**
+ * @brief Creates an estimator and starts following the order queue.
+ *
+ * Orders already queued are not counted.
+ *
+ * @param stations         Orders the kitchen prepares in parallel.
+ * @param defaultUnitNanos Preparation time per unit before anything is learned.
+ *
+ * @return Pointer to the new WaitEstimator, or NULL on failure.
+ */
+WaitEstimator* createWaitEstimator(int stations, uint64_t defaultUnitNanos);
+
+/**
+ * @brief Returns the learned preparation time per unit of an item.
+ *
+ * @param estimator Pointer to the estimator.
+ * @param menuId    Menu item ID.
+ *
+ * @return Nanoseconds per unit.
+ */
+uint64_t itemPrepNanos(const WaitEstimator *estimator, int menuId);
+
+/**
+ * @brief Estimates the preparation time of a basket.
+ *
+ * @param estimator Pointer to the estimator.
+ * @param items     Lines of the basket.
+ *
+ * @return Estimated nanoseconds of kitchen work.
+ */
+uint64_t estimateBasketWork(const WaitEstimator *estimator, const OrderItem *items);
+
+/**
+ * @brief Estimates when a basket would be ready if placed now.
+ *
+ * @param estimator Pointer to the estimator.
+ * @param items     Lines of the basket.
+ *
+ * @return Nanoseconds from now.
+ */
+uint64_t estimateBasketReadyIn(const WaitEstimator *estimator, const OrderItem *items);
+
+/**
+ * @brief Estimates when a queued order will be ready, in O(1).
+ *
+ * @param estimator Pointer to the estimator.
+ * @param order     Order placed while the estimator was running.
+ *
+ * @return Nanoseconds from now, 0 if it is ready.
+ */
+uint64_t estimateOrderReadyIn(const WaitEstimator *estimator, const Order *order);
+
+/**
+ * @brief Stops following the queue and frees the estimator.
+ *
+ * @param estimator Pointer to the estimator.
+ */
+void freeWaitEstimator(WaitEstimator *estimator);
+
+#endif /* WAITESTIMATE_H */
@@ -20,7 +20,7 @@ FOR %%f IN ("%SRC_PATH%\*.c") DO (
 
 REM Compile all files with include path
 echo Compiling Canteen Management System...
-gcc -I"%INCLUDE_PATH%" "%MAIN_FILE%" !FILES! -o "%OUTPUT_EXE%"
+gcc -I"%INCLUDE_PATH%" "%MAIN_FILE%" !FILES! -o "%OUTPUT_EXE%" -pthread
 
 IF %ERRORLEVEL% EQU 0 (
     echo Compilation successful!
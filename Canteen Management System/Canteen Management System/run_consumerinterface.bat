@@ -5,7 +5,7 @@ REM Set include path
 set INCLUDE_PATH=C:\Users\RAYHAN RIJVE\Desktop\DSA Project\Canteen Management System\include
 
 REM Compile consumer interface with all source files
-gcc -I"%INCLUDE_PATH%" consumerInterface.c src\*.c -o ConsumerInterface.exe
+gcc -I"%INCLUDE_PATH%" consumerInterface.c src\*.c -o ConsumerInterface.exe -pthread
 
 if %errorlevel% neq 0 (
     echo Compilation failed!
@@ -0,0 +1,359 @@
+#include "../include/archive.h"
+#include "../include/ordertrace.h"
+#include "../include/recorder.h"
+#include "../include/memtrack.h"
+
+/* ===============================
+   Consumer dictionary
+   =============================== */
+
+static uint32_t hashString(const char *s){
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int findSlot(const OrderArchive *archive, const char *uid){
+    int mask = archive->slotCapacity - 1;
+    int i = (int)(hashString(uid) & (uint32_t)mask);
+    while (archive->consumerSlots[i] != 0 &&
+           strcmp(archive->consumerUids[archive->consumerSlots[i] - 1], uid) != 0) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+static int growDictionary(OrderArchive *archive){
+    int capacity = archive->consumerCapacity ? archive->consumerCapacity * 2 : 16;
+    char **uids = (char **)memRealloc(MEM_ARCHIVE, archive->consumerUids, capacity * sizeof(char *));
+    if (!uids) return -1;
+    archive->consumerUids = uids;
+    char **names = (char **)memRealloc(MEM_ARCHIVE, archive->consumerNames, capacity * sizeof(char *));
+    if (!names) return -1;
+    archive->consumerNames = names;
+    archive->consumerCapacity = capacity;
+
+    /* keep the hash table at most half full */
+    int32_t *slots = (int32_t *)memCalloc(MEM_ARCHIVE, capacity * 2, sizeof(int32_t));
+    if (!slots) return -1;
+    memFree(archive->consumerSlots);
+    archive->consumerSlots = slots;
+    archive->slotCapacity = capacity * 2;
+    for (int h = 0; h < archive->consumerCount; h++) {
+        archive->consumerSlots[findSlot(archive, archive->consumerUids[h])] = h + 1;
+    }
+    return 0;
+}
+
+static int32_t consumerHandle(OrderArchive *archive, const char *uid, const char *name){
+    if (archive->consumerCount == archive->consumerCapacity && growDictionary(archive) != 0) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return -1;
+    }
+    int slot = findSlot(archive, uid);
+    if (archive->consumerSlots[slot] != 0) {
+        return archive->consumerSlots[slot] - 1;
+    }
+    int32_t handle = archive->consumerCount++;
+    archive->consumerUids[handle] = memStrdup(MEM_ARCHIVE, uid);
+    archive->consumerNames[handle] = memStrdup(MEM_ARCHIVE, name);
+    archive->consumerSlots[slot] = handle + 1;
+    return handle;
+}
+
+/* ===============================
+   Segments
+   =============================== */
+
+static void freeSegment(ArchiveSegment *seg){
+    if (!seg) return;
+    memFree(seg->times);
+    memFree(seg->orderIds);
+    memFree(seg->consumers);
+    memFree(seg->consumerTypes);
+    memFree(seg->totals);
+    memFree(seg->lineStart);
+    memFree(seg->menuIds);
+    memFree(seg->quantities);
+    memFree(seg->unitPrices);
+    memFree(seg);
+}
+
+#define GROW_COLUMN(column, capacity) do { \
+        void *grown = memRealloc(MEM_ARCHIVE, (column), (capacity) * sizeof(*(column))); \
+        if (!grown) return -1; \
+        (column) = grown; \
+    } while (0)
+
+static int reserveOrders(ArchiveSegment *seg, int extra){
+    if (seg->count + extra <= seg->capacity) return 0;
+    int capacity = seg->capacity ? seg->capacity * 2 : 64;
+    while (capacity < seg->count + extra) capacity *= 2;
+    GROW_COLUMN(seg->times, capacity);
+    GROW_COLUMN(seg->orderIds, capacity);
+    GROW_COLUMN(seg->consumers, capacity);
+    GROW_COLUMN(seg->consumerTypes, capacity);
+    GROW_COLUMN(seg->totals, capacity);
+    GROW_COLUMN(seg->lineStart, capacity + 1);
+    seg->capacity = capacity;
+    return 0;
+}
+
+static int reserveLines(ArchiveSegment *seg, int extra){
+    if (seg->lineCount + extra <= seg->lineCapacity) return 0;
+    int capacity = seg->lineCapacity ? seg->lineCapacity * 2 : 128;
+    while (capacity < seg->lineCount + extra) capacity *= 2;
+    GROW_COLUMN(seg->menuIds, capacity);
+    GROW_COLUMN(seg->quantities, capacity);
+    GROW_COLUMN(seg->unitPrices, capacity);
+    seg->lineCapacity = capacity;
+    return 0;
+}
+
+/* Index of the first segment whose day is >= day */
+static int lowerSegment(const OrderArchive *archive, long day){
+    int lo = 0, hi = archive->segmentCount;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (archive->segments[mid]->day < day) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static ArchiveSegment* segmentFor(OrderArchive *archive, long day){
+    int pos = lowerSegment(archive, day);
+    if (pos < archive->segmentCount && archive->segments[pos]->day == day) {
+        return archive->segments[pos];
+    }
+
+    if (archive->segmentCount == archive->segmentCapacity) {
+        int capacity = archive->segmentCapacity ? archive->segmentCapacity * 2 : 8;
+        ArchiveSegment **segments = (ArchiveSegment **)memRealloc(MEM_ARCHIVE, archive->segments,
+                                                               capacity * sizeof(ArchiveSegment *));
+        if (!segments) return NULL;
+        archive->segments = segments;
+        archive->segmentCapacity = capacity;
+    }
+    ArchiveSegment *seg = (ArchiveSegment *)memCalloc(MEM_ARCHIVE, 1, sizeof(ArchiveSegment));
+    if (!seg) return NULL;
+    seg->day = day;
+    if (reserveOrders(seg, 1) != 0) {
+        freeSegment(seg);
+        return NULL;
+    }
+    seg->lineStart[0] = 0;
+
+    memmove(&archive->segments[pos + 1], &archive->segments[pos],
+            (archive->segmentCount - pos) * sizeof(ArchiveSegment *));
+    archive->segments[pos] = seg;
+    archive->segmentCount++;
+    return seg;
+}
+
+/* Index of the first row with time >= t (lower) or > t (upper) */
+static int searchTimes(const ArchiveSegment *seg, time_t t, int upper){
+    int lo = 0, hi = seg->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (seg->times[mid] < t || (upper && seg->times[mid] == t)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* ===============================
+   Public API
+   =============================== */
+
+OrderArchive* createOrderArchive(void){
+    OrderArchive *archive = (OrderArchive *)memCalloc(MEM_ARCHIVE, 1, sizeof(OrderArchive));
+    if (!archive) {
+        fprintf(stderr, "Memory allocation failed\n");
+    }
+    return archive;
+}
+
+int archiveOrder(OrderArchive *archive, const Order *order){
+    int lines = 0;
+    for (OrderItem *line = order->items; line != NULL; line = line->next) lines++;
+
+    ArchiveSegment *seg = segmentFor(archive, (long)(order->orderTime / ARCHIVE_DAY_SECONDS));
+    int32_t handle = consumerHandle(archive, order->consumerUID, order->consumerName);
+    if (!seg || handle < 0 || reserveOrders(seg, 1) != 0 || reserveLines(seg, lines) != 0) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return -1;
+    }
+
+    /* orders normally arrive in time order; otherwise shift later rows up */
+    int row = searchTimes(seg, order->orderTime, 1);
+    int firstLine = seg->lineStart[row];
+    int laterRows = seg->count - row;
+    int laterLines = seg->lineCount - firstLine;
+    if (laterRows > 0) {
+        memmove(&seg->times[row + 1], &seg->times[row], laterRows * sizeof(time_t));
+        memmove(&seg->orderIds[row + 1], &seg->orderIds[row], laterRows * sizeof(uint16_t));
+        memmove(&seg->consumers[row + 1], &seg->consumers[row], laterRows * sizeof(int32_t));
+        memmove(&seg->consumerTypes[row + 1], &seg->consumerTypes[row], laterRows * sizeof(uint8_t));
+        memmove(&seg->totals[row + 1], &seg->totals[row], laterRows * sizeof(float));
+        memmove(&seg->menuIds[firstLine + lines], &seg->menuIds[firstLine], laterLines * sizeof(int32_t));
+        memmove(&seg->quantities[firstLine + lines], &seg->quantities[firstLine], laterLines * sizeof(int32_t));
+        memmove(&seg->unitPrices[firstLine + lines], &seg->unitPrices[firstLine], laterLines * sizeof(float));
+    }
+    for (int r = seg->count; r >= row; r--) {
+        seg->lineStart[r + 1] = seg->lineStart[r] + lines;
+    }
+
+    seg->times[row] = order->orderTime;
+    seg->orderIds[row] = order->orderId;
+    seg->consumers[row] = handle;
+    seg->consumerTypes[row] = (uint8_t)order->consumerType;
+    seg->totals[row] = order->totalAmount;
+    int l = firstLine;
+    for (OrderItem *line = order->items; line != NULL; line = line->next, l++) {
+        seg->menuIds[l] = line->menuItem->id;
+        seg->quantities[l] = line->quantity;
+        seg->unitPrices[l] = line->unitPrice;
+    }
+    seg->count++;
+    seg->lineCount += lines;
+    archive->totalOrders++;
+    return 0;
+}
+
+int serveNextOrder(OrderQueue *queue, OrderStack *stack, OrderArchive *archive){
+    /* first ready, first handed over, whatever the queue position */
+    Order *oldest = NULL;
+    for (Order *order = queue->front; order != NULL; order = order->next) {
+        uint64_t ready = order->stageNanos[STAGE_READY];
+        if (ready != 0 && (!oldest || ready < oldest->stageNanos[STAGE_READY])) oldest = order;
+    }
+    if (!oldest) return -1;
+    return serveOrder(queue, stack, archive, oldest);
+}
+
+int serveOrder(OrderQueue *queue, OrderStack *stack, OrderArchive *archive, Order *order){
+    if (!isQueued(queue, order)) return -1;
+    /* archive first: an order that cannot be stored is kept, not lost */
+    if (archiveOrder(archive, order) != 0) {
+        archive->failedOrders++;
+        return -2;
+    }
+
+    /* served straight from the queue: skipped stages happen now */
+    markOrderStage(order, STAGE_STARTED);
+    markOrderStage(order, STAGE_READY);
+    takeOrder(queue, order);
+    markOrderStage(order, STAGE_COLLECTED);
+    RECORD_OP(recordEvent(RECORD_SERVE));
+
+    int orderId = order->orderId;
+    if (stack) {
+        forgetOrder(stack, order);
+    }
+    freeOrder(order);
+    return orderId;
+}
+
+void archiveSeek(const OrderArchive *archive, time_t from, time_t to, ArchiveCursor *cursor){
+    cursor->archive = archive;
+    cursor->to = to;
+    cursor->segment = lowerSegment(archive, (long)(from / ARCHIVE_DAY_SECONDS));
+    cursor->row = 0;
+    if (cursor->segment < archive->segmentCount) {
+        cursor->row = searchTimes(archive->segments[cursor->segment], from, 0);
+    }
+}
+
+int archiveNext(ArchiveCursor *cursor, ArchivedOrder *out){
+    const OrderArchive *archive = cursor->archive;
+    while (cursor->segment < archive->segmentCount) {
+        const ArchiveSegment *seg = archive->segments[cursor->segment];
+        if (cursor->row >= seg->count) {
+            cursor->segment++;
+            cursor->row = 0;
+            continue;
+        }
+        int r = cursor->row;
+        if (seg->times[r] >= cursor->to) {
+            cursor->segment = archive->segmentCount;
+            return 0;
+        }
+        int first = seg->lineStart[r];
+        out->orderTime = seg->times[r];
+        out->orderId = seg->orderIds[r];
+        out->consumerUID = archive->consumerUids[seg->consumers[r]];
+        out->consumerName = archive->consumerNames[seg->consumers[r]];
+        out->consumerType = (ConsumerType)seg->consumerTypes[r];
+        out->totalAmount = seg->totals[r];
+        out->lineCount = seg->lineStart[r + 1] - first;
+        out->menuIds = &seg->menuIds[first];
+        out->quantities = &seg->quantities[first];
+        out->unitPrices = &seg->unitPrices[first];
+        cursor->row++;
+        return 1;
+    }
+    return 0;
+}
+
+long archiveRangeTotals(const OrderArchive *archive, time_t from, time_t to, double *revenue){
+    long orders = 0;
+    double sum = 0.0;
+    int first = lowerSegment(archive, (long)(from / ARCHIVE_DAY_SECONDS));
+
+    for (int s = first; s < archive->segmentCount; s++) {
+        const ArchiveSegment *seg = archive->segments[s];
+        if (seg->count == 0) continue;
+        if (seg->times[0] >= to) break;
+        int lo = searchTimes(seg, from, 0);
+        int hi = searchTimes(seg, to, 0);
+        orders += hi - lo;
+        for (int r = lo; r < hi; r++) {
+            sum += seg->totals[r];
+        }
+    }
+    if (revenue) *revenue = sum;
+    return orders;
+}
+
+void displayArchiveRange(const OrderArchive *archive, time_t from, time_t to){
+    ArchiveCursor cursor;
+    ArchivedOrder order;
+    int found = 0;
+
+    archiveSeek(archive, from, to, &cursor);
+    while (archiveNext(&cursor, &order)) {
+        printf("\n=== Order ID: %d ===\n", order.orderId);
+        printf("Consumer: %s [%s]\n", order.consumerName, order.consumerUID);
+        printf("Total Amount: %.2f\n", order.totalAmount);
+        printf("Order Time: %s", ctime(&order.orderTime));
+        printf("Items:\n");
+        for (int i = 0; i < order.lineCount; i++) {
+            printf("  - Item %d x%d @ %.2f each\n",
+                   order.menuIds[i], order.quantities[i], order.unitPrices[i]);
+        }
+        found = 1;
+    }
+    if (!found) {
+        printf("No archived orders in this period.\n");
+    }
+}
+
+void freeOrderArchive(OrderArchive *archive){
+    if (!archive) return;
+    for (int s = 0; s < archive->segmentCount; s++) {
+        freeSegment(archive->segments[s]);
+    }
+    for (int h = 0; h < archive->consumerCount; h++) {
+        memFree(archive->consumerUids[h]);
+        memFree(archive->consumerNames[h]);
+    }
+    memFree(archive->segments);
+    memFree(archive->consumerUids);
+    memFree(archive->consumerNames);
+    memFree(archive->consumerSlots);
+    memFree(archive);
+}
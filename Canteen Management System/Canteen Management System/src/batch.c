@@ -0,0 +1,383 @@
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "../include/batch.h"
+#include "../include/metrics.h"
+#include "../include/clocksource.h"
+#include "../include/ordertrace.h"
+
+#define BATCH_READ_BUFFER (1 << 16)
+#define BATCH_MAX_LINES 64
+
+static const char *itemTypes[] = { "FOOD", "DRINK", "DESERT" };
+static const char *consumerTypes[] = { "STUDENT", "STAFF", "FACULTY" };
+
+/* ===============================
+   Tokenizing
+   =============================== */
+
+/* Splits off the next word; NULL at end of line */
+static char* nextToken(char **cursor){
+    char *p = *cursor;
+    while (*p && isspace((unsigned char)*p)) p++;
+    if (!*p) {
+        *cursor = p;
+        return NULL;
+    }
+    char *start = p;
+    while (*p && !isspace((unsigned char)*p)) p++;
+    if (*p) *p++ = '\0';
+    *cursor = p;
+    return start;
+}
+
+/* The rest of the line, trimmed; NULL if empty */
+static char* restOfLine(char **cursor){
+    char *p = *cursor;
+    while (*p && isspace((unsigned char)*p)) p++;
+    size_t length = strlen(p);
+    while (length > 0 && isspace((unsigned char)p[length - 1])) p[--length] = '\0';
+    *cursor = p + length;
+    return length ? p : NULL;
+}
+
+static int parseInt(const char *token, long min, long max, int *out){
+    if (!token) return -1;
+    char *end;
+    errno = 0;
+    long value = strtol(token, &end, 10);
+    if (errno || end == token || *end || value < min || value > max) return -1;
+    *out = (int)value;
+    return 0;
+}
+
+static int parsePrice(const char *token, float *out){
+    if (!token) return -1;
+    char *end;
+    float value = strtof(token, &end);
+    if (end == token || *end || !(value >= 0.0f)) return -1;
+    *out = value;
+    return 0;
+}
+
+/* A type is its number or its name (any case) */
+static int parseType(const char *token, const char **names, int count, int *out){
+    if (!token) return -1;
+    if (parseInt(token, 0, count - 1, out) == 0) return 0;
+    for (int i = 0; i < count; i++) {
+        if (strcasecmp(token, names[i]) == 0) {
+            *out = i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* ===============================
+   Commands
+   =============================== */
+
+/* Each command returns NULL on success or a message describing the failure */
+
+static const char* menuCommand(BatchContext *ctx, char *args){
+    const char *verb = nextToken(&args);
+    int id, type, quantity;
+    float price;
+
+    if (!verb) return "missing menu command";
+    if (strcmp(verb, "add") == 0) {
+        if (parseInt(nextToken(&args), 1, 0x7FFFFFFF, &id) != 0) return "bad menu ID";
+        if (parseType(nextToken(&args), itemTypes, 3, &type) != 0) return "bad item type";
+        if (parsePrice(nextToken(&args), &price) != 0) return "bad price";
+        if (parseInt(nextToken(&args), 0, UINT16_MAX, &quantity) != 0) return "bad quantity";
+        const char *name = restOfLine(&args);
+        if (!name) return "missing name";
+        if (findMenuItem(*ctx->menuHead, id)) return "menu ID already exists";
+        if (ctx->combos && findCombo(ctx->combos, id)) return "menu ID belongs to a combo";
+        addMenuItem(ctx->menuHead, id, name, (ItemType)type, price, (uint16_t)quantity);
+        return NULL;
+    }
+    if (strcmp(verb, "edit") == 0) {
+        if (parseInt(nextToken(&args), 1, 0x7FFFFFFF, &id) != 0) return "bad menu ID";
+        if (parseType(nextToken(&args), itemTypes, 3, &type) != 0) return "bad item type";
+        if (parsePrice(nextToken(&args), &price) != 0) return "bad price";
+        const char *name = restOfLine(&args);
+        if (!name) return "missing name";
+        if (!findMenuItem(*ctx->menuHead, id)) return "no such menu item";
+        editMenuItem(*ctx->menuHead, id, name, (ItemType)type, price);
+        return NULL;
+    }
+    if (strcmp(verb, "restock") == 0) {
+        if (parseInt(nextToken(&args), 1, 0x7FFFFFFF, &id) != 0) return "bad menu ID";
+        if (parseInt(nextToken(&args), -UINT16_MAX, UINT16_MAX, &quantity) != 0) return "bad quantity";
+        Menu *item = findMenuItem(*ctx->menuHead, id);
+        if (!item) return "no such menu item";
+        if (adjustItemQuantity(item, quantity) != 0) return "stock out of range";
+        return NULL;
+    }
+    if (strcmp(verb, "remove") == 0) {
+        if (parseInt(nextToken(&args), 1, 0x7FFFFFFF, &id) != 0) return "bad menu ID";
+        if (removeMenuItem(ctx->menuHead, id) != 0) return "no such menu item";
+        return NULL;
+    }
+    return "unknown menu command";
+}
+
+static const char* consumerCommand(BatchContext *ctx, char *args){
+    const char *verb = nextToken(&args);
+    int type;
+
+    if (!verb) return "missing consumer command";
+    int add = strcmp(verb, "add") == 0;
+    if (!add && strcmp(verb, "edit") != 0) return "unknown consumer command";
+
+    const char *uid = nextToken(&args);
+    if (!uid) return "missing UID";
+    if (parseType(nextToken(&args), consumerTypes, 3, &type) != 0) return "bad consumer type";
+    const char *name = restOfLine(&args);
+    if (!name) return "missing name";
+
+    Consumer *existing = findConsumer(*ctx->consumerHead, uid);
+    if (add) {
+        if (existing) return "consumer already exists";
+        addConsumer(ctx->consumerHead, uid, name, (ConsumerType)type);
+    } else {
+        if (!existing) return "no such consumer";
+        editConsumer(*ctx->consumerHead, uid, name, (ConsumerType)type);
+    }
+    return NULL;
+}
+
+/* Takes the stock of "<menuId>:<qty> ..." lines, all or nothing; an ID may name a combo */
+static const char* takeLines(BatchContext *ctx, char *token, char **args, OrderItem **basket, float *basketTotal){
+    OrderItem *head = NULL, *tail = NULL;
+    float total = 0.0f;
+    int lines = 0;
+    const char *failure = NULL;
+
+    for (; !failure && token != NULL; token = nextToken(args)) {
+        char *colon = strchr(token, ':');
+        int menuId, quantity;
+        if (!colon) {
+            failure = "order line must be <menuId>:<qty>";
+            break;
+        }
+        *colon = '\0';
+        Menu *item;
+        if (parseInt(token, 1, 0x7FFFFFFF, &menuId) != 0) failure = "bad menu ID";
+        else if (parseInt(colon + 1, 1, UINT16_MAX, &quantity) != 0) failure = "bad quantity";
+        else if (++lines > BATCH_MAX_LINES) failure = "too many order lines";
+        else if (!(item = findMenuItem(*ctx->menuHead, menuId))) {
+            Combo *combo = ctx->combos ? findCombo(ctx->combos, menuId) : NULL;
+            if (!combo) failure = "no such menu item";
+            else if (takeCombo(combo, quantity, &head, &tail, &total) != 0) failure = "combo not available";
+        }
+        else {
+            OrderItem *line = createOrderItem(item, quantity);
+            if (!line) {
+                failure = "order line not stored";
+                break;
+            }
+            if (adjustItemQuantity(item, -quantity) != 0) {
+                freeOrderItems(line);
+                failure = "insufficient stock";
+                break;
+            }
+            total += line->unitPrice * line->quantity;
+            if (tail) tail->next = line;
+            else head = line;
+            tail = line;
+        }
+    }
+    if (!failure && !head) failure = "order has no lines";
+    if (failure) {
+        discardOrderItems(head);      /* gives back what earlier lines took */
+        return failure;
+    }
+    *basket = head;
+    *basketTotal = total;
+    return NULL;
+}
+
+static const char* orderCommand(BatchContext *ctx, char *args){
+    const char *uid = nextToken(&args);
+    if (!uid) return "missing UID";
+    Consumer *consumer = findConsumer(*ctx->consumerHead, uid);
+    if (!consumer) return "no such consumer";
+
+    char *token = nextToken(&args);
+    const char *key = NULL;
+    if (token && strncmp(token, "key=", 4) == 0) {
+        key = token + 4;
+        if (*key == '\0' || strlen(key) >= REQUEST_KEY_LENGTH) return "bad idempotency key";
+        if (ctx->requests && findRequest(ctx->requests, key)) return NULL;     /* already placed */
+        token = nextToken(&args);
+    }
+
+    OrderItem *head;
+    float total;
+    const char *failure = takeLines(ctx, token, &args, &head, &total);
+    if (failure) return failure;
+
+    int orderId = ctx->nextOrderId;
+    IntakeResult result = INTAKE_ACCEPTED;
+    Order *order;
+    if (ctx->intake) {
+        order = submitOrder(ctx->intake, ctx->queue, orderId, consumer, head, total, &result);
+    } else {
+        order = enqueueConsumerOrder(ctx->queue, orderId, consumer, head, total);
+    }
+    if (!order) {
+        discardOrderItems(head);        /* gives the stock back */
+        return intakeResultText(result);
+    }
+    ctx->nextOrderId = ctx->nextOrderId % UINT16_MAX + 1;
+    pushOrder(ctx->stack, order);
+    if (key && ctx->requests && rememberRequest(ctx->requests, key, order) != 0) {
+        return "order placed but its key was not stored";
+    }
+    return NULL;
+}
+
+static const char* reserveCommand(BatchContext *ctx, char *args){
+    if (!ctx->reservations) return "pre-orders are not enabled";
+    const char *uid = nextToken(&args);
+    if (!uid) return "missing UID";
+    Consumer *consumer = findConsumer(*ctx->consumerHead, uid);
+    if (!consumer) return "no such consumer";
+    int minutes;
+    if (parseInt(nextToken(&args), 1, 24 * 60, &minutes) != 0) return "bad hold minutes";
+
+    OrderItem *head;
+    float total;
+    const char *failure = takeLines(ctx, nextToken(&args), &args, &head, &total);
+    if (failure) return failure;
+
+    uint64_t deadline = clockNanos() + (uint64_t)minutes * 60000000000ULL;
+    if (!reserveStock(ctx->reservations, consumer, head, total, deadline)) {
+        discardOrderItems(head);
+        return "reservation not stored";
+    }
+    return NULL;
+}
+
+static const char* claimCommand(BatchContext *ctx, char *args){
+    int reservationId;
+    if (!ctx->reservations) return "pre-orders are not enabled";
+    if (parseInt(nextToken(&args), 1, 0x7FFFFFFF, &reservationId) != 0) return "bad reservation ID";
+    Reservation *reservation = findReservation(ctx->reservations, reservationId);
+    if (!reservation) return "no such reservation";
+
+    int orderId = ctx->nextOrderId;
+    ctx->nextOrderId = ctx->nextOrderId % UINT16_MAX + 1;
+    pushOrder(ctx->stack, claimReservation(ctx->reservations, reservation, ctx->queue, orderId));
+    return NULL;
+}
+
+static const char* runCommand(BatchContext *ctx, char *line){
+    char *cursor = line;
+    const char *command = nextToken(&cursor);
+
+    /* holds past their deadline give their stock back before anything reads it */
+    if (ctx->reservations) expireReservations(ctx->reservations);
+    if (strcmp(command, "login") == 0) {
+        const char *username = nextToken(&cursor);
+        const char *password = nextToken(&cursor);
+        if (!username || !password) return "login needs a username and a password";
+        ctx->user = loginIndexed(ctx->userIndex, username, password);
+        return ctx->user ? NULL : "invalid username or password";
+    }
+    if (!ctx->user) return "not logged in";
+
+    if (strcmp(command, "menu") == 0) return menuCommand(ctx, cursor);
+    if (strcmp(command, "consumer") == 0) return consumerCommand(ctx, cursor);
+    if (strcmp(command, "order") == 0) return orderCommand(ctx, cursor);
+    if (strcmp(command, "reserve") == 0) return reserveCommand(ctx, cursor);
+    if (strcmp(command, "claim") == 0) return claimCommand(ctx, cursor);
+    if (strcmp(command, "undo") == 0) {
+        int undone = revertLastOrder(ctx->stack, ctx->queue);
+        if (undone == -3) return "order already started";
+        return undone >= 0 ? NULL : "no order to undo";
+    }
+    if (strcmp(command, "start") == 0) {
+        return startNextOrder(ctx->queue) ? NULL : "no order waiting to be started";
+    }
+    if (strcmp(command, "ready") == 0) {
+        return finishNextOrder(ctx->queue) ? NULL : "no order is being prepared";
+    }
+    if (strcmp(command, "serve") == 0) {
+        int served = serveNextOrder(ctx->queue, ctx->stack, ctx->archive);
+        if (served == -2) return "order could not be archived";
+        return served >= 0 ? NULL : "no order ready to serve";
+    }
+    return "unknown command";
+}
+
+/* ===============================
+   Driver
+   =============================== */
+
+int runBatch(FILE *in, BatchContext *context, FILE *errors, BatchResult *result){
+    char line[BATCH_MAX_LINE];
+    uint64_t started = metricNanos();
+
+    memset(result, 0, sizeof(*result));
+    setvbuf(in, NULL, _IOFBF, BATCH_READ_BUFFER);
+    while (fgets(line, sizeof(line), in)) {
+        result->lines++;
+        size_t length = strlen(line);
+        if (length == sizeof(line) - 1 && line[length - 1] != '\n') {
+            fprintf(errors, "batch:%ld: line too long\n", result->lines);
+            result->errors++;
+            int c;
+            while ((c = fgetc(in)) != EOF && c != '\n') {}
+            continue;
+        }
+
+        char *p = line;
+        while (*p && isspace((unsigned char)*p)) p++;
+        if (*p == '\0' || *p == '#') continue;
+
+        result->commands++;
+        const char *failure = runCommand(context, p);
+        if (failure) {
+            fprintf(errors, "batch:%ld: %s\n", result->lines, failure);
+            result->errors++;
+        }
+    }
+    result->elapsedNanos = metricNanos() - started;
+    return result->errors ? -1 : 0;
+}
+
+int runBatchFile(const char *path, BatchContext *context, BatchResult *result){
+    int fromStdin = strcmp(path, "-") == 0;
+    FILE *in = fromStdin ? stdin : fopen(path, "r");
+    if (!in) {
+        fprintf(stderr, "Error: Cannot open %s for reading!\n", path);
+        memset(result, 0, sizeof(*result));
+        return -1;
+    }
+
+    int status = runBatch(in, context, stderr, result);
+    if (!fromStdin) fclose(in);
+    return status;
+}
+
+void printBatchSummary(FILE *out, const BatchResult *result, StockForecaster *forecaster){
+    double seconds = result->elapsedNanos / 1e9;
+    fprintf(out, "%ld commands, %ld failed, in %.3f ms (%.0f commands/s)\n",
+            result->commands, result->errors, seconds * 1e3,
+            seconds > 0 ? result->commands / seconds : 0.0);
+
+    RestockAlert alert;
+    while (forecaster && pollRestockAlert(forecaster, &alert)) {
+        if (alert.reason == RESTOCK_LOW_QUANTITY) {
+            fprintf(out, "restock: %s (ID %d) is down to %d units\n", alert.name, alert.menuId, alert.quantity);
+        } else {
+            fprintf(out, "restock: %s (ID %d) runs out in ~%.0f min at %.1f units/min\n",
+                    alert.name, alert.menuId, alert.minutesToStockout, alert.unitsPerMinute);
+        }
+    }
+}
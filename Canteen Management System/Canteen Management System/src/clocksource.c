@@ -0,0 +1,83 @@
+#include <stdlib.h>
+#include "../include/clocksource.h"
+#include "../include/metrics.h"
+
+static time_t systemTime(void *context){
+    (void)context;
+    return time(NULL);
+}
+
+static uint64_t systemNanos(void *context){
+    (void)context;
+    return metricNanos();
+}
+
+static uint32_t systemRandom(void *context){
+    (void)context;
+    return (uint32_t)rand();
+}
+
+static ClockSource source = { systemTime, systemNanos, systemRandom, NULL };
+
+void setClockSource(const ClockSource *newSource){
+    if (newSource) {
+        source = *newSource;
+    } else {
+        source.wallTime = systemTime;
+        source.monotonicNanos = systemNanos;
+        source.random = systemRandom;
+        source.context = NULL;
+    }
+}
+
+time_t clockTime(void){
+    return source.wallTime(source.context);
+}
+
+uint64_t clockNanos(void){
+    return source.monotonicNanos(source.context);
+}
+
+uint32_t clockRandom(void){
+    return source.random(source.context);
+}
+
+/* ===============================
+   Virtual clock
+   =============================== */
+
+/* Offset so that a stage stamped at virtual time 0 is not mistaken for "never" */
+#define VIRTUAL_NANOS_BASE 1000000000ULL
+
+static time_t virtualTime(void *context){
+    const VirtualClock *clock = (const VirtualClock *)context;
+    return clock->epoch + (time_t)(clock->nanos / 1000000000ULL);
+}
+
+static uint64_t virtualNanos(void *context){
+    return VIRTUAL_NANOS_BASE + ((const VirtualClock *)context)->nanos;
+}
+
+static uint32_t virtualRandom(void *context){
+    VirtualClock *clock = (VirtualClock *)context;
+    /* xorshift64* */
+    clock->state ^= clock->state >> 12;
+    clock->state ^= clock->state << 25;
+    clock->state ^= clock->state >> 27;
+    return (uint32_t)((clock->state * 2685821657736338717ULL) >> 33);
+}
+
+void initVirtualClock(VirtualClock *clock, time_t epoch, uint64_t seed){
+    clock->epoch = epoch;
+    clock->nanos = 0;
+    clock->state = seed ? seed : 1;
+}
+
+void useVirtualClock(VirtualClock *clock){
+    ClockSource virtualSource = { virtualTime, virtualNanos, virtualRandom, clock };
+    setClockSource(&virtualSource);
+}
+
+void advanceVirtualClock(VirtualClock *clock, uint64_t nanos){
+    clock->nanos += nanos;
+}
@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <limits.h>
+#include "../include/combo.h"
+#include "../include/memtrack.h"
+
+/* ===============================
+   Pricing
+   =============================== */
+
+/* Splits the combo price over the components in proportion to their list prices */
+static void priceParts(Combo *combo){
+    combo->listPrice = 0.0f;
+    for (int p = 0; p < combo->partCount; p++) {
+        combo->listPrice += combo->parts[p].item->price * combo->parts[p].quantity;
+    }
+    float ratio = combo->listPrice > 0.0f ? combo->price / combo->listPrice : 0.0f;
+    for (int p = 0; p < combo->partCount; p++) {
+        combo->parts[p].unitPrice = combo->parts[p].item->price * ratio;
+    }
+}
+
+static int containsItem(const Combo *combo, const Menu *item){
+    for (int p = 0; p < combo->partCount; p++) {
+        if (combo->parts[p].item == item) return 1;
+    }
+    return 0;
+}
+
+static void onMenuEvent(Menu *item, MenuEvent event, void *context){
+    ComboBook *book = (ComboBook *)context;
+
+    if (event != MENU_ITEM_EDITED && event != MENU_ITEM_REMOVING) return;
+    for (Combo *combo = book->head; combo != NULL; combo = combo->next) {
+        if (!containsItem(combo, item)) continue;
+        if (event == MENU_ITEM_EDITED) priceParts(combo);
+        else combo->withdrawn = 1;
+    }
+}
+
+/* ===============================
+   Definition
+   =============================== */
+
+ComboBook* createComboBook(void){
+    ComboBook *book = (ComboBook *)memCalloc(MEM_MENU, 1, sizeof(ComboBook));
+    if (!book) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    if (addMenuObserver(onMenuEvent, book) != 0) {
+        memFree(book);
+        return NULL;
+    }
+    return book;
+}
+
+Combo* defineCombo(ComboBook *book, Menu *menuHead, int id, const char *name, float price,
+                   const int *menuIds, const int *quantities, int count){
+    if (count < 1 || findCombo(book, id) || findMenuItem(menuHead, id)) return NULL;
+
+    Combo *combo = (Combo *)memCalloc(MEM_MENU, 1, sizeof(Combo));
+    if (!combo) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    int resolved = 0;
+    for (int i = 0; i < count; i++) {
+        Menu *item = findMenuItem(menuHead, menuIds[i]);
+        int p = 0;
+        if (!item || quantities[i] < 1) break;
+        while (p < combo->partCount && combo->parts[p].item != item) p++;
+        if (p == combo->partCount) {
+            if (p == MAX_COMBO_PARTS) break;
+            combo->parts[p].item = item;
+            combo->partCount++;
+        }
+        combo->parts[p].quantity += quantities[i];
+        resolved++;
+    }
+    if (resolved < count || (combo->name = memStrdup(MEM_MENU, name)) == NULL) {
+        memFree(combo);
+        return NULL;
+    }
+
+    for (int p = 0; p < combo->partCount; p++) {
+        retainMenuItem(combo->parts[p].item);
+    }
+    combo->id = id;
+    combo->price = price;
+    priceParts(combo);
+    if (price <= 0.0f) {
+        combo->price = combo->listPrice;
+        priceParts(combo);
+    }
+    if (book->tail) book->tail->next = combo;
+    else book->head = combo;
+    book->tail = combo;
+    book->count++;
+    return combo;
+}
+
+Combo* findCombo(const ComboBook *book, int id){
+    for (Combo *combo = book->head; combo != NULL; combo = combo->next) {
+        if (combo->id == id) return combo;
+    }
+    return NULL;
+}
+
+/* ===============================
+   Ordering
+   =============================== */
+
+int comboAvailability(const Combo *combo){
+    if (combo->withdrawn) return 0;
+    int servings = INT_MAX;
+    for (int p = 0; p < combo->partCount; p++) {
+        int allowed = combo->parts[p].item->quantity / combo->parts[p].quantity;
+        if (allowed < servings) servings = allowed;
+    }
+    return servings;
+}
+
+int takeCombo(const Combo *combo, int servings, OrderItem **head, OrderItem **tail, float *total){
+    /* components are distinct items, so checking each against its own stock is enough */
+    if (servings < 1 || comboAvailability(combo) < servings) return -1;
+
+    /* build every line before any stock is taken, so a failed allocation leaves nothing to undo */
+    OrderItem *first = NULL, *last = NULL;
+    for (int p = 0; p < combo->partCount; p++) {
+        const ComboPart *part = &combo->parts[p];
+        OrderItem *line = createOrderItem(part->item, part->quantity * servings);
+        if (!line) {
+            freeOrderItems(first);
+            return -1;
+        }
+        line->unitPrice = part->unitPrice;
+        if (last) last->next = line;
+        else first = line;
+        last = line;
+    }
+
+    for (const OrderItem *line = first; line != NULL; line = line->next) {
+        adjustItemQuantity(line->menuItem, -line->quantity);
+    }
+    if (*tail) (*tail)->next = first;
+    else *head = first;
+    *tail = last;
+    *total += combo->price * servings;
+    return 0;
+}
+
+void displayCombos(const ComboBook *book){
+    if (!book || book->count == 0) return;
+    printf("Combos:\n");
+    printf("ID\tName\tPrice\tAvailable\tContents\n");
+    for (const Combo *combo = book->head; combo != NULL; combo = combo->next) {
+        printf("%d\t%s\t%.2f\t", combo->id, combo->name, combo->price);
+        if (combo->withdrawn) printf("withdrawn\t");
+        else printf("%d\t", comboAvailability(combo));
+        for (int p = 0; p < combo->partCount; p++) {
+            printf("%s%dx %s", p ? ", " : "", combo->parts[p].quantity, combo->parts[p].item->name);
+        }
+        printf("\n");
+    }
+}
+
+void freeComboBook(ComboBook *book){
+    if (!book) return;
+    removeMenuObserver(onMenuEvent, book);
+    Combo *combo = book->head;
+    while (combo) {
+        Combo *next = combo->next;
+        for (int p = 0; p < combo->partCount; p++) {
+            releaseMenuItem(combo->parts[p].item);
+        }
+        memFree(combo->name);
+        memFree(combo);
+        combo = next;
+    }
+    memFree(book);
+}
@@ -1,12 +1,14 @@
 #include "../include/consumer.h"
+#include "../include/metrics.h"
+#include "../include/memtrack.h"
 Consumer* createConsumer(const char *uid, const char *name, ConsumerType type){
-    Consumer *newConsumer = (Consumer *)malloc(sizeof(Consumer));
+    Consumer *newConsumer = (Consumer *)memAlloc(MEM_CONSUMERS, sizeof(Consumer));
     if (!newConsumer) {
         fprintf(stderr, "Memory allocation failed for new consumer.\n");
         exit(EXIT_FAILURE);
     }
-    newConsumer->uid = strdup(uid);
-    newConsumer->name = strdup(name);
+    newConsumer->uid = memStrdup(MEM_CONSUMERS, uid);
+    newConsumer->name = memStrdup(MEM_CONSUMERS, name);
     newConsumer->type = type;
     newConsumer->next = NULL;
     newConsumer->prev = NULL;
@@ -20,6 +22,16 @@ void addConsumer(Consumer **head, const char *uid, const char *name, ConsumerTyp
     }
     *head = newConsumer;
 }
+Consumer* findConsumer(Consumer *head, const char *uid){
+    METRIC_START(started);
+    Consumer *current = head;
+    while (current != NULL && strcmp(current->uid, uid) != 0) {
+        current = current->next;
+    }
+    if (current == NULL) METRIC_COUNT(COUNTER_CONSUMER_MISSES, 1);
+    METRIC_STOP(METRIC_CONSUMER_LOOKUP, started);
+    return current;
+}
 void displayConsumers(Consumer *head){
     Consumer *current = head;
     while (current != NULL) {
@@ -41,26 +53,23 @@ void displayConsumers(Consumer *head){
     }
 }
 void  editConsumer(Consumer *head, const char *uid, const char *newName, ConsumerType newType){
-    Consumer *current = head;
-    while (current != NULL) {
-        if (strcmp(current->uid, uid) == 0) {
-            free(current->name);
-            current->name = strdup(newName);
-            current->type = newType;
-            return;
-        }
-        current = current->next;
+    Consumer *current = findConsumer(head, uid);
+    if (current == NULL) {
+        fprintf(stderr, "Consumer with UID %s not found.\n", uid);
+        return;
     }
-    fprintf(stderr, "Consumer with UID %s not found.\n", uid);
+    memFree(current->name);
+    current->name = memStrdup(MEM_CONSUMERS, newName);
+    current->type = newType;
 }
 void freeConsumers(Consumer *head){
     Consumer *current = head;
     Consumer *next;
     while (current != NULL) {
         next = current->next;
-        free(current->uid);
-        free(current->name);
-        free(current);
+        memFree(current->uid);
+        memFree(current->name);
+        memFree(current);
         current = next;
     }
 }
@@ -0,0 +1,543 @@
+#include <math.h>
+#include "../include/historyfile.h"
+#include "../include/memtrack.h"
+
+#define HISTORY_MAGIC "CMSH"
+#define HISTORY_VERSION 1
+#define BLOCK_HEADER_SIZE 12
+
+/* ===============================
+   CRC-32 (IEEE 802.3)
+   =============================== */
+
+static uint32_t crcTable[256];
+static int crcReady = 0;
+
+static uint32_t crc32(const uint8_t *data, size_t length){
+    if (!crcReady) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            crcTable[i] = c;
+        }
+        crcReady = 1;
+    }
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static void putU32(uint8_t *p, uint32_t v){
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t getU32(const uint8_t *p){
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* ===============================
+   Block codec
+   =============================== */
+
+static void resetCodec(HistoryCodec *codec){
+    for (int i = 0; i < codec->consumerCount; i++) {
+        memFree(codec->consumers[i].uid);
+        memFree(codec->consumers[i].name);
+    }
+    codec->length = 0;
+    codec->position = 0;
+    codec->blockRecords = 0;
+    codec->lastTime = 0;
+    codec->lastOrderId = 0;
+    codec->consumerCount = 0;
+    codec->itemCount = 0;
+    if (codec->consumerSlots) {
+        memset(codec->consumerSlots, 0, codec->slotCapacity * sizeof(int32_t));
+        memset(codec->itemSlots, 0, codec->slotCapacity * sizeof(int32_t));
+    }
+}
+
+static void freeCodec(HistoryCodec *codec){
+    resetCodec(codec);
+    memFree(codec->buffer);
+    memFree(codec->consumers);
+    memFree(codec->items);
+    memFree(codec->consumerSlots);
+    memFree(codec->itemSlots);
+}
+
+static int reserveBytes(HistoryCodec *codec, size_t extra){
+    if (codec->length + extra <= codec->capacity) return 0;
+    size_t capacity = codec->capacity ? codec->capacity * 2 : HISTORY_BLOCK_SIZE * 2;
+    while (capacity < codec->length + extra) capacity *= 2;
+    uint8_t *buffer = (uint8_t *)memRealloc(MEM_ARCHIVE, codec->buffer, capacity);
+    if (!buffer) return -1;
+    codec->buffer = buffer;
+    codec->capacity = capacity;
+    return 0;
+}
+
+static void putVarint(HistoryCodec *codec, uint64_t v){
+    while (v >= 0x80) {
+        codec->buffer[codec->length++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    codec->buffer[codec->length++] = (uint8_t)v;
+}
+
+static void putSigned(HistoryCodec *codec, int64_t v){
+    putVarint(codec, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+static void putString(HistoryCodec *codec, const char *s){
+    size_t n = strlen(s);
+    putVarint(codec, n);
+    memcpy(codec->buffer + codec->length, s, n);
+    codec->length += n;
+}
+
+static int getVarint(HistoryCodec *codec, uint64_t *v){
+    uint64_t result = 0;
+    int shift = 0;
+    while (codec->position < codec->length && shift < 64) {
+        uint8_t byte = codec->buffer[codec->position++];
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *v = result;
+            return 0;
+        }
+        shift += 7;
+    }
+    return -1;
+}
+
+static int getSigned(HistoryCodec *codec, int64_t *v){
+    uint64_t u;
+    if (getVarint(codec, &u) != 0) return -1;
+    *v = (int64_t)(u >> 1) ^ -(int64_t)(u & 1);
+    return 0;
+}
+
+static char* getString(HistoryCodec *codec){
+    uint64_t n;
+    if (getVarint(codec, &n) != 0 || n > codec->length - codec->position) return NULL;
+    char *s = (char *)memAlloc(MEM_ARCHIVE, n + 1);
+    if (!s) return NULL;
+    memcpy(s, codec->buffer + codec->position, n);
+    s[n] = '\0';
+    codec->position += n;
+    return s;
+}
+
+static int growConsumers(HistoryCodec *codec){
+    if (codec->consumerCount < codec->consumerCapacity) return 0;
+    int capacity = codec->consumerCapacity ? codec->consumerCapacity * 2 : 64;
+    HistoryDictEntry *entries = (HistoryDictEntry *)memRealloc(MEM_ARCHIVE, codec->consumers, capacity * sizeof(HistoryDictEntry));
+    if (!entries) return -1;
+    codec->consumers = entries;
+    codec->consumerCapacity = capacity;
+    return 0;
+}
+
+static int growItems(HistoryCodec *codec){
+    if (codec->itemCount < codec->itemCapacity) return 0;
+    int capacity = codec->itemCapacity ? codec->itemCapacity * 2 : 64;
+    HistoryItemEntry *entries = (HistoryItemEntry *)memRealloc(MEM_ARCHIVE, codec->items, capacity * sizeof(HistoryItemEntry));
+    if (!entries) return -1;
+    codec->items = entries;
+    codec->itemCapacity = capacity;
+    return 0;
+}
+
+/* ===============================
+   Writer dictionaries
+   =============================== */
+
+static uint32_t hashString(const char *s){
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static uint32_t hashItem(int32_t menuId, int32_t priceCents){
+    return ((uint32_t)menuId * 2654435761u) ^ ((uint32_t)priceCents * 40503u);
+}
+
+static int consumerSlot(const HistoryCodec *codec, const char *uid){
+    int mask = codec->slotCapacity - 1;
+    int i = (int)(hashString(uid) & (uint32_t)mask);
+    while (codec->consumerSlots[i] != 0 &&
+           strcmp(codec->consumers[codec->consumerSlots[i] - 1].uid, uid) != 0) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+static int itemSlot(const HistoryCodec *codec, int32_t menuId, int32_t priceCents){
+    int mask = codec->slotCapacity - 1;
+    int i = (int)(hashItem(menuId, priceCents) & (uint32_t)mask);
+    while (codec->itemSlots[i] != 0) {
+        const HistoryItemEntry *e = &codec->items[codec->itemSlots[i] - 1];
+        if (e->menuId == menuId && e->priceCents == priceCents) break;
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/* Keeps both tables at most half full */
+static int reserveSlots(HistoryCodec *codec, int needed){
+    if (needed * 2 <= codec->slotCapacity) return 0;
+    int capacity = codec->slotCapacity ? codec->slotCapacity * 2 : 256;
+    while (needed * 2 > capacity) capacity *= 2;
+    int32_t *consumers = (int32_t *)memCalloc(MEM_ARCHIVE, capacity, sizeof(int32_t));
+    int32_t *items = (int32_t *)memCalloc(MEM_ARCHIVE, capacity, sizeof(int32_t));
+    if (!consumers || !items) {
+        memFree(consumers);
+        memFree(items);
+        return -1;
+    }
+    memFree(codec->consumerSlots);
+    memFree(codec->itemSlots);
+    codec->consumerSlots = consumers;
+    codec->itemSlots = items;
+    codec->slotCapacity = capacity;
+    for (int i = 0; i < codec->consumerCount; i++) {
+        codec->consumerSlots[consumerSlot(codec, codec->consumers[i].uid)] = i + 1;
+    }
+    for (int i = 0; i < codec->itemCount; i++) {
+        codec->itemSlots[itemSlot(codec, codec->items[i].menuId, codec->items[i].priceCents)] = i + 1;
+    }
+    return 0;
+}
+
+static int32_t toCents(float amount){
+    return (int32_t)lround((double)amount * 100.0);
+}
+
+/* ===============================
+   Writer
+   =============================== */
+
+static int flushBlock(HistoryWriter *writer){
+    HistoryCodec *codec = &writer->codec;
+    if (codec->blockRecords == 0) return 0;
+
+    uint8_t header[BLOCK_HEADER_SIZE];
+    putU32(header, (uint32_t)codec->length);
+    putU32(header + 4, (uint32_t)codec->blockRecords);
+    putU32(header + 8, crc32(codec->buffer, codec->length));
+    if (fwrite(header, 1, sizeof(header), writer->file) != sizeof(header) ||
+        fwrite(codec->buffer, 1, codec->length, writer->file) != codec->length) {
+        return -1;
+    }
+    writer->stats.encodedBytes += BLOCK_HEADER_SIZE + (long)codec->length;
+    writer->stats.blocks++;
+    resetCodec(codec);
+    return 0;
+}
+
+HistoryWriter* openHistoryWriter(const char *path){
+    HistoryWriter *writer = (HistoryWriter *)memCalloc(MEM_ARCHIVE, 1, sizeof(HistoryWriter));
+    if (!writer) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+
+    writer->file = fopen(path, "wb");
+    if (!writer->file) {
+        fprintf(stderr, "Cannot create %s\n", path);
+        memFree(writer);
+        return NULL;
+    }
+    fwrite(HISTORY_MAGIC, 1, 4, writer->file);
+    fputc(HISTORY_VERSION, writer->file);
+    writer->stats.encodedBytes = 5;
+    return writer;
+}
+
+int writeHistoryOrder(HistoryWriter *writer, const ArchivedOrder *order){
+    HistoryCodec *codec = &writer->codec;
+    size_t uidLength = strlen(order->consumerUID);
+    size_t nameLength = strlen(order->consumerName);
+    /* worst case: 10 bytes per varint plus both strings */
+    size_t worst = 60 + uidLength + nameLength + (size_t)order->lineCount * 30;
+
+    if (reserveBytes(codec, worst) != 0 ||
+        reserveSlots(codec, codec->consumerCount + codec->itemCount + order->lineCount + 1) != 0 ||
+        growConsumers(codec) != 0) {
+        return -1;
+    }
+
+    putSigned(codec, (int64_t)order->orderTime - codec->lastTime);
+    putSigned(codec, (int64_t)order->orderId - codec->lastOrderId);
+    codec->lastTime = order->orderTime;
+    codec->lastOrderId = order->orderId;
+
+    int slot = consumerSlot(codec, order->consumerUID);
+    if (codec->consumerSlots[slot] != 0) {
+        putVarint(codec, (uint64_t)codec->consumerSlots[slot]);
+    } else {
+        HistoryDictEntry *e = &codec->consumers[codec->consumerCount];
+        e->uid = memStrdup(MEM_ARCHIVE, order->consumerUID);
+        e->name = memStrdup(MEM_ARCHIVE, order->consumerName);
+        e->type = order->consumerType;
+        codec->consumerSlots[slot] = ++codec->consumerCount;
+        putVarint(codec, 0);
+        putVarint(codec, (uint64_t)order->consumerType);
+        putString(codec, order->consumerUID);
+        putString(codec, order->consumerName);
+    }
+
+    putVarint(codec, (uint64_t)toCents(order->totalAmount));
+    putVarint(codec, (uint64_t)order->lineCount);
+    for (int i = 0; i < order->lineCount; i++) {
+        int32_t priceCents = toCents(order->unitPrices[i]);
+        int s = itemSlot(codec, order->menuIds[i], priceCents);
+        if (codec->itemSlots[s] != 0) {
+            putVarint(codec, (uint64_t)codec->itemSlots[s]);
+        } else {
+            if (growItems(codec) != 0) return -1;
+            codec->items[codec->itemCount].menuId = order->menuIds[i];
+            codec->items[codec->itemCount].priceCents = priceCents;
+            codec->itemSlots[s] = ++codec->itemCount;
+            putVarint(codec, 0);
+            putSigned(codec, order->menuIds[i]);
+            putVarint(codec, (uint64_t)priceCents);
+        }
+        putVarint(codec, (uint64_t)order->quantities[i]);
+    }
+
+    codec->blockRecords++;
+    writer->stats.records++;
+    writer->stats.lines += order->lineCount;
+    writer->stats.rawBytes += (long)(sizeof(time_t) + sizeof(uint16_t) + sizeof(uint8_t) + sizeof(float)
+                                     + uidLength + 1 + nameLength + 1
+                                     + order->lineCount * (2 * sizeof(int32_t) + sizeof(float)));
+
+    if (codec->length >= HISTORY_BLOCK_SIZE) {
+        return flushBlock(writer);
+    }
+    return 0;
+}
+
+long writeHistoryRange(HistoryWriter *writer, const OrderArchive *archive, time_t from, time_t to){
+    ArchiveCursor cursor;
+    ArchivedOrder order;
+    long written = 0;
+
+    archiveSeek(archive, from, to, &cursor);
+    while (archiveNext(&cursor, &order)) {
+        if (writeHistoryOrder(writer, &order) != 0) return -1;
+        written++;
+    }
+    return written;
+}
+
+int closeHistoryWriter(HistoryWriter *writer, HistoryStats *stats){
+    if (!writer) return -1;
+    int result = flushBlock(writer);
+    if (fclose(writer->file) != 0) result = -1;
+    if (stats) *stats = writer->stats;
+    freeCodec(&writer->codec);
+    memFree(writer);
+    return result;
+}
+
+/* ===============================
+   Reader
+   =============================== */
+
+static int loadBlock(HistoryReader *reader){
+    HistoryCodec *codec = &reader->codec;
+    uint8_t header[BLOCK_HEADER_SIZE];
+
+    resetCodec(codec);
+    size_t got = fread(header, 1, sizeof(header), reader->file);
+    if (got == 0) return 0;
+    if (got != sizeof(header)) return -1;
+
+    uint32_t length = getU32(header);
+    if (reserveBytes(codec, length) != 0) return -1;
+    if (fread(codec->buffer, 1, length, reader->file) != length) return -1;
+    if (crc32(codec->buffer, length) != getU32(header + 8)) {
+        fprintf(stderr, "History block %ld is corrupt (checksum mismatch)\n", reader->stats.blocks);
+        return -1;
+    }
+    codec->length = length;
+    codec->blockRecords = getU32(header + 4);
+    reader->stats.blocks++;
+    reader->stats.encodedBytes += BLOCK_HEADER_SIZE + (long)length;
+    return 1;
+}
+
+HistoryReader* openHistoryReader(const char *path){
+    char magic[5];
+    HistoryReader *reader = (HistoryReader *)memCalloc(MEM_ARCHIVE, 1, sizeof(HistoryReader));
+    if (!reader) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+
+    reader->file = fopen(path, "rb");
+    if (!reader->file) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        memFree(reader);
+        return NULL;
+    }
+    if (fread(magic, 1, 5, reader->file) != 5 || memcmp(magic, HISTORY_MAGIC, 4) != 0 ||
+        magic[4] != HISTORY_VERSION) {
+        fprintf(stderr, "%s is not a history file\n", path);
+        fclose(reader->file);
+        memFree(reader);
+        return NULL;
+    }
+    reader->stats.encodedBytes = 5;
+    return reader;
+}
+
+static int reserveLineBuffers(HistoryReader *reader, int lines){
+    if (lines <= reader->lineCapacity) return 0;
+    int capacity = reader->lineCapacity ? reader->lineCapacity : 16;
+    while (capacity < lines) capacity *= 2;
+    int32_t *ids = (int32_t *)memRealloc(MEM_ARCHIVE, reader->menuIds, capacity * sizeof(int32_t));
+    if (!ids) return -1;
+    reader->menuIds = ids;
+    int32_t *qty = (int32_t *)memRealloc(MEM_ARCHIVE, reader->quantities, capacity * sizeof(int32_t));
+    if (!qty) return -1;
+    reader->quantities = qty;
+    float *prices = (float *)memRealloc(MEM_ARCHIVE, reader->unitPrices, capacity * sizeof(float));
+    if (!prices) return -1;
+    reader->unitPrices = prices;
+    reader->lineCapacity = capacity;
+    return 0;
+}
+
+int readHistoryOrder(HistoryReader *reader, ArchivedOrder *out){
+    HistoryCodec *codec = &reader->codec;
+    int64_t delta;
+    uint64_t v, lines;
+
+    if (codec->position >= codec->length) {
+        int loaded = loadBlock(reader);
+        if (loaded <= 0) return loaded;
+    }
+
+    if (getSigned(codec, &delta) != 0) return -1;
+    codec->lastTime += delta;
+    if (getSigned(codec, &delta) != 0) return -1;
+    codec->lastOrderId += delta;
+
+    if (getVarint(codec, &v) != 0) return -1;
+    if (v == 0) {
+        uint64_t type;
+        if (growConsumers(codec) != 0 || getVarint(codec, &type) != 0) return -1;
+        HistoryDictEntry *e = &codec->consumers[codec->consumerCount];
+        e->type = (ConsumerType)type;
+        e->uid = getString(codec);
+        e->name = getString(codec);
+        codec->consumerCount++;
+        if (!e->uid || !e->name) return -1;
+        v = (uint64_t)codec->consumerCount;
+    }
+    if (v > (uint64_t)codec->consumerCount) return -1;
+    const HistoryDictEntry *consumer = &codec->consumers[v - 1];
+
+    if (getVarint(codec, &v) != 0 || getVarint(codec, &lines) != 0) return -1;
+    if (lines > codec->length || reserveLineBuffers(reader, (int)lines) != 0) return -1;
+
+    out->orderTime = (time_t)codec->lastTime;
+    out->orderId = (int)codec->lastOrderId;
+    out->consumerUID = consumer->uid;
+    out->consumerName = consumer->name;
+    out->consumerType = consumer->type;
+    out->totalAmount = (float)(v / 100.0);
+    out->lineCount = (int)lines;
+
+    for (uint64_t i = 0; i < lines; i++) {
+        uint64_t ref, quantity;
+        if (getVarint(codec, &ref) != 0) return -1;
+        if (ref == 0) {
+            int64_t menuId;
+            uint64_t cents;
+            if (growItems(codec) != 0 || getSigned(codec, &menuId) != 0 || getVarint(codec, &cents) != 0) {
+                return -1;
+            }
+            codec->items[codec->itemCount].menuId = (int32_t)menuId;
+            codec->items[codec->itemCount].priceCents = (int32_t)cents;
+            ref = (uint64_t)++codec->itemCount;
+        }
+        if (ref > (uint64_t)codec->itemCount || getVarint(codec, &quantity) != 0) return -1;
+        reader->menuIds[i] = codec->items[ref - 1].menuId;
+        reader->unitPrices[i] = codec->items[ref - 1].priceCents / 100.0f;
+        reader->quantities[i] = (int32_t)quantity;
+    }
+    out->menuIds = reader->menuIds;
+    out->quantities = reader->quantities;
+    out->unitPrices = reader->unitPrices;
+
+    reader->stats.records++;
+    reader->stats.lines += out->lineCount;
+    return 1;
+}
+
+void closeHistoryReader(HistoryReader *reader, HistoryStats *stats){
+    if (!reader) return;
+    if (stats) *stats = reader->stats;
+    fclose(reader->file);
+    freeCodec(&reader->codec);
+    memFree(reader->menuIds);
+    memFree(reader->quantities);
+    memFree(reader->unitPrices);
+    memFree(reader);
+}
+
+/* ===============================
+   Export with report
+   =============================== */
+
+int exportHistoryFile(const OrderArchive *archive, const char *path, time_t from, time_t to){
+    HistoryStats written, read;
+    HistoryWriter *writer = openHistoryWriter(path);
+    if (!writer) return -1;
+
+    long count = writeHistoryRange(writer, archive, from, to);
+    if (closeHistoryWriter(writer, &written) != 0 || count < 0) {
+        fprintf(stderr, "Writing %s failed\n", path);
+        return -1;
+    }
+
+    HistoryReader *reader = openHistoryReader(path);
+    if (!reader) return -1;
+    ArchivedOrder order;
+    int status;
+    clock_t start = clock();
+    while ((status = readHistoryOrder(reader, &order)) == 1) {
+        /* decode only */
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    closeHistoryReader(reader, &read);
+    if (status < 0) return -1;
+
+    printf("Exported %ld orders (%ld lines) in %ld blocks to %s\n",
+           written.records, written.lines, written.blocks, path);
+    printf("Raw size: %ld bytes, encoded: %ld bytes, ratio: %.2fx\n",
+           written.rawBytes, written.encodedBytes,
+           written.encodedBytes ? (double)written.rawBytes / written.encodedBytes : 0.0);
+    if (seconds > 0) {
+        printf("Decode: %.1f MB/s, %.0f orders/s\n",
+               read.encodedBytes / seconds / 1e6, read.records / seconds);
+    } else {
+        printf("Decode: too fast to measure (%ld orders)\n", read.records);
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <string.h>
+#include "../include/idempotency.h"
+#include "../include/clocksource.h"
+#include "../include/memtrack.h"
+
+#define REQUEST_INITIAL_BUCKETS 64
+
+/* FNV-1a */
+static uint32_t hashKey(const char *key){
+    uint32_t hash = 2166136261u;
+    for (; *key; key++) {
+        hash ^= (unsigned char)*key;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static RequestEntry** bucketOf(RequestTable *table, uint32_t hash){
+    return &table->buckets[hash & (uint32_t)(table->bucketCount - 1)];
+}
+
+/* ===============================
+   Expiry
+   =============================== */
+
+static void unlinkFromBucket(RequestTable *table, RequestEntry *entry){
+    RequestEntry **link = bucketOf(table, entry->hash);
+    while (*link && *link != entry) link = &(*link)->chainNext;
+    if (*link) *link = entry->chainNext;
+}
+
+/* Entries expire in the order they were added, so only the front is checked */
+static void expireRequests(RequestTable *table, uint64_t now){
+    while (table->oldest && table->oldest->expiresNanos <= now) {
+        RequestEntry *entry = table->oldest;
+        table->oldest = entry->ageNext;
+        if (!table->oldest) table->newest = NULL;
+        unlinkFromBucket(table, entry);
+        if (entry->order) entry->order->request = NULL;
+        table->count--;
+        memFree(entry);
+    }
+}
+
+static int growBuckets(RequestTable *table){
+    int bucketCount = table->bucketCount * 2;
+    RequestEntry **buckets = (RequestEntry **)memCalloc(MEM_ORDERS, bucketCount, sizeof(RequestEntry *));
+    if (!buckets) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return -1;
+    }
+    for (RequestEntry *entry = table->oldest; entry != NULL; entry = entry->ageNext) {
+        RequestEntry **bucket = &buckets[entry->hash & (uint32_t)(bucketCount - 1)];
+        entry->chainNext = *bucket;
+        *bucket = entry;
+    }
+    memFree(table->buckets);
+    table->buckets = buckets;
+    table->bucketCount = bucketCount;
+    return 0;
+}
+
+/* An order that left the queue is freed right after; keep the key, drop the pointer */
+static void onOrderEvent(Order *order, OrderEvent event, void *context){
+    (void)context;
+    if ((event == ORDER_DEQUEUED || event == ORDER_CANCELLED) && order->request) {
+        order->request->order = NULL;
+        order->request = NULL;
+    }
+}
+
+/* ===============================
+   Lookup
+   =============================== */
+
+const RequestEntry* findRequest(RequestTable *table, const char *key){
+    expireRequests(table, clockNanos());
+
+    uint32_t hash = hashKey(key);
+    for (RequestEntry *entry = *bucketOf(table, hash); entry != NULL; entry = entry->chainNext) {
+        if (entry->hash == hash && strcmp(entry->key, key) == 0) return entry;
+    }
+    return NULL;
+}
+
+int rememberRequest(RequestTable *table, const char *key, Order *order){
+    size_t length = strlen(key);
+    if (length == 0 || length >= REQUEST_KEY_LENGTH) return -1;
+    if (table->count >= table->bucketCount && growBuckets(table) != 0) return -1;
+
+    RequestEntry *entry = (RequestEntry *)memAlloc(MEM_ORDERS, sizeof(RequestEntry));
+    if (!entry) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return -1;
+    }
+    memcpy(entry->key, key, length + 1);
+    entry->hash = hashKey(key);
+    entry->orderId = order->orderId;
+    entry->order = order;
+    entry->expiresNanos = clockNanos() + table->windowNanos;
+    entry->ageNext = NULL;
+
+    RequestEntry **bucket = bucketOf(table, entry->hash);
+    entry->chainNext = *bucket;
+    *bucket = entry;
+    if (table->newest) table->newest->ageNext = entry;
+    else table->oldest = entry;
+    table->newest = entry;
+    table->count++;
+    order->request = entry;
+    return 0;
+}
+
+RequestTable* createRequestTable(uint64_t windowNanos){
+    RequestTable *table = (RequestTable *)memCalloc(MEM_ORDERS, 1, sizeof(RequestTable));
+    if (!table) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    table->windowNanos = windowNanos;
+    table->bucketCount = REQUEST_INITIAL_BUCKETS;
+    table->buckets = (RequestEntry **)memCalloc(MEM_ORDERS, REQUEST_INITIAL_BUCKETS, sizeof(RequestEntry *));
+    if (!table->buckets || addOrderObserver(onOrderEvent, table) != 0) {
+        memFree(table->buckets);
+        memFree(table);
+        return NULL;
+    }
+    return table;
+}
+
+void freeRequestTable(RequestTable *table){
+    if (!table) return;
+    removeOrderObserver(onOrderEvent, table);
+    expireRequests(table, UINT64_MAX);
+    memFree(table->buckets);
+    memFree(table);
+}
@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include "../include/intake.h"
+#include "../include/ordertrace.h"
+#include "../include/memtrack.h"
+
+static const char *resultTexts[INTAKE_RESULT_COUNT] = {
+    "accepted",
+    "kitchen queue is full",
+    "kitchen station is full",
+    "wait would be too long",
+    "order is too large for the kitchen"
+};
+
+/* ===============================
+   Station counters
+   =============================== */
+
+static void addStationUnits(int units[INTAKE_STATIONS], const OrderItem *items, int sign){
+    for (const OrderItem *line = items; line != NULL; line = line->next) {
+        int station = line->menuItem->type;
+        if (station < 0 || station >= INTAKE_STATIONS) continue;
+        units[station] += sign * line->quantity;
+        if (units[station] < 0) units[station] = 0;     /* item type edited while queued */
+    }
+}
+
+/* An order loads its stations from enqueue until it is ready (or leaves unprepared) */
+static void onOrderEvent(Order *order, OrderEvent event, void *context){
+    IntakeControl *control = (IntakeControl *)context;
+
+    switch (event) {
+    case ORDER_ENQUEUED:
+        addStationUnits(control->stationUnits, order->items, 1);
+        break;
+    case ORDER_READY:
+        addStationUnits(control->stationUnits, order->items, -1);
+        break;
+    case ORDER_DEQUEUED:
+    case ORDER_CANCELLED:
+        if (order->stageNanos[STAGE_READY] == 0) {
+            addStationUnits(control->stationUnits, order->items, -1);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/* ===============================
+   Intake
+   =============================== */
+
+IntakeResult checkIntake(const IntakeControl *control, const OrderItem *items){
+    const IntakeLimits *limits = &control->limits;
+    int units[INTAKE_STATIONS] = { 0 };
+    uint64_t work = 0;
+
+    addStationUnits(units, items, 1);
+    if (control->eta && limits->maxWaitNanos) {
+        work = estimateBasketWork(control->eta, items);
+    }
+
+    /* baskets that could never fit, however empty the kitchen */
+    for (int s = 0; s < INTAKE_STATIONS; s++) {
+        if (limits->maxStationUnits[s] && units[s] > limits->maxStationUnits[s]) return INTAKE_TOO_LARGE;
+    }
+    if (limits->maxWaitNanos && work > limits->maxWaitNanos) return INTAKE_TOO_LARGE;
+
+    /* baskets that fit once the kitchen catches up */
+    if (limits->maxQueueDepth && control->queue->count >= limits->maxQueueDepth) return INTAKE_QUEUE_FULL;
+    for (int s = 0; s < INTAKE_STATIONS; s++) {
+        if (limits->maxStationUnits[s] && units[s] > 0
+            && control->stationUnits[s] + units[s] > limits->maxStationUnits[s]) {
+            return INTAKE_STATION_FULL;
+        }
+    }
+    if (work && estimateBasketReadyIn(control->eta, items) > limits->maxWaitNanos) {
+        return INTAKE_WAIT_TOO_LONG;
+    }
+    return INTAKE_ACCEPTED;
+}
+
+Order* submitOrder(IntakeControl *control, OrderQueue *queue, int orderId,
+                   const Consumer *consumer, OrderItem *items, float totalAmount,
+                   IntakeResult *result){
+    IntakeResult decision = checkIntake(control, items);
+
+    control->decisions[decision]++;
+    if (result) *result = decision;
+    if (decision != INTAKE_ACCEPTED) return NULL;
+    return enqueueConsumerOrder(queue, orderId, consumer, items, totalAmount);
+}
+
+int isIntakeDeferral(IntakeResult result){
+    return result == INTAKE_QUEUE_FULL || result == INTAKE_STATION_FULL || result == INTAKE_WAIT_TOO_LONG;
+}
+
+const char* intakeResultText(IntakeResult result){
+    return resultTexts[result];
+}
+
+IntakeControl* createIntakeControl(const OrderQueue *queue, const IntakeLimits *limits,
+                                   const WaitEstimator *eta){
+    IntakeControl *control = (IntakeControl *)memCalloc(MEM_ORDERS, 1, sizeof(IntakeControl));
+    if (!control) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    control->limits = *limits;
+    control->queue = queue;
+    control->eta = eta;
+    for (const Order *order = queue->front; order != NULL; order = order->next) {
+        if (order->stageNanos[STAGE_READY] == 0) {
+            addStationUnits(control->stationUnits, order->items, 1);
+        }
+    }
+    if (addOrderObserver(onOrderEvent, control) != 0) {
+        memFree(control);
+        return NULL;
+    }
+    return control;
+}
+
+void freeIntakeControl(IntakeControl *control){
+    if (!control) return;
+    removeOrderObserver(onOrderEvent, control);
+    memFree(control);
+}
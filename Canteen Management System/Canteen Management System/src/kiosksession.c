@@ -0,0 +1,474 @@
+#include <ctype.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/kiosksession.h"
+#include "../include/clocksource.h"
+
+#define KIOSK_LINE_BUFFER 256
+#define KIOSK_SEARCH_RESULTS 5
+
+static const char *itemTypes[] = { "FOOD", "DRINK", "DESERT" };
+
+/* ===============================
+   Output
+   =============================== */
+
+static void say(KioskSession *session, const char *format, ...){
+    char buffer[KIOSK_LINE_BUFFER];
+    va_list args;
+
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) return;
+    if (length >= (int)sizeof(buffer)) length = sizeof(buffer) - 1;
+    session->write(session->context, buffer, (size_t)length);
+}
+
+static void sayItem(KioskSession *session, const Menu *item){
+    say(session, "%d\t%s\t%s\t%.2f\t%d\n", item->id, item->name, itemTypes[item->type],
+        item->price, item->quantity);
+}
+
+/* Same layout as displayCombos() */
+static void showCombos(KioskSession *session){
+    const ComboBook *combos = session->canteen->combos;
+    if (!combos || combos->count == 0) return;
+    say(session, "Combos:\nID\tName\tPrice\tAvailable\n");
+    for (const Combo *combo = combos->head; combo != NULL; combo = combo->next) {
+        if (combo->withdrawn) continue;
+        say(session, "%d\t%s\t%.2f\t%d\n", combo->id, combo->name, combo->price, comboAvailability(combo));
+    }
+}
+
+static void showMenu(KioskSession *session){
+    MenuStore *store = session->canteen->menuStore;
+    int reader = store ? registerMenuReader(store) : -1;
+
+    say(session, "Menu Items:\nID\tName\tType\tPrice\tQuantity\n");
+    if (reader >= 0) {
+        refreshMenu(store);
+        const MenuSnapshot *snapshot = menuReadBegin(store, reader);
+        for (int i = 0; i < snapshot->count; i++) {
+            const MenuEntry *entry = &snapshot->entries[i];
+            say(session, "%d\t%s\t%s\t%.2f\t%d\n", entry->id, entry->name, itemTypes[entry->type],
+                entry->price, entry->quantity);
+        }
+        menuReadEnd(store, reader);
+        unregisterMenuReader(store, reader);
+    } else {
+        for (const Menu *item = session->canteen->menuHead; item != NULL; item = item->next) {
+            sayItem(session, item);
+        }
+    }
+    showCombos(session);
+}
+
+static void showMenuByPrice(KioskSession *session){
+    MenuIndexCursor cursor;
+    say(session, "Menu Items:\nID\tName\tType\tPrice\tQuantity\n");
+    for (Menu *item = menuIndexSeek(session->canteen->menuIndex, MENU_BY_PRICE, -1.0f, &cursor);
+         item; item = menuIndexNext(&cursor)) {
+        sayItem(session, item);
+    }
+}
+
+/* Same fallback as displaySearchResults(): prefix first, then up to two edits */
+static void showSearch(KioskSession *session, const char *query){
+    MenuSearchHit hits[KIOSK_SEARCH_RESULTS];
+    int found = 0;
+    int maxEdits = ((int)strlen(query) - 1) / 2;
+
+    if (maxEdits > 2) maxEdits = 2;
+    for (int edits = 0; edits <= maxEdits && found == 0; edits++) {
+        found = searchMenuByName(session->canteen->menuSearch, query, edits, hits, KIOSK_SEARCH_RESULTS);
+    }
+    if (found == 0) {
+        say(session, "No items match \"%s\".\n", query);
+        return;
+    }
+    say(session, "ID\tName\tPrice\tQuantity\n");
+    for (int i = 0; i < found; i++) {
+        const Menu *item = hits[i].item;
+        say(session, "%d\t%s\t%.2f\t%d\n", item->id, item->name, item->price, item->quantity);
+    }
+}
+
+static void showReadyIn(KioskSession *session, const Order *order){
+    if (!session->canteen->eta) return;
+    uint64_t nanos = estimateOrderReadyIn(session->canteen->eta, order);
+    if (nanos == 0) {
+        say(session, "Ready for pickup.\n");
+    } else {
+        say(session, "Ready in about %llu min.\n", (unsigned long long)((nanos + 59999999999ULL) / 60000000000ULL));
+    }
+}
+
+static void showBill(KioskSession *session, const Order *order){
+    say(session, "\n========================================\n");
+    say(session, "           BILL\n");
+    say(session, "========================================\n");
+    say(session, "Order ID: %d\n", order->orderId);
+    say(session, "Customer: %s [%s]\n", order->consumerName, order->consumerUID);
+    say(session, "Date: %s", ctime(&order->orderTime));
+    say(session, "----------------------------------------\n");
+    say(session, "%-20s %5s %8s %10s\n", "Item", "Qty", "Price", "Total");
+    say(session, "----------------------------------------\n");
+    for (const OrderItem *line = order->items; line != NULL; line = line->next) {
+        say(session, "%-20s %5d %8.2f %10.2f\n", line->name, line->quantity,
+            line->unitPrice, line->unitPrice * line->quantity);
+    }
+    say(session, "----------------------------------------\n");
+    say(session, "TOTAL: %.2f\n", order->totalAmount);
+    say(session, "========================================\n");
+    say(session, "      Thank you! Visit again!\n\n");
+}
+
+/* ===============================
+   Prompts
+   =============================== */
+
+static void askChoice(KioskSession *session){
+    session->state = KIOSK_ASK_CHOICE;
+    say(session, "\n--- Consumer Menu ---\n"
+                 "1. View Menu\n"
+                 "2. Place Order\n"
+                 "3. Cancel Last Order\n"
+                 "4. View My Orders\n"
+                 "5. View Menu by Price\n"
+                 "6. Search Menu\n");
+    if (session->canteen->reservations) {
+        say(session, "7. Pre-order for Pickup\n"
+                     "8. Collect Pre-order\n");
+    }
+    say(session, "0. Exit\n"
+                 "Enter choice: ");
+}
+
+static void askItemId(KioskSession *session){
+    session->state = KIOSK_ASK_ITEM_ID;
+    say(session, "\nItem %d - Enter Menu ID (0 to cancel): ", session->linesEntered + 1);
+}
+
+/* ===============================
+   Steps
+   =============================== */
+
+static int parseNumber(const char *text, int *out){
+    char *end;
+    errno = 0;
+    long value = strtol(text, &end, 10);
+    if (errno || end == text || *end || value < -0x7FFFFFFFL || value > 0x7FFFFFFFL) return -1;
+    *out = (int)value;
+    return 0;
+}
+
+static void clearBasket(KioskSession *session){
+    discardOrderItems(session->basketHead);
+    session->basketHead = session->basketTail = NULL;
+    session->basketTotal = 0.0f;
+    session->preorder = 0;
+}
+
+static void identify(KioskSession *session, const char *uid){
+    Consumer **head = session->canteen->consumerHead;
+    Consumer *consumer = findConsumer(*head, uid);
+
+    if (!consumer) {
+        const char *name = session->name[0] ? session->name : uid;
+        addConsumer(head, uid, name, STUDENT);      /* linked in at the head */
+        consumer = *head;
+        say(session, "New consumer added: %s [%s]\n", name, uid);
+    }
+    session->consumer = consumer;
+    askChoice(session);
+}
+
+static void placeBasket(KioskSession *session){
+    KioskCanteen *canteen = session->canteen;
+    int orderId = canteen->nextOrderId;
+    IntakeResult result = INTAKE_ACCEPTED;
+    Order *order;
+
+    if (canteen->intake) {
+        order = submitOrder(canteen->intake, canteen->queue, orderId, session->consumer,
+                            session->basketHead, session->basketTotal, &result);
+    } else {
+        order = enqueueConsumerOrder(canteen->queue, orderId, session->consumer,
+                                     session->basketHead, session->basketTotal);
+    }
+    if (!order) {
+        say(session, "Order not accepted: %s.\n", intakeResultText(result));
+        clearBasket(session);       /* gives the stock back */
+        return;
+    }
+    canteen->nextOrderId = canteen->nextOrderId % UINT16_MAX + 1;
+    pushOrder(canteen->stack, order);
+    say(session, "Order placed successfully! Total: %.2f\n", session->basketTotal);
+    showReadyIn(session, order);
+    session->basketHead = session->basketTail = NULL;       /* now owned by the order */
+    session->basketTotal = 0.0f;
+}
+
+static void reserveBasket(KioskSession *session){
+    uint64_t deadline = clockNanos() + KIOSK_PREORDER_MINUTES * 60000000000ULL;
+    Reservation *reservation = reserveStock(session->canteen->reservations, session->consumer,
+                                            session->basketHead, session->basketTotal, deadline);
+
+    if (!reservation) {
+        say(session, "Pre-order not accepted.\n");
+        clearBasket(session);       /* gives the stock back */
+        return;
+    }
+    say(session, "Pre-order %d held for %d min. Total: %.2f\n", reservation->reservationId,
+        KIOSK_PREORDER_MINUTES, session->basketTotal);
+    session->basketHead = session->basketTail = NULL;       /* now owned by the reservation */
+    session->basketTotal = 0.0f;
+    session->preorder = 0;
+}
+
+static void collect(KioskSession *session, const char *answer){
+    KioskCanteen *canteen = session->canteen;
+    Reservation *reservation = NULL;
+    int reservationId;
+
+    if (parseNumber(answer, &reservationId) == 0) {
+        reservation = findReservation(canteen->reservations, reservationId);
+    }
+    if (!reservation || reservation->consumer != session->consumer) {
+        say(session, "No pre-order %s held for you.\n", answer);
+        return;
+    }
+    Order *order = claimReservation(canteen->reservations, reservation, canteen->queue, canteen->nextOrderId);
+    canteen->nextOrderId = canteen->nextOrderId % UINT16_MAX + 1;
+    pushOrder(canteen->stack, order);
+    say(session, "Pre-order collected as Order ID %d. Total: %.2f\n", order->orderId, order->totalAmount);
+    showReadyIn(session, order);
+}
+
+static void addLine(KioskSession *session, int quantity){
+    Menu *item = findMenuItem(session->canteen->menuHead, session->pendingMenuId);
+    Combo *combo = item || !session->canteen->combos ? NULL
+                 : findCombo(session->canteen->combos, session->pendingMenuId);
+    OrderItem *line;
+
+    if (combo) {
+        if (quantity < 1) {
+            say(session, "Invalid quantity!\n");
+        } else if (takeCombo(combo, quantity, &session->basketHead, &session->basketTail,
+                             &session->basketTotal) != 0) {
+            say(session, "Combo not available! Available: %d\n", comboAvailability(combo));
+        } else {
+            session->linesEntered++;
+        }
+    } else if (!item) {
+        say(session, "Invalid Menu ID!\n");
+    } else if (quantity < 1) {
+        say(session, "Invalid quantity!\n");
+    } else if (item->quantity < quantity) {
+        say(session, "Insufficient stock! Available: %d\n", item->quantity);
+    } else if (!(line = createOrderItem(item, quantity))) {
+        say(session, "Could not add the item, please try again.\n");
+    } else {
+        adjustItemQuantity(item, -quantity);
+        if (session->basketTail) session->basketTail->next = line;
+        else session->basketHead = line;
+        session->basketTail = line;
+        session->basketTotal += line->unitPrice * quantity;
+        session->linesEntered++;
+    }
+
+    if (session->linesEntered < session->linesWanted) {
+        askItemId(session);
+    } else {
+        if (session->preorder) reserveBasket(session);
+        else placeBasket(session);
+        askChoice(session);
+    }
+}
+
+static void cancelLast(KioskSession *session){
+    OrderStack *stack = session->canteen->stack;
+
+    if (!stack->top) {
+        say(session, "No order to cancel.\n");
+        return;
+    }
+    const Order *last = stack->top->order;
+    if (strcmp(last->consumerUID, session->consumer->uid) != 0) {
+        say(session, "Last order does not belong to you. Cannot cancel.\n");
+        return;
+    }
+    say(session, "\nCancelling Order ID: %d\nTotal Amount: %.2f\n", last->orderId, last->totalAmount);
+    int result = revertLastOrder(stack, session->canteen->queue);
+    if (result >= 0) {
+        say(session, "Order cancelled successfully! Amount refunded.\n");
+    } else if (result == -3) {
+        say(session, "The kitchen has already started this order. Cannot cancel.\n");
+    } else {
+        say(session, "Failed to cancel order.\n");
+    }
+}
+
+static void showOwnOrders(KioskSession *session){
+    const Consumer *consumer = session->consumer;
+    int found = 0;
+
+    say(session, "\n--- Past Orders for %s [%s] ---\n", consumer->name, consumer->uid);
+    for (const Order *order = session->canteen->queue->front; order != NULL; order = order->next) {
+        if (strcmp(order->consumerUID, consumer->uid) == 0) {
+            found = 1;
+            showBill(session, order);
+            showReadyIn(session, order);
+        }
+    }
+    if (!found) {
+        say(session, "No past orders.\n");
+    }
+}
+
+static void choose(KioskSession *session, const char *answer){
+    int choice;
+
+    if (parseNumber(answer, &choice) != 0) choice = -1;
+    switch (choice) {
+    case 1:
+        showMenu(session);
+        break;
+    case 2:
+    case 7:
+        if (choice == 7 && !session->canteen->reservations) {
+            say(session, "Invalid choice!\n");
+            break;
+        }
+        session->preorder = choice == 7;
+        say(session, "\n--- %s for %s [%s] ---\n", choice == 7 ? "Pre-order" : "Place Order",
+            session->consumer->name, session->consumer->uid);
+        showMenu(session);
+        say(session, "How many items to order? ");
+        session->state = KIOSK_ASK_ITEM_COUNT;
+        return;
+    case 3:
+        cancelLast(session);
+        break;
+    case 4:
+        showOwnOrders(session);
+        break;
+    case 5:
+        showMenuByPrice(session);
+        break;
+    case 6:
+        say(session, "Search for: ");
+        session->state = KIOSK_ASK_SEARCH;
+        return;
+    case 8:
+        if (!session->canteen->reservations) {
+            say(session, "Invalid choice!\n");
+            break;
+        }
+        say(session, "Pre-order ID: ");
+        session->state = KIOSK_ASK_RESERVATION;
+        return;
+    case 0:
+        say(session, "Exiting Consumer Interface...\n");
+        session->state = KIOSK_FINISHED;
+        return;
+    default:
+        say(session, "Invalid choice!\n");
+    }
+    askChoice(session);
+}
+
+/* ===============================
+   Session
+   =============================== */
+
+void kioskStart(KioskSession *session, KioskCanteen *canteen, KioskWriter write, void *context){
+    memset(session, 0, sizeof(*session));
+    session->state = KIOSK_ASK_NAME;
+    session->canteen = canteen;
+    session->write = write;
+    session->context = context;
+    say(session, "Enter your name: ");
+}
+
+int kioskInput(KioskSession *session, const char *line){
+    char answer[KIOSK_LINE_BUFFER];
+    int number;
+
+    /* trim the answer the way scanf(" %[^\n]") did */
+    while (isspace((unsigned char)*line)) line++;
+    size_t length = strlen(line);
+    while (length > 0 && isspace((unsigned char)line[length - 1])) length--;
+    if (length >= sizeof(answer)) length = sizeof(answer) - 1;
+    memcpy(answer, line, length);
+    answer[length] = '\0';
+
+    if (session->canteen->reservations) expireReservations(session->canteen->reservations);
+    switch (session->state) {
+    case KIOSK_ASK_NAME:
+        if (length >= KIOSK_NAME_LENGTH) length = KIOSK_NAME_LENGTH - 1;
+        memcpy(session->name, answer, length);
+        session->name[length] = '\0';
+        session->state = KIOSK_ASK_UID;
+        say(session, "Enter your UID: ");
+        break;
+    case KIOSK_ASK_UID:
+        if (length == 0) {
+            say(session, "Enter your UID: ");
+            break;
+        }
+        identify(session, answer);
+        break;
+    case KIOSK_ASK_CHOICE:
+        choose(session, answer);
+        break;
+    case KIOSK_ASK_ITEM_COUNT:
+        if (parseNumber(answer, &number) != 0 || number <= 0) {
+            session->preorder = 0;
+            askChoice(session);
+            break;
+        }
+        session->linesWanted = number;
+        session->linesEntered = 0;
+        askItemId(session);
+        break;
+    case KIOSK_ASK_ITEM_ID:
+        if (parseNumber(answer, &number) != 0) {
+            say(session, "Invalid Menu ID!\n");
+            askItemId(session);
+        } else if (number == 0) {
+            clearBasket(session);
+            say(session, "Order cancelled.\n");
+            askChoice(session);
+        } else {
+            session->pendingMenuId = number;
+            session->state = KIOSK_ASK_QUANTITY;
+            say(session, "Quantity: ");
+        }
+        break;
+    case KIOSK_ASK_QUANTITY:
+        if (parseNumber(answer, &number) != 0) number = 0;
+        addLine(session, number);
+        break;
+    case KIOSK_ASK_SEARCH:
+        showSearch(session, answer);
+        askChoice(session);
+        break;
+    case KIOSK_ASK_RESERVATION:
+        collect(session, answer);
+        askChoice(session);
+        break;
+    case KIOSK_FINISHED:
+        break;
+    }
+    return session->state != KIOSK_FINISHED;
+}
+
+void kioskEnd(KioskSession *session){
+    clearBasket(session);
+    session->state = KIOSK_FINISHED;
+}
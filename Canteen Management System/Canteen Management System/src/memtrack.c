@@ -0,0 +1,222 @@
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/memtrack.h"
+
+#define NO_SITE 0xFFFF
+#define BLOCK_MAGIC 0x4D454D54u     /* "MEMT" */
+#define SITE_SLOTS (MEM_MAX_SITES * 2)  /* power of two, at most half used */
+
+/* Placed in front of every block; the union keeps the payload aligned */
+typedef union {
+    struct {
+        size_t size;
+        uint16_t tag;
+        uint16_t site;
+        uint32_t magic;
+    } h;
+    max_align_t align;
+} BlockHeader;
+
+/* Counters are atomics, so allocating threads never wait on each other;
+   live blocks are allocations - frees, which saves one update per call */
+typedef struct {
+    atomic_long liveBytes;
+    atomic_long peakBytes;
+    atomic_long peakBlocks;
+    atomic_long allocations;
+    atomic_long frees;
+} TagCounters;
+
+enum { SITE_FREE, SITE_CLAIMED, SITE_READY };
+
+typedef struct {
+    atomic_int state;           /* SITE_*; file, line and tag are set once READY */
+    const char *file;
+    int line;
+    MemTag tag;
+    atomic_long liveBytes;
+    atomic_long liveBlocks;
+} AllocSite;
+
+static TagCounters usage[MEM_TAG_COUNT];
+static AllocSite sites[SITE_SLOTS];
+static atomic_int siteCount;
+
+static const char *tagNames[MEM_TAG_COUNT] = { "menu", "consumers", "users", "orders", "undo", "archive", "reports" };
+
+static inline long addCounter(atomic_long *counter, long n){
+    return atomic_fetch_add_explicit(counter, n, memory_order_relaxed) + n;
+}
+
+static inline long readCounter(atomic_long *counter){
+    return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+static void raisePeak(atomic_long *peak, long value){
+    long seen = readCounter(peak);
+    while (value > seen &&
+           !atomic_compare_exchange_weak_explicit(peak, &seen, value,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+/*
+ * Sites are keyed by the __FILE__ pointer and line, hashed into an
+ * open-addressing table: a known site is found without locks or string
+ * compares, and a new one is claimed with one compare-and-swap.
+ */
+static uint16_t siteOf(MemTag tag, const char *file, int line){
+    uint32_t hash = (uint32_t)((uintptr_t)file >> 3) * 2654435761u ^ (uint32_t)line * 40503u ^ (uint32_t)tag;
+    for (int probe = 0; probe < SITE_SLOTS; probe++) {
+        AllocSite *site = &sites[(hash + probe) & (SITE_SLOTS - 1)];
+        int state = atomic_load_explicit(&site->state, memory_order_acquire);
+        if (state == SITE_FREE) {
+            if (atomic_load_explicit(&siteCount, memory_order_relaxed) >= MEM_MAX_SITES) return NO_SITE;
+            if (atomic_compare_exchange_strong(&site->state, &state, SITE_CLAIMED)) {
+                site->file = file;
+                site->line = line;
+                site->tag = tag;
+                atomic_fetch_add(&siteCount, 1);
+                atomic_store_explicit(&site->state, SITE_READY, memory_order_release);
+                return (uint16_t)(site - sites);
+            }
+        }
+        while (state == SITE_CLAIMED) {     /* another thread is filling it in */
+            state = atomic_load_explicit(&site->state, memory_order_acquire);
+        }
+        if (state == SITE_READY && site->file == file && site->line == line && site->tag == tag) {
+            return (uint16_t)(site - sites);
+        }
+    }
+    return NO_SITE;
+}
+
+void* trackedAlloc(MemTag tag, size_t size, int zero, const char *file, int line){
+    BlockHeader *block = (BlockHeader *)(zero ? calloc(1, sizeof(BlockHeader) + size)
+                                              : malloc(sizeof(BlockHeader) + size));
+    if (!block) return NULL;
+
+    TagCounters *u = &usage[tag];
+    long blocks = addCounter(&u->allocations, 1) - readCounter(&u->frees);
+    raisePeak(&u->peakBytes, addCounter(&u->liveBytes, (long)size));
+    raisePeak(&u->peakBlocks, blocks);
+    uint16_t site = siteOf(tag, file, line);
+    if (site != NO_SITE) {
+        addCounter(&sites[site].liveBlocks, 1);
+        addCounter(&sites[site].liveBytes, (long)size);
+    }
+
+    block->h.size = size;
+    block->h.tag = (uint16_t)tag;
+    block->h.site = site;
+    block->h.magic = BLOCK_MAGIC;
+    return block + 1;
+}
+
+static BlockHeader* headerOf(void *ptr, const char *caller){
+    BlockHeader *block = (BlockHeader *)ptr - 1;
+    if (block->h.magic != BLOCK_MAGIC) {
+        fprintf(stderr, "%s: %p was not allocated by memAlloc\n", caller, ptr);
+        abort();
+    }
+    return block;
+}
+
+void* trackedRealloc(MemTag tag, void *ptr, size_t size, const char *file, int line){
+    if (!ptr) return trackedAlloc(tag, size, 0, file, line);
+    BlockHeader *block = headerOf(ptr, "memRealloc");
+    size_t oldSize = block->h.size;
+    BlockHeader *grown = (BlockHeader *)realloc(block, sizeof(BlockHeader) + size);
+    if (!grown) return NULL;
+
+    long change = (long)size - (long)oldSize;
+    TagCounters *u = &usage[grown->h.tag];
+    raisePeak(&u->peakBytes, addCounter(&u->liveBytes, change));
+    if (grown->h.site != NO_SITE) {
+        addCounter(&sites[grown->h.site].liveBytes, change);
+    }
+    grown->h.size = size;
+    return grown + 1;
+}
+
+char* trackedStrdup(MemTag tag, const char *s, const char *file, int line){
+    size_t length = strlen(s) + 1;
+    char *copy = (char *)trackedAlloc(tag, length, 0, file, line);
+    if (copy) memcpy(copy, s, length);
+    return copy;
+}
+
+void trackedFree(void *ptr){
+    if (!ptr) return;
+    BlockHeader *block = headerOf(ptr, "memFree");
+
+    TagCounters *u = &usage[block->h.tag];
+    addCounter(&u->frees, 1);
+    addCounter(&u->liveBytes, -(long)block->h.size);
+    if (block->h.site != NO_SITE) {
+        addCounter(&sites[block->h.site].liveBlocks, -1);
+        addCounter(&sites[block->h.site].liveBytes, -(long)block->h.size);
+    }
+
+    block->h.magic = 0;     /* catches double frees */
+    free(block);
+}
+
+void getMemoryUsage(MemTag tag, MemUsage *out){
+    TagCounters *u = &usage[tag];
+    out->liveBytes = readCounter(&u->liveBytes);
+    out->frees = readCounter(&u->frees);
+    out->allocations = readCounter(&u->allocations);
+    out->liveBlocks = out->allocations - out->frees;
+    out->peakBytes = readCounter(&u->peakBytes);
+    out->peakBlocks = readCounter(&u->peakBlocks);
+}
+
+void displayMemoryUsage(FILE *out){
+    MemUsage total = { 0, 0, 0, 0, 0, 0 };
+
+    fprintf(out, "\n%-10s %12s %10s %12s %10s %10s %10s\n",
+            "Subsystem", "Live bytes", "Blocks", "Peak bytes", "Peak", "Allocs", "Frees");
+    fprintf(out, "------------------------------------------------------------------------------\n");
+    for (int t = 0; t < MEM_TAG_COUNT; t++) {
+        MemUsage u;
+        getMemoryUsage((MemTag)t, &u);
+        fprintf(out, "%-10s %12ld %10ld %12ld %10ld %10ld %10ld\n", tagNames[t],
+                u.liveBytes, u.liveBlocks, u.peakBytes, u.peakBlocks, u.allocations, u.frees);
+        total.liveBytes += u.liveBytes;
+        total.liveBlocks += u.liveBlocks;
+        total.allocations += u.allocations;
+        total.frees += u.frees;
+    }
+    fprintf(out, "------------------------------------------------------------------------------\n");
+    fprintf(out, "%-10s %12ld %10ld %12s %10s %10ld %10ld\n", "Total",
+            total.liveBytes, total.liveBlocks, "-", "-", total.allocations, total.frees);
+    fprintf(out, "(payload bytes; each block also carries a %d-byte header)\n", (int)sizeof(BlockHeader));
+}
+
+long reportMemoryLeaks(FILE *out){
+    long leaked = 0, untracked = 0;
+
+    for (int t = 0; t < MEM_TAG_COUNT; t++) {
+        leaked += readCounter(&usage[t].allocations) - readCounter(&usage[t].frees);
+    }
+    untracked = leaked;
+    for (int i = 0; i < SITE_SLOTS; i++) {
+        AllocSite *s = &sites[i];
+        long blocks = readCounter(&s->liveBlocks);
+        if (atomic_load(&s->state) != SITE_READY || blocks == 0) continue;
+        fprintf(out, "leak: %s:%d (%s) %ld block(s), %ld bytes\n",
+                s->file, s->line, tagNames[s->tag], blocks, readCounter(&s->liveBytes));
+        untracked -= blocks;
+    }
+
+    if (untracked > 0) {
+        fprintf(out, "leak: %ld block(s) from sites beyond MEM_MAX_SITES\n", untracked);
+    }
+    if (leaked > 0) {
+        fprintf(out, "%ld block(s) still allocated at shutdown\n", leaked);
+    }
+    return leaked;
+}
@@ -0,0 +1,215 @@
+#include "../include/menuindex.h"
+#include "../include/memtrack.h"
+
+float menuIndexKey(const Menu *item, MenuOrder order){
+    switch (order) {
+        case MENU_BY_PRICE:
+            return item->price;
+        case MENU_BY_TYPE:
+            return (float)item->type;
+        default:
+            return (float)item->quantity;
+    }
+}
+
+/* Orders two items; ties fall back to price (for type) and then ID */
+static int compareItems(const Menu *a, const Menu *b, MenuOrder order){
+    float ka = menuIndexKey(a, order);
+    float kb = menuIndexKey(b, order);
+    if (ka != kb) return ka < kb ? -1 : 1;
+    if (order == MENU_BY_TYPE && a->price != b->price) {
+        return a->price < b->price ? -1 : 1;
+    }
+    if (a->id != b->id) return a->id < b->id ? -1 : 1;
+    if (a != b) return a < b ? -1 : 1;
+    return 0;
+}
+
+static MenuIndexNode* createNode(Menu *item, int level){
+    MenuIndexNode *node = (MenuIndexNode *)memAlloc(MEM_MENU, sizeof(MenuIndexNode) + level * sizeof(MenuIndexNode *));
+    if (!node) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    node->item = item;
+    node->level = level;
+    for (int i = 0; i < level; i++) {
+        node->forward[i] = NULL;
+    }
+    return node;
+}
+
+static int randomLevel(MenuIndex *index){
+    int level = 1;
+    uint32_t x = index->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    index->seed = x;
+    /* each extra level has probability 1/4 */
+    while (level < MENU_INDEX_MAX_LEVEL && (x & 3) == 0) {
+        level++;
+        x >>= 2;
+    }
+    return level;
+}
+
+/* Fills update[] with the last node before item on each level */
+static void findPath(MenuIndex *index, MenuOrder order, const Menu *item, MenuIndexNode **update){
+    MenuIndexNode *node = index->heads[order];
+    for (int i = index->levels[order] - 1; i >= 0; i--) {
+        while (node->forward[i] && compareItems(node->forward[i]->item, item, order) < 0) {
+            node = node->forward[i];
+        }
+        update[i] = node;
+    }
+}
+
+static void insertItem(MenuIndex *index, MenuOrder order, Menu *item){
+    MenuIndexNode *update[MENU_INDEX_MAX_LEVEL];
+    findPath(index, order, item, update);
+
+    int level = randomLevel(index);
+    MenuIndexNode *node = createNode(item, level);
+    if (!node) return;
+    for (int i = index->levels[order]; i < level; i++) {
+        update[i] = index->heads[order];
+    }
+    if (level > index->levels[order]) {
+        index->levels[order] = level;
+    }
+    for (int i = 0; i < level; i++) {
+        node->forward[i] = update[i]->forward[i];
+        update[i]->forward[i] = node;
+    }
+}
+
+static void removeItem(MenuIndex *index, MenuOrder order, Menu *item){
+    MenuIndexNode *update[MENU_INDEX_MAX_LEVEL];
+    findPath(index, order, item, update);
+
+    MenuIndexNode *node = update[0]->forward[0];
+    if (!node || node->item != item) return;
+    for (int i = 0; i < node->level; i++) {
+        update[i]->forward[i] = node->forward[i];
+    }
+    while (index->levels[order] > 1 && index->heads[order]->forward[index->levels[order] - 1] == NULL) {
+        index->levels[order]--;
+    }
+    memFree(node);
+}
+
+static void onMenuChange(Menu *item, MenuEvent event, void *context){
+    MenuIndex *index = (MenuIndex *)context;
+    switch (event) {
+        case MENU_ITEM_ADDED:
+            for (int o = 0; o < MENU_ORDER_COUNT; o++) insertItem(index, o, item);
+            index->count++;
+            break;
+        case MENU_ITEM_EDITING:
+            removeItem(index, MENU_BY_PRICE, item);
+            removeItem(index, MENU_BY_TYPE, item);
+            break;
+        case MENU_ITEM_EDITED:
+            insertItem(index, MENU_BY_PRICE, item);
+            insertItem(index, MENU_BY_TYPE, item);
+            break;
+        case MENU_STOCK_CHANGING:
+            removeItem(index, MENU_BY_QUANTITY, item);
+            break;
+        case MENU_STOCK_CHANGED:
+            insertItem(index, MENU_BY_QUANTITY, item);
+            break;
+        case MENU_ITEM_REMOVING:
+            for (int o = 0; o < MENU_ORDER_COUNT; o++) removeItem(index, o, item);
+            index->count--;
+            break;
+    }
+}
+
+MenuIndex* createMenuIndex(Menu *head){
+    MenuIndex *index = (MenuIndex *)memAlloc(MEM_MENU, sizeof(MenuIndex));
+    if (!index) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    index->count = 0;
+    index->seed = 0x9E3779B9u;
+    for (int o = 0; o < MENU_ORDER_COUNT; o++) {
+        index->heads[o] = createNode(NULL, MENU_INDEX_MAX_LEVEL);
+        index->levels[o] = 1;
+    }
+    for (int o = 0; o < MENU_ORDER_COUNT; o++) {
+        if (!index->heads[o]) {
+            freeMenuIndex(index);
+            return NULL;
+        }
+    }
+    for (Menu *current = head; current != NULL; current = current->next) {
+        onMenuChange(current, MENU_ITEM_ADDED, index);
+    }
+    if (addMenuObserver(onMenuChange, index) != 0) {
+        freeMenuIndex(index);
+        return NULL;
+    }
+    return index;
+}
+
+Menu* menuIndexSeek(MenuIndex *index, MenuOrder order, float fromKey, MenuIndexCursor *cursor){
+    MenuIndexNode *node = index->heads[order];
+    for (int i = index->levels[order] - 1; i >= 0; i--) {
+        while (node->forward[i] && menuIndexKey(node->forward[i]->item, order) < fromKey) {
+            node = node->forward[i];
+        }
+    }
+    cursor->node = node->forward[0];
+    return cursor->node ? cursor->node->item : NULL;
+}
+
+Menu* menuIndexNext(MenuIndexCursor *cursor){
+    if (cursor->node == NULL) return NULL;
+    cursor->node = cursor->node->forward[0];
+    return cursor->node ? cursor->node->item : NULL;
+}
+
+static void printItem(const Menu *item){
+    const char *typeStr = (item->type == FOOD) ? "FOOD" : (item->type == DRINK) ? "DRINK" : "DESERT";
+    printf("%d\t%s\t%s\t%.2f\t%d\n", item->id, item->name, typeStr, item->price, item->quantity);
+}
+
+void displayMenuSorted(MenuIndex *index, MenuOrder order){
+    MenuIndexCursor cursor;
+    printf("Menu Items:\n");
+    printf("ID\tName\tType\tPrice\tQuantity\n");
+    for (Menu *item = menuIndexSeek(index, order, -1.0f, &cursor); item; item = menuIndexNext(&cursor)) {
+        printItem(item);
+    }
+}
+
+void displayMenuRange(MenuIndex *index, MenuOrder order, float lo, float hi){
+    MenuIndexCursor cursor;
+    int found = 0;
+    printf("ID\tName\tType\tPrice\tQuantity\n");
+    for (Menu *item = menuIndexSeek(index, order, lo, &cursor); item; item = menuIndexNext(&cursor)) {
+        if (menuIndexKey(item, order) > hi) break;
+        printItem(item);
+        found = 1;
+    }
+    if (!found) {
+        printf("No matching items.\n");
+    }
+}
+
+void freeMenuIndex(MenuIndex *index){
+    if (!index) return;
+    removeMenuObserver(onMenuChange, index);
+    for (int o = 0; o < MENU_ORDER_COUNT; o++) {
+        MenuIndexNode *node = index->heads[o];
+        while (node != NULL) {
+            MenuIndexNode *next = node->forward[0];
+            memFree(node);
+            node = next;
+        }
+    }
+    memFree(index);
+}
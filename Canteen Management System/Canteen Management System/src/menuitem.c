@@ -1,17 +1,70 @@
 #include"../include/menuitem.h"
+#include "../include/metrics.h"
+#include "../include/memtrack.h"
+#include "../include/recorder.h"
 
+static struct {
+    MenuObserver observer;
+    void *context;
+} observers[MAX_MENU_OBSERVERS];
+static int observerCount = 0;
+static MenuNameReclaimer nameReclaimer = NULL;
+static void *nameReclaimerContext = NULL;
+
+static void notifyObservers(Menu *item, MenuEvent event){
+    for (int i = 0; i < observerCount; i++) {
+        observers[i].observer(item, event, observers[i].context);
+    }
+}
+
+int addMenuObserver(MenuObserver observer, void *context){
+    if (observerCount == MAX_MENU_OBSERVERS) {
+        fprintf(stderr, "Too many menu observers\n");
+        return -1;
+    }
+    observers[observerCount].observer = observer;
+    observers[observerCount].context = context;
+    observerCount++;
+    return 0;
+}
+
+int setMenuNameReclaimer(MenuNameReclaimer reclaimer, void *context){
+    if (!reclaimer) {
+        /* only the owner may step down */
+        if (context == nameReclaimerContext) {
+            nameReclaimer = NULL;
+            nameReclaimerContext = NULL;
+        }
+        return 0;
+    }
+    if (nameReclaimer) return -1;
+    nameReclaimer = reclaimer;
+    nameReclaimerContext = context;
+    return 0;
+}
+
+void removeMenuObserver(MenuObserver observer, void *context){
+    for (int i = 0; i < observerCount; i++) {
+        if (observers[i].observer == observer && observers[i].context == context) {
+            observers[i] = observers[--observerCount];
+            return;
+        }
+    }
+}
 
 Menu* createMenuItem(int id, const char *name, ItemType type, float price, uint16_t quantity){
-    Menu *newItem = (Menu *)malloc(sizeof(Menu));
+    Menu *newItem = (Menu *)memAlloc(MEM_MENU, sizeof(Menu));
     if (!newItem) {
         fprintf(stderr, "Memory allocation failed\n");
         return NULL;
     }
     newItem->id = id;
-    newItem->name = strdup(name);
+    newItem->name = memStrdup(MEM_MENU, name);
     newItem->type = type;
     newItem->price = price;
     newItem->quantity = quantity;
+    newItem->refCount = 0;
+    newItem->retired = 0;
     newItem->prev = NULL;
     newItem->next = NULL;
     return newItem;
@@ -30,16 +83,19 @@ void addMenuItem(Menu **head, int id, const char *name, ItemType type, float pri
         temp->next = newItem;
         newItem->prev = temp;
     }
+    notifyObservers(newItem, MENU_ITEM_ADDED);
+    RECORD_OP(recordMenuItem(newItem));
 }
 Menu* findMenuItem(Menu *head, int id){
+    METRIC_START(started);
+    RECORD_OP(recordMenuLookup(id));
     Menu *current = head;
-    while (current != NULL) {
-        if (current->id == id) {
-            return current;
-        }
+    while (current != NULL && current->id != id) {
         current = current->next;
     }
-    return NULL;
+    if (current == NULL) METRIC_COUNT(COUNTER_MENU_MISSES, 1);
+    METRIC_STOP(METRIC_MENU_LOOKUP, started);
+    return current;
 }
 
 void displayMenu(Menu *head){
@@ -55,10 +111,21 @@ void displayMenu(Menu *head){
 void editMenuItem(Menu *head, int id, const char *newName, ItemType newType, float newPrice){
     Menu *item = findMenuItem(head, id);
     if (item != NULL) {
-        free(item->name);
-        item->name = strdup(newName);
+        /* copy first: a failed copy leaves the item as it was */
+        char *name = memStrdup(MEM_MENU, newName);
+        if (!name) {
+            fprintf(stderr, "Memory allocation failed\n");
+            return;
+        }
+        notifyObservers(item, MENU_ITEM_EDITING);
+        char *oldName = item->name;
+        item->name = name;
+        /* readers may still hold the old name: let the reclaimer decide when it goes */
+        if (nameReclaimer) nameReclaimer(oldName, nameReclaimerContext);
+        else memFree(oldName);
         item->type = newType;
         item->price = newPrice;
+        notifyObservers(item, MENU_ITEM_EDITED);
     } else {
         printf("Menu item with ID %d not found.\n", id);
     }
@@ -66,23 +133,73 @@ void editMenuItem(Menu *head, int id, const char *newName, ItemType newType, flo
 void updateQuantity(Menu *head, int id, int change){
     Menu *item = findMenuItem(head, id);
     if (item != NULL) {
-        int newQuantity = item->quantity + change;
-        if (newQuantity < 0) {
+        if (adjustItemQuantity(item, change) != 0) {
             printf("Insufficient stock for item ID %d.\n", id);
-        } else {
-            item->quantity = newQuantity;
         }
     } else {
         printf("Menu item with ID %d not found.\n", id);
     }
 }
+int adjustItemQuantity(Menu *item, int change){
+    int newQuantity = item->quantity + change;
+    if (newQuantity < 0 || newQuantity > UINT16_MAX) {
+        METRIC_COUNT(COUNTER_STOCK_REJECTED, 1);
+        return -1;
+    }
+    METRIC_START(started);
+    notifyObservers(item, MENU_STOCK_CHANGING);
+    item->quantity = (uint16_t)newQuantity;
+    notifyObservers(item, MENU_STOCK_CHANGED);
+    METRIC_STOP(METRIC_STOCK_UPDATE, started);
+    return 0;
+}
+int removeMenuItem(Menu **head, int id){
+    Menu *item = findMenuItem(*head, id);
+    if (item == NULL) {
+        printf("Menu item with ID %d not found.\n", id);
+        return -1;
+    }
+    notifyObservers(item, MENU_ITEM_REMOVING);
+    if (item->prev) {
+        item->prev->next = item->next;
+    } else {
+        *head = item->next;
+    }
+    if (item->next) {
+        item->next->prev = item->prev;
+    }
+    item->prev = NULL;
+    item->next = NULL;
+    item->retired = 1;
+    if (item->refCount == 0) {
+        memFree(item->name);
+        memFree(item);
+    }
+    return 0;
+}
+void retainMenuItem(Menu *item){
+    item->refCount++;
+}
+void releaseMenuItem(Menu *item){
+    item->refCount--;
+    if (item->refCount == 0 && item->retired) {
+        memFree(item->name);
+        memFree(item);
+    }
+}
 void freeMenu(Menu *head){
     Menu *current = head;
     Menu *nextItem;
     while (current != NULL) {
         nextItem = current->next;
-        free(current->name);
-        free(current);
+        /* still referenced by an order: the last release frees it */
+        current->retired = 1;
+        current->prev = NULL;
+        current->next = NULL;
+        if (current->refCount == 0) {
+            memFree(current->name);
+            memFree(current);
+        }
         current = nextItem;
     }
 }
\ No newline at end of file
@@ -0,0 +1,267 @@
+#include <ctype.h>
+#include "../include/menusearch.h"
+#include "../include/metrics.h"
+#include "../include/memtrack.h"
+
+static int slotOf(char c){
+    unsigned char u = (unsigned char)tolower((unsigned char)c);
+    if (u >= 'a' && u <= 'z') return u - 'a';
+    if (u >= '0' && u <= '9') return 26 + (u - '0');
+    return 36;
+}
+
+/* Index of the lowest set bit; mask must be non-zero */
+static int lowestSlot(uint64_t mask){
+    int slot = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        slot++;
+    }
+    return slot;
+}
+
+static MenuSearchNode* createNode(void){
+    MenuSearchNode *node = (MenuSearchNode *)memCalloc(MEM_MENU, 1, sizeof(MenuSearchNode));
+    if (!node) {
+        fprintf(stderr, "Memory allocation failed\n");
+    }
+    return node;
+}
+
+static void insertWord(MenuSearch *search, const char *word, Menu *item){
+    MenuSearchNode *node = search->root;
+    node->subtreeCount++;
+    for (const char *p = word; *p; p++) {
+        int slot = slotOf(*p);
+        if (!node->children[slot]) {
+            node->children[slot] = createNode();
+            if (!node->children[slot]) return;
+            node->childMask |= (uint64_t)1 << slot;
+        }
+        node = node->children[slot];
+        node->subtreeCount++;
+    }
+    if (node->itemCount == node->itemCapacity) {
+        int capacity = node->itemCapacity ? node->itemCapacity * 2 : 2;
+        Menu **items = (Menu **)memRealloc(MEM_MENU, node->items, capacity * sizeof(Menu *));
+        if (!items) {
+            fprintf(stderr, "Memory allocation failed\n");
+            return;
+        }
+        node->items = items;
+        node->itemCapacity = capacity;
+    }
+    node->items[node->itemCount++] = item;
+}
+
+static void removeWord(MenuSearch *search, const char *word, Menu *item){
+    MenuSearchNode *node = search->root;
+    for (const char *p = word; *p && node; p++) {
+        node = node->children[slotOf(*p)];
+    }
+    if (!node) return;
+    for (int i = 0; i < node->itemCount; i++) {
+        if (node->items[i] == item) {
+            node->items[i] = node->items[--node->itemCount];
+            /* walk again to fix the counts along the path */
+            MenuSearchNode *n = search->root;
+            n->subtreeCount--;
+            for (const char *p = word; *p; p++) {
+                n = n->children[slotOf(*p)];
+                n->subtreeCount--;
+            }
+            return;
+        }
+    }
+}
+
+/* Indexes (or unindexes) every word start of the item's name */
+static void forEachWord(MenuSearch *search, Menu *item, int insert){
+    const char *name = item->name;
+    for (const char *p = name; *p; p++) {
+        if (p == name || (!isalnum((unsigned char)p[-1]) && isalnum((unsigned char)*p))) {
+            if (insert) insertWord(search, p, item);
+            else removeWord(search, p, item);
+        }
+    }
+}
+
+static void onMenuChange(Menu *item, MenuEvent event, void *context){
+    MenuSearch *search = (MenuSearch *)context;
+    if (event == MENU_ITEM_ADDED || event == MENU_ITEM_EDITED) {
+        forEachWord(search, item, 1);
+    } else if (event == MENU_ITEM_EDITING || event == MENU_ITEM_REMOVING) {
+        forEachWord(search, item, 0);
+    }
+}
+
+MenuSearch* createMenuSearch(Menu *head){
+    MenuSearch *search = (MenuSearch *)memAlloc(MEM_MENU, sizeof(MenuSearch));
+    if (!search) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    search->root = createNode();
+    if (!search->root) {
+        memFree(search);
+        return NULL;
+    }
+    for (Menu *current = head; current != NULL; current = current->next) {
+        forEachWord(search, current, 1);
+    }
+    if (addMenuObserver(onMenuChange, search) != 0) {
+        freeMenuSearch(search);
+        return NULL;
+    }
+    return search;
+}
+
+/* ===============================
+   Query evaluation
+   =============================== */
+
+typedef struct {
+    const int *query;
+    int length;
+    int maxEdits;
+    MenuSearchHit *hits;
+    int k;
+    int found;
+} SearchState;
+
+/* Returns 1 if a is a better hit than b */
+static int betterHit(const MenuSearchHit *a, const MenuSearchHit *b){
+    if (a->distance != b->distance) return a->distance < b->distance;
+    if (a->exact != b->exact) return a->exact > b->exact;
+    size_t la = strlen(a->item->name), lb = strlen(b->item->name);
+    if (la != lb) return la < lb;
+    return a->item->id < b->item->id;
+}
+
+static void offerHit(SearchState *state, Menu *item, int distance, int exact){
+    MenuSearchHit hit = { item, distance, exact };
+    int pos;
+
+    for (pos = 0; pos < state->found; pos++) {
+        if (state->hits[pos].item == item) {
+            if (!betterHit(&hit, &state->hits[pos])) return;
+            /* drop the weaker duplicate, then reinsert below */
+            memmove(&state->hits[pos], &state->hits[pos + 1],
+                    (state->found - pos - 1) * sizeof(MenuSearchHit));
+            state->found--;
+            break;
+        }
+    }
+    pos = state->found;
+    while (pos > 0 && betterHit(&hit, &state->hits[pos - 1])) pos--;
+    if (pos >= state->k) return;
+    int last = state->found < state->k ? state->found : state->k - 1;
+    memmove(&state->hits[pos + 1], &state->hits[pos], (last - pos) * sizeof(MenuSearchHit));
+    state->hits[pos] = hit;
+    if (state->found < state->k) state->found++;
+}
+
+/* Collects every item below node; the query is already matched */
+static void collectSubtree(SearchState *state, MenuSearchNode *node, int distance, int depth){
+    if (state->found == state->k && distance > state->hits[state->k - 1].distance) return;
+    for (int i = 0; i < node->itemCount; i++) {
+        offerHit(state, node->items[i], distance, distance == 0 && depth == state->length);
+    }
+    for (uint64_t mask = node->childMask; mask; mask &= mask - 1) {
+        MenuSearchNode *child = node->children[lowestSlot(mask)];
+        if (child->subtreeCount > 0) {
+            collectSubtree(state, child, distance, depth + 1);
+        }
+    }
+}
+
+static void walk(SearchState *state, MenuSearchNode *node, const int *prevRow, int depth){
+    for (uint64_t mask = node->childMask; mask; mask &= mask - 1) {
+        int c = lowestSlot(mask);
+        MenuSearchNode *child = node->children[c];
+        if (child->subtreeCount == 0) continue;
+
+        int row[MENU_SEARCH_MAX_QUERY + 1];
+        int rowMin;
+        row[0] = prevRow[0] + 1;
+        rowMin = row[0];
+        for (int j = 1; j <= state->length; j++) {
+            int cost = state->query[j - 1] == c ? 0 : 1;
+            int best = prevRow[j - 1] + cost;
+            if (prevRow[j] + 1 < best) best = prevRow[j] + 1;
+            if (row[j - 1] + 1 < best) best = row[j - 1] + 1;
+            row[j] = best;
+            if (best < rowMin) rowMin = best;
+        }
+
+        if (row[state->length] <= state->maxEdits) {
+            /* the whole query matches this path; everything below qualifies */
+            collectSubtree(state, child, row[state->length], depth + 1);
+            if (row[state->length] == 0) continue;
+        }
+        if (rowMin <= state->maxEdits) {
+            walk(state, child, row, depth + 1);
+        }
+    }
+}
+
+int searchMenuByName(MenuSearch *search, const char *query, int maxEdits,
+                     MenuSearchHit *hits, int k){
+    int slots[MENU_SEARCH_MAX_QUERY];
+    int row[MENU_SEARCH_MAX_QUERY + 1];
+    int length = 0;
+
+    if (!search || !query || k <= 0) return 0;
+    METRIC_START(started);
+    for (const char *p = query; *p && length < MENU_SEARCH_MAX_QUERY; p++) {
+        slots[length++] = slotOf(*p);
+    }
+
+    SearchState state = { slots, length, maxEdits, hits, k, 0 };
+    for (int j = 0; j <= length; j++) row[j] = j;
+    if (length <= maxEdits) {
+        collectSubtree(&state, search->root, length, 0);
+    } else {
+        walk(&state, search->root, row, 0);
+    }
+    METRIC_STOP(METRIC_MENU_SEARCH, started);
+    return state.found;
+}
+
+void displaySearchResults(MenuSearch *search, const char *query, int k){
+    MenuSearchHit hits[16];
+    int found = 0;
+
+    if (k > 16) k = 16;
+    /* short queries get fewer edits, otherwise everything matches */
+    int maxEdits = ((int)strlen(query) - 1) / 2;
+    if (maxEdits > 2) maxEdits = 2;
+    for (int edits = 0; edits <= maxEdits && found == 0; edits++) {
+        found = searchMenuByName(search, query, edits, hits, k);
+    }
+    if (found == 0) {
+        printf("No items match \"%s\".\n", query);
+        return;
+    }
+    printf("ID\tName\tPrice\tQuantity\n");
+    for (int i = 0; i < found; i++) {
+        Menu *item = hits[i].item;
+        printf("%d\t%s\t%.2f\t%d\n", item->id, item->name, item->price, item->quantity);
+    }
+}
+
+static void freeNode(MenuSearchNode *node){
+    if (!node) return;
+    for (int c = 0; c < MENU_SEARCH_ALPHABET; c++) {
+        freeNode(node->children[c]);
+    }
+    memFree(node->items);
+    memFree(node);
+}
+
+void freeMenuSearch(MenuSearch *search){
+    if (!search) return;
+    removeMenuObserver(onMenuChange, search);
+    freeNode(search->root);
+    memFree(search);
+}
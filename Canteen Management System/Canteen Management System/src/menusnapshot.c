@@ -0,0 +1,234 @@
+#include "../include/menusnapshot.h"
+#include "../include/memtrack.h"
+
+static int compareEntries(const void *a, const void *b){
+    const MenuEntry *x = (const MenuEntry *)a;
+    const MenuEntry *y = (const MenuEntry *)b;
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+static void freeSnapshot(MenuSnapshot *snapshot){
+    if (!snapshot) return;
+    for (int i = 0; i < snapshot->count; i++) {
+        memFree(snapshot->entries[i].name);
+    }
+    memFree(snapshot->entries);
+    memFree(snapshot);
+}
+
+/* Copies every item of the list except skip (which is being removed) */
+static MenuSnapshot* buildSnapshot(Menu *head, const Menu *skip, uint64_t version){
+    int count = 0;
+    for (Menu *current = head; current != NULL; current = current->next) {
+        if (current != skip) count++;
+    }
+
+    MenuSnapshot *snapshot = (MenuSnapshot *)memAlloc(MEM_MENU, sizeof(MenuSnapshot));
+    if (!snapshot) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    snapshot->version = version;
+    snapshot->count = 0;
+    snapshot->retireEpoch = 0;
+    snapshot->nextRetired = NULL;
+    snapshot->entries = (MenuEntry *)memAlloc(MEM_MENU, (count ? count : 1) * sizeof(MenuEntry));
+    if (!snapshot->entries) {
+        fprintf(stderr, "Memory allocation failed\n");
+        memFree(snapshot);
+        return NULL;
+    }
+    for (Menu *current = head; current != NULL; current = current->next) {
+        if (current == skip) continue;
+        MenuEntry *entry = &snapshot->entries[snapshot->count++];
+        entry->id = current->id;
+        entry->name = memStrdup(MEM_MENU, current->name);
+        entry->type = current->type;
+        entry->price = current->price;
+        entry->quantity = current->quantity;
+    }
+    qsort(snapshot->entries, snapshot->count, sizeof(MenuEntry), compareEntries);
+    return snapshot;
+}
+
+/* Frees retired snapshots and names older than every pinned reader epoch */
+static void reclaim(MenuStore *store){
+    uint64_t oldest = UINT64_MAX;
+    for (int i = 0; i < MAX_MENU_READERS; i++) {
+        uint64_t pinned = atomic_load(&store->readers[i]);
+        if (pinned != 0 && pinned < oldest) {
+            oldest = pinned;
+        }
+    }
+
+    MenuSnapshot **link = &store->retired;
+    while (*link != NULL) {
+        MenuSnapshot *snapshot = *link;
+        if (snapshot->retireEpoch < oldest) {
+            *link = snapshot->nextRetired;
+            freeSnapshot(snapshot);
+        } else {
+            link = &snapshot->nextRetired;
+        }
+    }
+
+    RetiredName **nameLink = &store->retiredNames;
+    while (*nameLink != NULL) {
+        RetiredName *retired = *nameLink;
+        if (retired->retireEpoch < oldest) {
+            *nameLink = retired->next;
+            memFree(retired->name);
+            memFree(retired);
+        } else {
+            nameLink = &retired->next;
+        }
+    }
+}
+
+/* Name reclaimer: the old name lives until readers pinned before the edit are done */
+static void retireName(char *name, void *context){
+    MenuStore *store = (MenuStore *)context;
+    RetiredName *retired = (RetiredName *)memAlloc(MEM_MENU, sizeof(RetiredName));
+    if (!retired) {
+        fprintf(stderr, "Memory allocation failed\n");
+        memFree(name);      /* nowhere to park it */
+        return;
+    }
+    retired->name = name;
+    retired->retireEpoch = atomic_fetch_add(&store->epoch, 1);
+    retired->next = store->retiredNames;
+    store->retiredNames = retired;
+    reclaim(store);
+}
+
+static int publishExcluding(MenuStore *store, const Menu *skip){
+    MenuSnapshot *previous = atomic_load(&store->current);
+    uint64_t version = previous ? previous->version + 1 : 1;
+    MenuSnapshot *snapshot = buildSnapshot(*store->head, skip, version);
+    if (!snapshot) return -1;
+
+    previous = atomic_exchange(&store->current, snapshot);
+    if (previous) {
+        /* readers pinned at or before this epoch may still hold it */
+        previous->retireEpoch = atomic_fetch_add(&store->epoch, 1);
+        previous->nextRetired = store->retired;
+        store->retired = previous;
+    }
+    store->stale = 0;
+    reclaim(store);
+    return 0;
+}
+
+static void onMenuChange(Menu *item, MenuEvent event, void *context){
+    MenuStore *store = (MenuStore *)context;
+    switch (event) {
+        case MENU_ITEM_ADDED:
+        case MENU_ITEM_EDITED:
+            publishExcluding(store, NULL);
+            break;
+        case MENU_ITEM_REMOVING:
+            publishExcluding(store, item);
+            break;
+        case MENU_STOCK_CHANGED:
+            store->stale = 1;
+            break;
+        default:
+            break;
+    }
+}
+
+MenuStore* createMenuStore(Menu **head){
+    MenuStore *store = (MenuStore *)memAlloc(MEM_MENU, sizeof(MenuStore));
+    if (!store) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    atomic_init(&store->current, NULL);
+    atomic_init(&store->epoch, 1);
+    for (int i = 0; i < MAX_MENU_READERS; i++) {
+        atomic_init(&store->readers[i], 0);
+        atomic_init(&store->readerUsed[i], 0);
+    }
+    store->retired = NULL;
+    store->retiredNames = NULL;
+    store->head = head;
+    store->stale = 0;
+    if (publishExcluding(store, NULL) != 0) {
+        memFree(store);
+        return NULL;
+    }
+    if (addMenuObserver(onMenuChange, store) != 0 || setMenuNameReclaimer(retireName, store) != 0) {
+        freeMenuStore(store);
+        return NULL;
+    }
+    return store;
+}
+
+int publishMenu(MenuStore *store){
+    return publishExcluding(store, NULL);
+}
+
+int refreshMenu(MenuStore *store){
+    return store->stale ? publishExcluding(store, NULL) : 0;
+}
+
+int registerMenuReader(MenuStore *store){
+    for (int i = 0; i < MAX_MENU_READERS; i++) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&store->readerUsed[i], &expected, 1)) {
+            return i;
+        }
+    }
+    fprintf(stderr, "No free menu reader slots\n");
+    return -1;
+}
+
+void unregisterMenuReader(MenuStore *store, int slot){
+    atomic_store(&store->readers[slot], 0);
+    atomic_store(&store->readerUsed[slot], 0);
+}
+
+const MenuSnapshot* menuReadBegin(MenuStore *store, int slot){
+    atomic_store(&store->readers[slot], atomic_load(&store->epoch));
+    return atomic_load(&store->current);
+}
+
+void menuReadEnd(MenuStore *store, int slot){
+    atomic_store(&store->readers[slot], 0);
+}
+
+const MenuEntry* findSnapshotEntry(const MenuSnapshot *snapshot, int id){
+    MenuEntry key;
+    key.id = id;
+    return (const MenuEntry *)bsearch(&key, snapshot->entries, snapshot->count,
+                                      sizeof(MenuEntry), compareEntries);
+}
+
+void displayMenuSnapshot(const MenuSnapshot *snapshot){
+    printf("Menu Items:\n");
+    printf("ID\tName\tType\tPrice\tQuantity\n");
+    for (int i = 0; i < snapshot->count; i++) {
+        const MenuEntry *entry = &snapshot->entries[i];
+        const char *typeStr = (entry->type == FOOD) ? "FOOD" : (entry->type == DRINK) ? "DRINK" : "DESERT";
+        printf("%d\t%s\t%s\t%.2f\t%d\n", entry->id, entry->name, typeStr, entry->price, entry->quantity);
+    }
+}
+
+void freeMenuStore(MenuStore *store){
+    if (!store) return;
+    removeMenuObserver(onMenuChange, store);
+    setMenuNameReclaimer(NULL, store);
+    freeSnapshot(atomic_load(&store->current));
+    while (store->retired != NULL) {
+        MenuSnapshot *next = store->retired->nextRetired;
+        freeSnapshot(store->retired);
+        store->retired = next;
+    }
+    while (store->retiredNames != NULL) {
+        RetiredName *next = store->retiredNames->next;
+        memFree(store->retiredNames->name);
+        memFree(store->retiredNames);
+        store->retiredNames = next;
+    }
+    memFree(store);
+}
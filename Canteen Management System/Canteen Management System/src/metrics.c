@@ -0,0 +1,296 @@
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/metrics.h"
+
+/* Single-writer cells: the owning thread updates them with relaxed
+   load/store pairs (plain moves on common CPUs), readers may see a
+   slightly stale value but never a torn one. */
+typedef _Atomic uint64_t Cell;
+
+typedef struct {
+    Cell counts[METRIC_BUCKETS];
+    Cell total;
+    Cell sum;
+    Cell min;
+    Cell max;
+} ShardHistogram;
+
+typedef struct MetricsShard {
+    ShardHistogram ops[METRIC_OP_COUNT];
+    Cell counters[METRIC_COUNTER_COUNT];
+    int inUse;                      /* guarded by shardLock */
+    struct MetricsShard *next;
+} MetricsShard;
+
+static pthread_mutex_t shardLock = PTHREAD_MUTEX_INITIALIZER;
+static MetricsShard *shards = NULL;
+static pthread_key_t shardKey;
+static pthread_once_t shardKeyOnce = PTHREAD_ONCE_INIT;
+static _Thread_local MetricsShard *localShard = NULL;
+
+static inline uint64_t loadCell(Cell *cell){
+    return atomic_load_explicit(cell, memory_order_relaxed);
+}
+
+static inline void storeCell(Cell *cell, uint64_t value){
+    atomic_store_explicit(cell, value, memory_order_relaxed);
+}
+
+static inline void addCell(Cell *cell, uint64_t n){
+    storeCell(cell, loadCell(cell) + n);
+}
+
+/* ===============================
+   Histogram buckets
+   =============================== */
+
+static int bucketOf(uint64_t v){
+    if (v < METRIC_SUB_BUCKETS) return (int)v;
+#if defined(__GNUC__)
+    int e = 63 - __builtin_clzll(v);
+#else
+    int e = 0;
+    for (uint64_t x = v; x > 1; x >>= 1) e++;
+#endif
+    if (e > METRIC_MAX_EXPONENT) return METRIC_BUCKETS - 1;
+    int sub = (int)((v >> (e - 4)) & (METRIC_SUB_BUCKETS - 1));
+    return (e - 3) * METRIC_SUB_BUCKETS + sub;
+}
+
+static uint64_t bucketLow(int i){
+    if (i < METRIC_SUB_BUCKETS) return (uint64_t)i;
+    int e = i / METRIC_SUB_BUCKETS + 3;
+    uint64_t sub = (uint64_t)(i % METRIC_SUB_BUCKETS);
+    return (METRIC_SUB_BUCKETS + sub) << (e - 4);
+}
+
+static uint64_t bucketHigh(int i){
+    if (i == METRIC_BUCKETS - 1) return UINT64_MAX;
+    return bucketLow(i + 1) - 1;
+}
+
+void resetHistogram(LatencyHistogram *histogram){
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->min = UINT64_MAX;
+}
+
+void histogramRecord(LatencyHistogram *histogram, uint64_t nanos){
+    histogram->counts[bucketOf(nanos)]++;
+    histogram->total++;
+    histogram->sum += nanos;
+    if (nanos < histogram->min) histogram->min = nanos;
+    if (nanos > histogram->max) histogram->max = nanos;
+}
+
+uint64_t histogramPercentile(const LatencyHistogram *histogram, double percentile){
+    if (histogram->total == 0) return 0;
+    uint64_t rank = (uint64_t)(percentile / 100.0 * histogram->total + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > histogram->total) rank = histogram->total;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < METRIC_BUCKETS; i++) {
+        seen += histogram->counts[i];
+        if (seen >= rank) {
+            uint64_t high = bucketHigh(i);
+            return high < histogram->max ? high : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+/* ===============================
+   Thread shards
+   =============================== */
+
+static void releaseShard(void *shard){
+    pthread_mutex_lock(&shardLock);
+    ((MetricsShard *)shard)->inUse = 0;     /* totals stay; the next thread continues them */
+    pthread_mutex_unlock(&shardLock);
+}
+
+static void createShardKey(void){
+    pthread_key_create(&shardKey, releaseShard);
+}
+
+static MetricsShard* shardForThread(void){
+    if (localShard) return localShard;
+
+    pthread_once(&shardKeyOnce, createShardKey);
+    pthread_mutex_lock(&shardLock);
+    MetricsShard *shard = shards;
+    while (shard && shard->inUse) shard = shard->next;
+    if (!shard) {
+        shard = (MetricsShard *)calloc(1, sizeof(MetricsShard));
+        if (shard) {
+            for (int op = 0; op < METRIC_OP_COUNT; op++) {
+                storeCell(&shard->ops[op].min, UINT64_MAX);
+            }
+            shard->next = shards;
+            shards = shard;
+        }
+    }
+    if (shard) shard->inUse = 1;
+    pthread_mutex_unlock(&shardLock);
+
+    if (shard) pthread_setspecific(shardKey, shard);
+    localShard = shard;
+    return shard;
+}
+
+/* ===============================
+   Recording
+   =============================== */
+
+uint64_t metricNanos(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void recordLatency(MetricOp op, uint64_t nanos){
+    MetricsShard *shard = shardForThread();
+    if (!shard) return;
+
+    ShardHistogram *h = &shard->ops[op];
+    addCell(&h->counts[bucketOf(nanos)], 1);
+    addCell(&h->total, 1);
+    addCell(&h->sum, nanos);
+    if (nanos < loadCell(&h->min)) storeCell(&h->min, nanos);
+    if (nanos > loadCell(&h->max)) storeCell(&h->max, nanos);
+}
+
+void countMetric(MetricCounter counter, uint64_t n){
+    MetricsShard *shard = shardForThread();
+    if (shard) addCell(&shard->counters[counter], n);
+}
+
+/* ===============================
+   Reporting
+   =============================== */
+
+void collectLatency(MetricOp op, LatencyHistogram *out){
+    resetHistogram(out);
+    pthread_mutex_lock(&shardLock);
+    for (MetricsShard *shard = shards; shard != NULL; shard = shard->next) {
+        ShardHistogram *h = &shard->ops[op];
+        for (int i = 0; i < METRIC_BUCKETS; i++) {
+            out->counts[i] += loadCell(&h->counts[i]);
+        }
+        out->total += loadCell(&h->total);
+        out->sum += loadCell(&h->sum);
+        uint64_t min = loadCell(&h->min), max = loadCell(&h->max);
+        if (min < out->min) out->min = min;
+        if (max > out->max) out->max = max;
+    }
+    pthread_mutex_unlock(&shardLock);
+}
+
+uint64_t collectCounter(MetricCounter counter){
+    uint64_t total = 0;
+    pthread_mutex_lock(&shardLock);
+    for (MetricsShard *shard = shards; shard != NULL; shard = shard->next) {
+        total += loadCell(&shard->counters[counter]);
+    }
+    pthread_mutex_unlock(&shardLock);
+    return total;
+}
+
+void resetMetrics(void){
+    pthread_mutex_lock(&shardLock);
+    for (MetricsShard *shard = shards; shard != NULL; shard = shard->next) {
+        for (int op = 0; op < METRIC_OP_COUNT; op++) {
+            ShardHistogram *h = &shard->ops[op];
+            for (int i = 0; i < METRIC_BUCKETS; i++) storeCell(&h->counts[i], 0);
+            storeCell(&h->total, 0);
+            storeCell(&h->sum, 0);
+            storeCell(&h->min, UINT64_MAX);
+            storeCell(&h->max, 0);
+        }
+        for (int c = 0; c < METRIC_COUNTER_COUNT; c++) storeCell(&shard->counters[c], 0);
+    }
+    pthread_mutex_unlock(&shardLock);
+}
+
+int metricsEnabled(void){
+#ifdef CANTEEN_METRICS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+void dumpMetrics(FILE *out){
+    static const char *opNames[METRIC_OP_COUNT] = {
+        "order.place", "stock.update", "menu.lookup", "menu.search",
+        "consumer.lookup", "order.undo", "bill.render"
+    };
+    static const char *counterNames[METRIC_COUNTER_COUNT] = {
+        "orders.placed", "orders.undone", "undo.misses", "stock.rejected",
+        "menu.misses", "consumer.misses"
+    };
+    LatencyHistogram h;
+
+    if (!metricsEnabled()) {
+        fprintf(out, "# metrics disabled in this build (rebuild with make METRICS=1)\n");
+    }
+    fprintf(out, "# latency_ns op count mean min p50 p90 p99 p99.9 max\n");
+    for (int op = 0; op < METRIC_OP_COUNT; op++) {
+        collectLatency((MetricOp)op, &h);
+        if (h.total == 0) {
+            fprintf(out, "latency_ns %s 0 0 0 0 0 0 0 0\n", opNames[op]);
+            continue;
+        }
+        fprintf(out, "latency_ns %s %llu %llu %llu %llu %llu %llu %llu %llu\n", opNames[op],
+                (unsigned long long)h.total, (unsigned long long)(h.sum / h.total),
+                (unsigned long long)h.min,
+                (unsigned long long)histogramPercentile(&h, 50.0),
+                (unsigned long long)histogramPercentile(&h, 90.0),
+                (unsigned long long)histogramPercentile(&h, 99.0),
+                (unsigned long long)histogramPercentile(&h, 99.9),
+                (unsigned long long)h.max);
+    }
+    fprintf(out, "# counter name value\n");
+    for (int c = 0; c < METRIC_COUNTER_COUNT; c++) {
+        fprintf(out, "counter %s %llu\n", counterNames[c],
+                (unsigned long long)collectCounter((MetricCounter)c));
+    }
+    fflush(out);
+}
+
+/* ===============================
+   Signal-triggered dump
+   =============================== */
+
+#ifdef SIGUSR1
+static sigset_t dumpSignals;
+
+static void* signalDumpThread(void *arg){
+    (void)arg;
+    for (;;) {
+        int signo;
+        if (sigwait(&dumpSignals, &signo) == 0) {
+            dumpMetrics(stderr);
+        }
+    }
+    return NULL;
+}
+
+int startMetricsSignalDump(void){
+    pthread_t thread;
+    sigemptyset(&dumpSignals);
+    sigaddset(&dumpSignals, SIGUSR1);
+    if (pthread_sigmask(SIG_BLOCK, &dumpSignals, NULL) != 0) return -1;
+    if (pthread_create(&thread, NULL, signalDumpThread, NULL) != 0) return -1;
+    pthread_detach(thread);
+    return 0;
+}
+#else
+int startMetricsSignalDump(void){
+    return -1;
+}
+#endif
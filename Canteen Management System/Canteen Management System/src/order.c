@@ -1,7 +1,44 @@
 #include "../include/order.h"
+#include "../include/metrics.h"
+#include "../include/memtrack.h"
+#include "../include/ordertrace.h"
+#include "../include/clocksource.h"
+#include "../include/recorder.h"
+
+static struct {
+    OrderObserver observer;
+    void *context;
+} observers[MAX_ORDER_OBSERVERS];
+static int observerCount = 0;
+
+int addOrderObserver(OrderObserver observer, void *context) {
+    if (observerCount == MAX_ORDER_OBSERVERS) {
+        fprintf(stderr, "Too many order observers\n");
+        return -1;
+    }
+    observers[observerCount].observer = observer;
+    observers[observerCount].context = context;
+    observerCount++;
+    return 0;
+}
+
+void removeOrderObserver(OrderObserver observer, void *context) {
+    for (int i = 0; i < observerCount; i++) {
+        if (observers[i].observer == observer && observers[i].context == context) {
+            observers[i] = observers[--observerCount];
+            return;
+        }
+    }
+}
+
+void notifyOrderObservers(Order *order, OrderEvent event) {
+    for (int i = 0; i < observerCount; i++) {
+        observers[i].observer(order, event, observers[i].context);
+    }
+}
 
 OrderQueue* createOrderQueue() {
-    OrderQueue *queue = (OrderQueue *)malloc(sizeof(OrderQueue));
+    OrderQueue *queue = (OrderQueue *)memAlloc(MEM_ORDERS, sizeof(OrderQueue));
     queue->front = NULL;
     queue->rear = NULL;
     queue->count = 0;
@@ -9,24 +46,51 @@ OrderQueue* createOrderQueue() {
 }
 
 OrderItem* createOrderItem(Menu *menuItem, int quantity) {
-    OrderItem *newItem = (OrderItem *)malloc(sizeof(OrderItem));
+    OrderItem *newItem = (OrderItem *)memAlloc(MEM_ORDERS, sizeof(OrderItem));
+    if (!newItem) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    /* bills print this copy: later edits cannot change or free it */
+    newItem->name = memStrdup(MEM_ORDERS, menuItem->name);
+    if (!newItem->name) {
+        fprintf(stderr, "Memory allocation failed\n");
+        memFree(newItem);
+        return NULL;
+    }
     newItem->menuItem = menuItem;
+    retainMenuItem(menuItem);
     newItem->quantity = quantity;
+    newItem->unitPrice = menuItem->price;
     newItem->next = NULL;
     return newItem;
 }
 
 
-Order* enqueueOrder(OrderQueue *queue, int orderId, const char *consumerName,
-                    const char *consumerUID, OrderItem *items, float totalAmount){
-    Order *newOrder = (Order *)malloc(sizeof(Order));
+static Order* enqueueTyped(OrderQueue *queue, int orderId, const char *consumerName,
+                           const char *consumerUID, ConsumerType consumerType,
+                           OrderItem *items, float totalAmount){
+    METRIC_START(started);
+    Order *newOrder = (Order *)memAlloc(MEM_ORDERS, sizeof(Order));
+    memset(newOrder->stageNanos, 0, sizeof(newOrder->stageNanos));
     newOrder->orderId = orderId;
-    newOrder->consumerName = strdup(consumerName);
-    newOrder->consumerUID = strdup(consumerUID);
+    newOrder->consumerName = memStrdup(MEM_ORDERS, consumerName);
+    newOrder->consumerUID = memStrdup(MEM_ORDERS, consumerUID);
+    newOrder->consumerType = consumerType;
     newOrder->items = items;
     newOrder->totalAmount = totalAmount;
-    newOrder->orderTime = time(NULL);
+    newOrder->orderTime = clockTime();
+    newOrder->priorityClass = -1;
+    newOrder->deadlineNanos = 0;
+    newOrder->workNanos = 0;
+    newOrder->workAheadNanos = 0;
+    newOrder->request = NULL;
+    newOrder->undoNode = NULL;
+    newOrder->classPrev = NULL;
+    newOrder->classNext = NULL;
+    newOrder->prev = queue->rear;
     newOrder->next = NULL;
+    markOrderStage(newOrder, STAGE_PLACED);
 
     if (queue->rear == NULL) {
         queue->front = newOrder;
@@ -36,27 +100,65 @@ Order* enqueueOrder(OrderQueue *queue, int orderId, const char *consumerName,
         queue->rear = newOrder;
     }
     queue->count++;
-    
-    return newOrder; 
+    notifyOrderObservers(newOrder, ORDER_ENQUEUED);
+    markOrderStage(newOrder, STAGE_QUEUED);
+    RECORD_OP(recordOrderPlaced(newOrder));
+    METRIC_COUNT(COUNTER_ORDERS_PLACED, 1);
+    METRIC_STOP(METRIC_ORDER_PLACE, started);
+    return newOrder;
+}
+
+Order* enqueueOrder(OrderQueue *queue, int orderId, const char *consumerName,
+                    const char *consumerUID, OrderItem *items, float totalAmount){
+    return enqueueTyped(queue, orderId, consumerName, consumerUID, STUDENT, items, totalAmount);
+}
+
+Order* enqueueConsumerOrder(OrderQueue *queue, int orderId, const Consumer *consumer,
+                            OrderItem *items, float totalAmount){
+    return enqueueTyped(queue, orderId, consumer->name, consumer->uid, consumer->type,
+                        items, totalAmount);
 }
 
 Order* dequeueOrder(OrderQueue *queue){
     if (queue->front == NULL) {
         return NULL;
     }
-    Order *temp = queue->front;
-    queue->front = queue->front->next;
-    if (queue->front == NULL) {
-        queue->rear = NULL;
-    }
+    return takeOrder(queue, queue->front);
+}
+
+int isQueued(const OrderQueue *queue, const Order *order){
+    /* taken orders have no neighbours, and only the front has no prev */
+    return order != NULL && (order->prev != NULL || queue->front == order);
+}
+
+/* Links the order out of the queue without notifying anyone */
+static void unlinkOrder(OrderQueue *queue, Order *order){
+    if (order->prev) order->prev->next = order->next;
+    else queue->front = order->next;
+    if (order->next) order->next->prev = order->prev;
+    else queue->rear = order->prev;
+    order->prev = NULL;
+    order->next = NULL;
     queue->count--;
-    return temp;
+}
+
+Order* takeOrder(OrderQueue *queue, Order *order){
+    if (!isQueued(queue, order)) {
+        return NULL;
+    }
+    unlinkOrder(queue, order);
+    notifyOrderObservers(order, ORDER_DEQUEUED);
+    return order;
+}
+
+void removeQueuedOrder(OrderQueue *queue, Order *order){
+    unlinkOrder(queue, order);
 }
 
 void restoreStockLevels(Order *order){
     OrderItem *item = order->items;
     while (item != NULL) {
-        item->menuItem->quantity += item->quantity;
+        adjustItemQuantity(item->menuItem, item->quantity);
         item = item->next;
     }
 }
@@ -77,7 +179,7 @@ void displayOrders(OrderQueue *queue){
         OrderItem *item = current->items;
         while (item != NULL) {
             printf("  - %s x%d @ %.2f each\n", 
-                   item->menuItem->name, item->quantity, item->menuItem->price);
+                   item->name, item->quantity, item->unitPrice);
             item = item->next;
         }
         printf("========================\n");
@@ -86,6 +188,7 @@ void displayOrders(OrderQueue *queue){
 }
 
 void printBill(Order *order) {
+    METRIC_START(started);
     printf("\n========================================\n");
     printf("           BILL\n");
     printf("========================================\n");
@@ -98,10 +201,10 @@ void printBill(Order *order) {
     
     OrderItem *item = order->items;
     while (item != NULL) {
-        float itemTotal = item->menuItem->price * item->quantity;
+        float itemTotal = item->unitPrice * item->quantity;
         printf("%-20s %5d %8.2f %10.2f\n", 
-               item->menuItem->name, item->quantity, 
-               item->menuItem->price, itemTotal);
+               item->name, item->quantity, 
+               item->unitPrice, itemTotal);
         item = item->next;
     }
     
@@ -109,6 +212,7 @@ void printBill(Order *order) {
     printf("%s %.2f\n" , "TOTAL:", order->totalAmount);
     printf("========================================\n");
     printf("      Thank you! Visit again!\n\n");
+    METRIC_STOP(METRIC_BILL_RENDER, started);
 }
 
 void freeOrderItems(OrderItem *items){
@@ -116,30 +220,39 @@ void freeOrderItems(OrderItem *items){
     OrderItem *nextItem;
     while (current != NULL) {
         nextItem = current->next;
-        free(current);
+        releaseMenuItem(current->menuItem);
+        memFree(current->name);
+        memFree(current);
         current = nextItem;
     }
 }
 
+void discardOrderItems(OrderItem *items){
+    for (OrderItem *item = items; item != NULL; item = item->next) {
+        adjustItemQuantity(item->menuItem, item->quantity);
+    }
+    freeOrderItems(items);
+}
+
 void freeOrderQueue(OrderQueue *queue){
     Order *current = queue->front;
     Order *nextOrder;
     while (current != NULL) {
         nextOrder = current->next;
-        free(current->consumerName);
-        free(current->consumerUID);
+        memFree(current->consumerName);
+        memFree(current->consumerUID);
         freeOrderItems(current->items);
-        free(current);
+        memFree(current);
         current = nextOrder;
     }
-    free(queue);
+    memFree(queue);
 }
 
 void freeOrder(Order *order) {
     if (order) {
-        free(order->consumerName);
-        free(order->consumerUID);
+        memFree(order->consumerName);
+        memFree(order->consumerUID);
         freeOrderItems(order->items);
-        free(order);
+        memFree(order);
     }
 }
\ No newline at end of file
@@ -0,0 +1,394 @@
+#include <math.h>
+#include "../include/orderexport.h"
+
+static const char *typeNames[] = { "STUDENT", "STAFF", "FACULTY" };
+
+/* Archived orders carry whatever type the consumer was given, so clamp it */
+static const char* typeName(ConsumerType type){
+    return type >= 0 && type < 3 ? typeNames[type] : "UNKNOWN";
+}
+
+/* Order fields shared by every line of one order */
+typedef struct {
+    time_t time;
+    int id;
+    const char *uid;
+    const char *name;
+    ConsumerType type;
+    long totalCents;
+} OrderHead;
+
+/* Destination of formatted text: the output buffer or the CSV prefix */
+typedef struct {
+    char *data;
+    size_t *length;
+    size_t capacity;
+    OrderExporter *flushTo;   /* NULL if the target cannot be flushed */
+    int overflow;
+} Out;
+
+/* ===============================
+   Buffer helpers
+   =============================== */
+
+static void flushBuffer(OrderExporter *e){
+    if (e->length == 0) return;
+    if (fwrite(e->buffer, 1, e->length, e->file) != e->length) e->failed = 1;
+    e->bytes += e->length;
+    e->length = 0;
+}
+
+static Out bufferOut(OrderExporter *e){
+    Out o = { e->buffer, &e->length, sizeof(e->buffer), e, 0 };
+    return o;
+}
+
+static int reserve(Out *o, size_t n){
+    if (*o->length + n <= o->capacity) return 1;
+    if (o->flushTo) {
+        flushBuffer(o->flushTo);
+        if (n <= o->capacity) return 1;
+    }
+    o->overflow = 1;
+    return 0;
+}
+
+static void putRaw(Out *o, const char *s, size_t n){
+    if (!reserve(o, n)) return;
+    memcpy(o->data + *o->length, s, n);
+    *o->length += n;
+}
+
+#define PUT_LITERAL(o, s) putRaw((o), (s), sizeof(s) - 1)
+
+static void putChar(Out *o, char c){
+    if (!reserve(o, 1)) return;
+    o->data[(*o->length)++] = c;
+}
+
+static void putLong(Out *o, long v){
+    char digits[24];
+    int n = 0;
+    unsigned long u = v < 0 ? 0UL - (unsigned long)v : (unsigned long)v;
+
+    if (!reserve(o, sizeof(digits))) return;
+    do {
+        digits[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    char *p = o->data + *o->length;
+    if (v < 0) *p++ = '-';
+    while (n) *p++ = digits[--n];
+    *o->length = p - o->data;
+}
+
+static void putCents(Out *o, long cents){
+    if (cents < 0) {
+        putChar(o, '-');
+        cents = -cents;
+    }
+    putLong(o, cents / 100);
+    if (!reserve(o, 3)) return;
+    char *p = o->data + *o->length;
+    p[0] = '.';
+    p[1] = (char)('0' + cents % 100 / 10);
+    p[2] = (char)('0' + cents % 10);
+    *o->length += 3;
+}
+
+static long toCents(float amount){
+    return lround((double)amount * 100.0);
+}
+
+static void putTwo(char *p, int v){
+    p[0] = (char)('0' + v / 10);
+    p[1] = (char)('0' + v % 10);
+}
+
+/* Days since the epoch to "YYYY-MM-DD" (proleptic Gregorian) */
+static void formatDate(long days, char *out){
+    long z = days + 719468;
+    long era = (z >= 0 ? z : z - 146096) / 146097;
+    long doe = z - era * 146097;
+    long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long mp = (5 * doy + 2) / 153;
+    int day = (int)(doy - (153 * mp + 2) / 5 + 1);
+    int month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    long year = yoe + era * 400 + (month <= 2);
+
+    putTwo(out, (int)(year / 100 % 100));
+    putTwo(out + 2, (int)(year % 100));
+    out[4] = '-';
+    putTwo(out + 5, month);
+    out[7] = '-';
+    putTwo(out + 8, day);
+    out[10] = '\0';
+}
+
+/* ISO 8601 UTC; the date part is cached for the current day */
+static void putTime(OrderExporter *e, Out *o, time_t t){
+    long days = (long)(t / ARCHIVE_DAY_SECONDS);
+    long seconds = (long)(t % ARCHIVE_DAY_SECONDS);
+    if (seconds < 0) {
+        seconds += ARCHIVE_DAY_SECONDS;
+        days--;
+    }
+    if (days != e->cachedDay) {
+        formatDate(days, e->cachedDate);
+        e->cachedDay = days;
+    }
+    if (!reserve(o, 20)) return;
+    char *p = o->data + *o->length;
+    memcpy(p, e->cachedDate, 10);
+    p[10] = 'T';
+    putTwo(p + 11, (int)(seconds / 3600));
+    p[13] = ':';
+    putTwo(p + 14, (int)(seconds / 60 % 60));
+    p[16] = ':';
+    putTwo(p + 17, (int)(seconds % 60));
+    p[19] = 'Z';
+    *o->length += 20;
+}
+
+static void putCsvField(Out *o, const char *s){
+    if (strpbrk(s, ",\"\r\n") == NULL) {
+        putRaw(o, s, strlen(s));
+        return;
+    }
+    putChar(o, '"');
+    for (; *s; s++) {
+        if (*s == '"') putChar(o, '"');
+        putChar(o, *s);
+    }
+    putChar(o, '"');
+}
+
+static void putJsonString(Out *o, const char *s){
+    static const char hex[] = "0123456789abcdef";
+    putChar(o, '"');
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            putChar(o, '\\');
+            putChar(o, (char)c);
+        } else if (c < 0x20) {
+            char escaped[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 15] };
+            putRaw(o, escaped, sizeof(escaped));
+        } else {
+            putChar(o, (char)c);
+        }
+    }
+    putChar(o, '"');
+}
+
+/* ===============================
+   Record writers
+   =============================== */
+
+static void putCsvHead(OrderExporter *e, Out *o, const OrderHead *head){
+    putLong(o, head->id);
+    putChar(o, ',');
+    putTime(e, o, head->time);
+    putChar(o, ',');
+    putCsvField(o, head->uid);
+    putChar(o, ',');
+    putCsvField(o, head->name);
+    putChar(o, ',');
+    const char *type = typeName(head->type);
+    putRaw(o, type, strlen(type));
+    putChar(o, ',');
+    putCents(o, head->totalCents);
+    putChar(o, ',');
+}
+
+static void beginOrder(OrderExporter *e, const OrderHead *head){
+    Out out = bufferOut(e);
+
+    if (e->format == EXPORT_CSV) {
+        Out prefix = { e->prefix, &e->prefixLength, sizeof(e->prefix), NULL, 0 };
+        e->prefixLength = 0;
+        putCsvHead(e, &prefix, head);
+        if (prefix.overflow) e->prefixLength = 0;   /* lines write the fields directly */
+        return;
+    }
+
+    PUT_LITERAL(&out, "{\"order_id\":");
+    putLong(&out, head->id);
+    PUT_LITERAL(&out, ",\"order_time\":\"");
+    putTime(e, &out, head->time);
+    PUT_LITERAL(&out, "\",\"consumer_uid\":");
+    putJsonString(&out, head->uid);
+    PUT_LITERAL(&out, ",\"consumer_name\":");
+    putJsonString(&out, head->name);
+    PUT_LITERAL(&out, ",\"consumer_type\":\"");
+    const char *type = typeName(head->type);
+    putRaw(&out, type, strlen(type));
+    PUT_LITERAL(&out, "\",\"order_total\":");
+    putCents(&out, head->totalCents);
+    PUT_LITERAL(&out, ",\"lines\":[");
+}
+
+static void putLine(OrderExporter *e, const OrderHead *head, int index,
+                    int menuId, int quantity, float unitPrice){
+    Out out = bufferOut(e);
+    long priceCents = toCents(unitPrice);
+
+    if (e->format == EXPORT_CSV) {
+        if (e->prefixLength > 0) putRaw(&out, e->prefix, e->prefixLength);
+        else putCsvHead(e, &out, head);
+        putLong(&out, menuId);
+        putChar(&out, ',');
+        putLong(&out, quantity);
+        putChar(&out, ',');
+        putCents(&out, priceCents);
+        putChar(&out, ',');
+        putCents(&out, priceCents * quantity);
+        putChar(&out, '\n');
+    } else {
+        if (index > 0) putChar(&out, ',');
+        PUT_LITERAL(&out, "{\"menu_id\":");
+        putLong(&out, menuId);
+        PUT_LITERAL(&out, ",\"quantity\":");
+        putLong(&out, quantity);
+        PUT_LITERAL(&out, ",\"unit_price\":");
+        putCents(&out, priceCents);
+        putChar(&out, '}');
+    }
+    e->lines++;
+}
+
+static int endOrder(OrderExporter *e){
+    if (e->format == EXPORT_JSONL) {
+        Out out = bufferOut(e);
+        PUT_LITERAL(&out, "]}\n");
+    }
+    e->orders++;
+    return e->failed ? -1 : 0;
+}
+
+static int matches(const ExportFilter *filter, time_t t, const char *uid){
+    if (!filter) return 1;
+    if (t < filter->from || t >= filter->to) return 0;
+    return filter->consumerUID == NULL || strcmp(filter->consumerUID, uid) == 0;
+}
+
+/* ===============================
+   Public API
+   =============================== */
+
+ExportFilter exportFilterRange(time_t from, time_t to){
+    ExportFilter filter = { from, to, NULL };
+    return filter;
+}
+
+OrderExporter* openOrderExporter(FILE *file, ExportFormat format){
+    OrderExporter *e = (OrderExporter *)malloc(sizeof(OrderExporter));
+    if (!e) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    e->file = file;
+    e->format = format;
+    e->length = 0;
+    e->prefixLength = 0;
+    e->cachedDay = -1;
+    e->orders = 0;
+    e->lines = 0;
+    e->bytes = 0;
+    e->failed = 0;
+
+    if (format == EXPORT_CSV) {
+        Out out = bufferOut(e);
+        PUT_LITERAL(&out, "order_id,order_time,consumer_uid,consumer_name,consumer_type,"
+                          "order_total,menu_id,quantity,unit_price,line_total\n");
+    }
+    return e;
+}
+
+int exportArchivedOrder(OrderExporter *exporter, const ArchivedOrder *order){
+    OrderHead head = { order->orderTime, order->orderId, order->consumerUID,
+                       order->consumerName, order->consumerType, toCents(order->totalAmount) };
+    beginOrder(exporter, &head);
+    for (int i = 0; i < order->lineCount; i++) {
+        putLine(exporter, &head, i, order->menuIds[i], order->quantities[i], order->unitPrices[i]);
+    }
+    return endOrder(exporter);
+}
+
+int exportLiveOrder(OrderExporter *exporter, const Order *order){
+    OrderHead head = { order->orderTime, order->orderId, order->consumerUID,
+                       order->consumerName, order->consumerType, toCents(order->totalAmount) };
+    int index = 0;
+    beginOrder(exporter, &head);
+    for (const OrderItem *line = order->items; line != NULL; line = line->next) {
+        putLine(exporter, &head, index++, line->menuItem->id, line->quantity, line->unitPrice);
+    }
+    return endOrder(exporter);
+}
+
+long exportArchive(OrderExporter *exporter, const OrderArchive *archive, const ExportFilter *filter){
+    ArchiveCursor cursor;
+    ArchivedOrder order;
+    long written = 0;
+
+    archiveSeek(archive, filter->from, filter->to, &cursor);
+    while (archiveNext(&cursor, &order)) {
+        if (!matches(filter, order.orderTime, order.consumerUID)) continue;
+        if (exportArchivedOrder(exporter, &order) != 0) return -1;
+        written++;
+    }
+    return written;
+}
+
+long exportQueue(OrderExporter *exporter, const OrderQueue *queue, const ExportFilter *filter){
+    long written = 0;
+    for (const Order *order = queue->front; order != NULL; order = order->next) {
+        if (!matches(filter, order->orderTime, order->consumerUID)) continue;
+        if (exportLiveOrder(exporter, order) != 0) return -1;
+        written++;
+    }
+    return written;
+}
+
+int closeOrderExporter(OrderExporter *exporter){
+    if (!exporter) return -1;
+    flushBuffer(exporter);
+    int result = exporter->failed || fflush(exporter->file) != 0 ? -1 : 0;
+    free(exporter);
+    return result;
+}
+
+int exportOrdersToFile(const OrderArchive *archive, const OrderQueue *queue, const char *path,
+                       ExportFormat format, const ExportFilter *filter){
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Cannot create %s\n", path);
+        return -1;
+    }
+    OrderExporter *exporter = openOrderExporter(file, format);
+    if (!exporter) {
+        fclose(file);
+        return -1;
+    }
+
+    clock_t start = clock();
+    long written = 0;
+    if (archive) written = exportArchive(exporter, archive, filter);
+    if (written >= 0 && queue) written = exportQueue(exporter, queue, filter);
+    long orders = exporter->orders;
+    long lines = exporter->lines;
+    int result = closeOrderExporter(exporter);
+    /* bytes are only final after the last flush */
+    long long bytes = ftell(file);
+    if (fclose(file) != 0) result = -1;
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    if (result != 0 || written < 0) {
+        fprintf(stderr, "Writing %s failed\n", path);
+        return -1;
+    }
+    printf("Exported %ld orders (%ld lines, %lld bytes) to %s\n", orders, lines, bytes, path);
+    if (seconds > 0) printf("Throughput: %.1f MB/s\n", bytes / seconds / 1e6);
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include <pthread.h>
+#include "../include/ordertrace.h"
+#include "../include/clocksource.h"
+
+static pthread_mutex_t traceLock = PTHREAD_MUTEX_INITIALIZER;
+static OrderTraceRecord ring[TRACE_RING_CAPACITY];
+static uint64_t traced = 0;                 /* records ever written; ring slot is traced % capacity */
+static OrderWaitStats waits;
+static int waitsReady = 0;
+
+static const char *stageNames[ORDER_STAGE_COUNT] = {
+    "placed", "queued", "started", "ready", "collected", "cancelled"
+};
+
+/* Caller holds traceLock */
+static void ensureWaits(void){
+    if (waitsReady) return;
+    resetHistogram(&waits.queueWait);
+    resetHistogram(&waits.service);
+    resetHistogram(&waits.turnaround);
+    waitsReady = 1;
+}
+
+const char* orderStageName(OrderStage stage){
+    return stage < ORDER_STAGE_COUNT ? stageNames[stage] : "unknown";
+}
+
+uint64_t orderStageNanos(const Order *order, OrderStage from, OrderStage to){
+    uint64_t start = order->stageNanos[from], end = order->stageNanos[to];
+    if (start == 0 || end < start) return 0;
+    return end - start;
+}
+
+int markOrderStage(Order *order, OrderStage stage){
+    if (order->stageNanos[stage] != 0) return -1;
+    uint64_t now = clockNanos();
+    order->stageNanos[stage] = now;
+
+    /* previous stage reached, for the elapsed column */
+    uint64_t previous = 0;
+    for (int s = 0; s < ORDER_STAGE_COUNT; s++) {
+        uint64_t t = order->stageNanos[s];
+        if (s != (int)stage && t != 0 && t <= now && t > previous) previous = t;
+    }
+    uint64_t elapsed = previous ? (now - previous) / 1000 : 0;
+
+    pthread_mutex_lock(&traceLock);
+    OrderTraceRecord *record = &ring[traced++ & (TRACE_RING_CAPACITY - 1)];
+    record->nanos = now;
+    record->elapsedMicros = elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed;
+    record->orderId = order->orderId;
+    record->stage = (uint8_t)stage;
+    record->consumerType = (uint8_t)order->consumerType;
+
+    ensureWaits();
+    if (stage == STAGE_STARTED && order->stageNanos[STAGE_QUEUED]) {
+        histogramRecord(&waits.queueWait, orderStageNanos(order, STAGE_QUEUED, STAGE_STARTED));
+    } else if (stage == STAGE_READY && order->stageNanos[STAGE_STARTED]) {
+        histogramRecord(&waits.service, orderStageNanos(order, STAGE_STARTED, STAGE_READY));
+    } else if (stage == STAGE_COLLECTED && order->stageNanos[STAGE_PLACED]) {
+        histogramRecord(&waits.turnaround, orderStageNanos(order, STAGE_PLACED, STAGE_COLLECTED));
+    }
+    pthread_mutex_unlock(&traceLock);
+
+    if (stage == STAGE_STARTED) {
+        notifyOrderObservers(order, ORDER_STARTED);
+    } else if (stage == STAGE_READY) {
+        notifyOrderObservers(order, ORDER_READY);
+    }
+    return 0;
+}
+
+Order* startNextOrder(OrderQueue *queue){
+    for (Order *order = queue->front; order != NULL; order = order->next) {
+        if (order->stageNanos[STAGE_STARTED] == 0) {
+            markOrderStage(order, STAGE_STARTED);
+            return order;
+        }
+    }
+    return NULL;
+}
+
+Order* finishNextOrder(OrderQueue *queue){
+    for (Order *order = queue->front; order != NULL; order = order->next) {
+        if (order->stageNanos[STAGE_STARTED] != 0 && order->stageNanos[STAGE_READY] == 0) {
+            markOrderStage(order, STAGE_READY);
+            return order;
+        }
+    }
+    return NULL;
+}
+
+void getOrderWaitStats(OrderWaitStats *stats){
+    pthread_mutex_lock(&traceLock);
+    ensureWaits();
+    *stats = waits;
+    pthread_mutex_unlock(&traceLock);
+}
+
+static void printWait(FILE *out, const char *name, const LatencyHistogram *h){
+    if (h->total == 0) {
+        fprintf(out, "%-12s %8d %10s %10s %10s %10s %10s\n", name, 0, "-", "-", "-", "-", "-");
+        return;
+    }
+    fprintf(out, "%-12s %8llu %10.1f %10.1f %10.1f %10.1f %10.1f\n", name,
+            (unsigned long long)h->total,
+            h->sum / (double)h->total / 1e6,
+            histogramPercentile(h, 50.0) / 1e6,
+            histogramPercentile(h, 90.0) / 1e6,
+            histogramPercentile(h, 99.0) / 1e6,
+            h->max / 1e6);
+}
+
+void displayOrderWaitStats(FILE *out){
+    OrderWaitStats stats;
+
+    getOrderWaitStats(&stats);
+    fprintf(out, "\n%-12s %8s %10s %10s %10s %10s %10s\n",
+            "Stage (ms)", "Orders", "Mean", "p50", "p90", "p99", "Max");
+    fprintf(out, "------------------------------------------------------------------------\n");
+    printWait(out, "Queue wait", &stats.queueWait);
+    printWait(out, "Service", &stats.service);
+    printWait(out, "Turnaround", &stats.turnaround);
+}
+
+long dumpOrderTrace(const char *path){
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        printf("Error: Cannot open %s for writing!\n", path);
+        return -1;
+    }
+
+    fprintf(file, "nanos,order_id,stage,consumer_type,elapsed_us\n");
+    pthread_mutex_lock(&traceLock);
+    uint64_t first = traced > TRACE_RING_CAPACITY ? traced - TRACE_RING_CAPACITY : 0;
+    for (uint64_t i = first; i < traced; i++) {
+        const OrderTraceRecord *r = &ring[i & (TRACE_RING_CAPACITY - 1)];
+        fprintf(file, "%llu,%u,%s,%u,%u\n", (unsigned long long)r->nanos, r->orderId,
+                orderStageName((OrderStage)r->stage), r->consumerType, r->elapsedMicros);
+    }
+    long written = (long)(traced - first);
+    pthread_mutex_unlock(&traceLock);
+
+    if (fclose(file) != 0) return -1;
+    return written;
+}
+
+void resetOrderTrace(void){
+    pthread_mutex_lock(&traceLock);
+    traced = 0;
+    waitsReady = 0;
+    ensureWaits();
+    pthread_mutex_unlock(&traceLock);
+}
@@ -0,0 +1,277 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/recorder.h"
+#include "../include/clocksource.h"
+
+#define RECORDER_MAGIC "CMSR"
+#define RECORDER_VERSION 1
+#define RECORDER_BUFFER (1 << 16)
+
+volatile int recorderActive = 0;
+
+static pthread_mutex_t recorderLock = PTHREAD_MUTEX_INITIALIZER;
+static FILE *traceFile = NULL;
+static uint64_t lastNanos = 0;
+static long recordCount = 0;
+
+/* ===============================
+   Encoding
+   =============================== */
+
+static void putVarint(uint64_t value){
+    while (value >= 0x80) {
+        putc((int)(value & 0x7F) | 0x80, traceFile);
+        value >>= 7;
+    }
+    putc((int)value, traceFile);
+}
+
+static void putSigned(int64_t value){
+    putVarint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static void putString(const char *s){
+    size_t length = strlen(s);
+    if (length > RECORDER_MAX_STRING) length = RECORDER_MAX_STRING;
+    putVarint(length);
+    fwrite(s, 1, length, traceFile);
+}
+
+static int32_t toCents(float amount){
+    return (int32_t)(amount * 100.0f + (amount < 0 ? -0.5f : 0.5f));
+}
+
+/* Caller holds recorderLock; writes type and time delta */
+static void beginRecord(RecordType type){
+    uint64_t now = clockNanos();
+    putc(type, traceFile);
+    putVarint(now > lastNanos ? now - lastNanos : 0);
+    if (now > lastNanos) lastNanos = now;
+    recordCount++;
+}
+
+static void writeMenuItem(const Menu *item){
+    beginRecord(RECORD_MENU_ITEM);
+    putSigned(item->id);
+    putVarint((uint64_t)item->type);
+    putSigned(toCents(item->price));
+    putVarint(item->quantity);
+    putString(item->name);
+}
+
+/* ===============================
+   Recording
+   =============================== */
+
+int startRecording(const char *path, Menu *menuHead){
+    pthread_mutex_lock(&recorderLock);
+    if (traceFile) {
+        pthread_mutex_unlock(&recorderLock);
+        return -1;
+    }
+    traceFile = fopen(path, "wb");
+    if (!traceFile) {
+        pthread_mutex_unlock(&recorderLock);
+        printf("Error: Cannot open %s for writing!\n", path);
+        return -1;
+    }
+    setvbuf(traceFile, NULL, _IOFBF, RECORDER_BUFFER);
+
+    int64_t start = (int64_t)clockTime();
+    fwrite(RECORDER_MAGIC, 1, 4, traceFile);
+    putc(RECORDER_VERSION, traceFile);
+    for (int i = 0; i < 8; i++) {
+        putc((int)((uint64_t)start >> (8 * i)) & 0xFF, traceFile);
+    }
+    lastNanos = clockNanos();
+    recordCount = 0;
+    for (const Menu *item = menuHead; item != NULL; item = item->next) {
+        writeMenuItem(item);
+    }
+    recorderActive = 1;
+    pthread_mutex_unlock(&recorderLock);
+    return 0;
+}
+
+long stopRecording(void){
+    pthread_mutex_lock(&recorderLock);
+    if (!traceFile) {
+        pthread_mutex_unlock(&recorderLock);
+        return -1;
+    }
+    recorderActive = 0;
+    int failed = ferror(traceFile) | fclose(traceFile);
+    traceFile = NULL;
+    long written = recordCount;
+    pthread_mutex_unlock(&recorderLock);
+    return failed ? -1 : written;
+}
+
+void recordMenuItem(const Menu *item){
+    pthread_mutex_lock(&recorderLock);
+    if (traceFile) writeMenuItem(item);
+    pthread_mutex_unlock(&recorderLock);
+}
+
+void recordMenuLookup(int menuId){
+    pthread_mutex_lock(&recorderLock);
+    if (traceFile) {
+        beginRecord(RECORD_MENU_LOOKUP);
+        putSigned(menuId);
+    }
+    pthread_mutex_unlock(&recorderLock);
+}
+
+void recordOrderPlaced(const Order *order){
+    pthread_mutex_lock(&recorderLock);
+    if (traceFile) {
+        int lines = 0;
+        for (const OrderItem *line = order->items; line != NULL && lines < RECORDER_MAX_LINES; line = line->next) {
+            lines++;
+        }
+        beginRecord(RECORD_ORDER_PLACED);
+        putVarint(order->orderId);
+        putString(order->consumerUID);
+        putVarint((uint64_t)order->consumerType);
+        putVarint(lines);
+        const OrderItem *line = order->items;
+        for (int i = 0; i < lines; i++, line = line->next) {
+            putSigned(line->menuItem->id);
+            putVarint((uint64_t)line->quantity);
+        }
+    }
+    pthread_mutex_unlock(&recorderLock);
+}
+
+void recordEvent(RecordType type){
+    pthread_mutex_lock(&recorderLock);
+    if (traceFile) beginRecord(type);
+    pthread_mutex_unlock(&recorderLock);
+}
+
+/* ===============================
+   Reading
+   =============================== */
+
+static int getVarint(FILE *file, uint64_t *out){
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = getc(file);
+        if (c == EOF) return -1;
+        value |= (uint64_t)(c & 0x7F) << shift;
+        if (!(c & 0x80)) {
+            *out = value;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int getSigned(FILE *file, int64_t *out){
+    uint64_t raw;
+    if (getVarint(file, &raw) != 0) return -1;
+    *out = (int64_t)(raw >> 1) ^ -(int64_t)(raw & 1);
+    return 0;
+}
+
+static int getString(FILE *file, char *buffer){
+    uint64_t length;
+    if (getVarint(file, &length) != 0 || length > RECORDER_MAX_STRING) return -1;
+    if (fread(buffer, 1, length, file) != length) return -1;
+    buffer[length] = '\0';
+    return 0;
+}
+
+RecordingReader* openRecording(const char *path){
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        printf("Error: Cannot open %s for reading!\n", path);
+        return NULL;
+    }
+    unsigned char header[13];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header)
+        || memcmp(header, RECORDER_MAGIC, 4) != 0 || header[4] != RECORDER_VERSION) {
+        fprintf(stderr, "%s is not an operation trace\n", path);
+        fclose(file);
+        return NULL;
+    }
+
+    RecordingReader *reader = (RecordingReader *)calloc(1, sizeof(RecordingReader));
+    if (!reader) {
+        fprintf(stderr, "Memory allocation failed\n");
+        fclose(file);
+        return NULL;
+    }
+    setvbuf(file, NULL, _IOFBF, RECORDER_BUFFER);
+    reader->file = file;
+    uint64_t start = 0;
+    for (int i = 0; i < 8; i++) start |= (uint64_t)header[5 + i] << (8 * i);
+    reader->startTime = (int64_t)start;
+    return reader;
+}
+
+int nextRecordedOp(RecordingReader *reader, RecordedOp *op){
+    FILE *file = reader->file;
+    uint64_t delta, u;
+    int64_t s;
+
+    int type = getc(file);
+    if (type == EOF) return 0;
+    if (getVarint(file, &delta) != 0) return -1;
+
+    memset(op, 0, sizeof(*op));
+    op->type = (RecordType)type;
+    reader->nanos += delta;
+    op->nanos = reader->nanos;
+
+    switch (type) {
+    case RECORD_MENU_ITEM:
+        if (getSigned(file, &s) != 0) return -1;
+        op->menuId = (int)s;
+        if (getVarint(file, &u) != 0) return -1;
+        op->itemType = (int)u;
+        if (getSigned(file, &s) != 0) return -1;
+        op->price = s / 100.0f;
+        if (getVarint(file, &u) != 0) return -1;
+        op->quantity = (int)u;
+        if (getString(file, reader->name) != 0) return -1;
+        op->name = reader->name;
+        break;
+    case RECORD_MENU_LOOKUP:
+        if (getSigned(file, &s) != 0) return -1;
+        op->menuId = (int)s;
+        break;
+    case RECORD_ORDER_PLACED:
+        if (getVarint(file, &u) != 0) return -1;
+        op->orderId = (int)u;
+        if (getString(file, reader->uid) != 0) return -1;
+        op->consumerUID = reader->uid;
+        if (getVarint(file, &u) != 0) return -1;
+        op->consumerType = (int)u;
+        if (getVarint(file, &u) != 0 || u > RECORDER_MAX_LINES) return -1;
+        op->lineCount = (int)u;
+        for (int i = 0; i < op->lineCount; i++) {
+            if (getSigned(file, &s) != 0) return -1;
+            reader->menuIds[i] = (int32_t)s;
+            if (getVarint(file, &u) != 0) return -1;
+            reader->quantities[i] = (int32_t)u;
+        }
+        op->menuIds = reader->menuIds;
+        op->quantities = reader->quantities;
+        break;
+    case RECORD_UNDO:
+    case RECORD_SERVE:
+        break;
+    default:
+        return -1;
+    }
+    reader->records++;
+    return 1;
+}
+
+void closeRecording(RecordingReader *reader){
+    if (!reader) return;
+    fclose(reader->file);
+    free(reader);
+}
@@ -0,0 +1,365 @@
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "../include/reportengine.h"
+#include "../include/memtrack.h"
+
+#define EMPTY_KEY LONG_MIN
+
+/* ===============================
+   Aggregation table
+   =============================== */
+
+typedef struct {
+    ReportRow row;
+    long lastOrder;           /* scan position of the last order counted, + 1 */
+} AggSlot;
+
+typedef struct {
+    AggSlot *slots;
+    int capacity;
+    int count;
+} AggTable;
+
+static int initTable(AggTable *table, int capacity){
+    table->slots = (AggSlot *)memCalloc(MEM_REPORTS, capacity, sizeof(AggSlot));
+    if (!table->slots) return -1;
+    for (int i = 0; i < capacity; i++) {
+        table->slots[i].row.key = EMPTY_KEY;
+    }
+    table->capacity = capacity;
+    table->count = 0;
+    return 0;
+}
+
+static int slotOf(const AggTable *table, long key){
+    int mask = table->capacity - 1;
+    int i = (int)(((unsigned long)key * 2654435761u) & (unsigned long)mask);
+    while (table->slots[i].row.key != EMPTY_KEY && table->slots[i].row.key != key) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+static AggSlot* slotFor(AggTable *table, long key){
+    AggSlot *slot = &table->slots[slotOf(table, key)];
+    if (slot->row.key != EMPTY_KEY) return slot;
+
+    if ((table->count + 1) * 2 > table->capacity) {
+        AggTable bigger;
+        if (initTable(&bigger, table->capacity * 2) != 0) return NULL;
+        for (int i = 0; i < table->capacity; i++) {
+            if (table->slots[i].row.key != EMPTY_KEY) {
+                bigger.slots[slotOf(&bigger, table->slots[i].row.key)] = table->slots[i];
+            }
+        }
+        bigger.count = table->count;
+        memFree(table->slots);
+        *table = bigger;
+        slot = &table->slots[slotOf(table, key)];
+    }
+    slot->row.key = key;
+    table->count++;
+    return slot;
+}
+
+/* ===============================
+   Workers
+   =============================== */
+
+typedef struct {
+    const OrderArchive *archive;
+    const ReportFilter *filter;
+    ReportGroup group;
+    int segment;              /* first row of the slice */
+    int row;
+    long rows;                /* rows in the slice */
+    AggTable table;
+    int failed;
+} ReportWorker;
+
+static long groupKey(ReportGroup group, time_t t, ConsumerType type){
+    switch (group) {
+    case REPORT_BY_CONSUMER_TYPE:
+        return (long)type;
+    case REPORT_BY_DAY:
+        return (long)(t / ARCHIVE_DAY_SECONDS);
+    case REPORT_BY_HOUR:
+        return (long)(((t % ARCHIVE_DAY_SECONDS) + ARCHIVE_DAY_SECONDS) % ARCHIVE_DAY_SECONDS / 3600);
+    default:
+        return 0;
+    }
+}
+
+static void* scanSlice(void *arg){
+    ReportWorker *w = (ReportWorker *)arg;
+    const ReportFilter *filter = w->filter;
+    const OrderArchive *archive = w->archive;
+    int s = w->segment;
+    int r = w->row;
+
+    for (long n = 1; n <= w->rows; n++, r++) {
+        while (r >= archive->segments[s]->count) {
+            s++;
+            r = 0;
+        }
+        const ArchiveSegment *seg = archive->segments[s];
+        ConsumerType type = (ConsumerType)seg->consumerTypes[r];
+
+        if (filter->typeMask && !(filter->typeMask & (1u << type))) continue;
+        if (seg->totals[r] < filter->minTotal) continue;
+
+        int first = seg->lineStart[r];
+        int last = seg->lineStart[r + 1];
+
+        if (w->group == REPORT_BY_ITEM) {
+            for (int l = first; l < last; l++) {
+                if (filter->menuId && seg->menuIds[l] != filter->menuId) continue;
+                AggSlot *slot = slotFor(&w->table, seg->menuIds[l]);
+                if (!slot) {
+                    w->failed = 1;
+                    return NULL;
+                }
+                if (slot->lastOrder != n) {
+                    slot->lastOrder = n;
+                    slot->row.orders++;
+                }
+                slot->row.units += seg->quantities[l];
+                slot->row.revenue += (double)seg->quantities[l] * seg->unitPrices[l];
+            }
+            continue;
+        }
+
+        long units = 0;
+        double revenue = 0.0;
+        int matched = 0;
+        for (int l = first; l < last; l++) {
+            if (filter->menuId && seg->menuIds[l] != filter->menuId) continue;
+            matched = 1;
+            units += seg->quantities[l];
+            revenue += (double)seg->quantities[l] * seg->unitPrices[l];
+        }
+        if (!matched) continue;
+
+        AggSlot *slot = slotFor(&w->table, groupKey(w->group, seg->times[r], type));
+        if (!slot) {
+            w->failed = 1;
+            return NULL;
+        }
+        slot->row.orders++;
+        slot->row.units += units;
+        slot->row.revenue += revenue;
+    }
+    return NULL;
+}
+
+/* Moves (segment, row) forward by n archived rows */
+static void advanceRows(const OrderArchive *archive, int *segment, int *row, long n){
+    while (n > 0 && *segment < archive->segmentCount) {
+        long left = archive->segments[*segment]->count - *row;
+        if (n < left) {
+            *row += (int)n;
+            return;
+        }
+        n -= left;
+        (*segment)++;
+        *row = 0;
+    }
+}
+
+static long rowsBetween(const OrderArchive *archive, const ArchiveCursor *start, const ArchiveCursor *end){
+    long rows = 0;
+    for (int s = start->segment; s < end->segment && s < archive->segmentCount; s++) {
+        rows += archive->segments[s]->count;
+    }
+    rows -= start->row;
+    if (end->segment < archive->segmentCount) rows += end->row;
+    return rows;
+}
+
+static int onlineCores(void){
+#ifdef _SC_NPROCESSORS_ONLN
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores > 0) return (int)cores;
+#endif
+    return 1;
+}
+
+static int compareRows(const void *a, const void *b){
+    long x = ((const ReportRow *)a)->key;
+    long y = ((const ReportRow *)b)->key;
+    return (x > y) - (x < y);
+}
+
+static double wallSeconds(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* ===============================
+   Public API
+   =============================== */
+
+ReportFilter reportFilterRange(time_t from, time_t to){
+    ReportFilter filter;
+    memset(&filter, 0, sizeof(filter));
+    filter.from = from;
+    filter.to = to;
+    return filter;
+}
+
+Report* runReport(const OrderArchive *archive, const ReportFilter *filter,
+                  ReportGroup group, int threads){
+    double started = wallSeconds();
+    ArchiveCursor start, end;
+    archiveSeek(archive, filter->from, filter->to, &start);
+    archiveSeek(archive, filter->to, filter->to, &end);
+    long total = filter->from < filter->to ? rowsBetween(archive, &start, &end) : 0;
+
+    if (threads <= 0) threads = onlineCores();
+    if (threads > REPORT_MAX_THREADS) threads = REPORT_MAX_THREADS;
+    if (threads > total / REPORT_MIN_ROWS_PER_THREAD) threads = (int)(total / REPORT_MIN_ROWS_PER_THREAD);
+    if (threads < 1) threads = 1;
+
+    Report *report = (Report *)memCalloc(MEM_REPORTS, 1, sizeof(Report));
+    ReportWorker *workers = (ReportWorker *)memCalloc(MEM_REPORTS, threads, sizeof(ReportWorker));
+    pthread_t *ids = (pthread_t *)memCalloc(MEM_REPORTS, threads, sizeof(pthread_t));
+    if (!report || !workers || !ids) {
+        fprintf(stderr, "Memory allocation failed\n");
+        memFree(report);
+        memFree(workers);
+        memFree(ids);
+        return NULL;
+    }
+
+    int segment = start.segment, row = start.row;
+    long assigned = 0;
+    for (int i = 0; i < threads; i++) {
+        ReportWorker *w = &workers[i];
+        long upTo = total * (i + 1) / threads;
+        w->archive = archive;
+        w->filter = filter;
+        w->group = group;
+        w->segment = segment;
+        w->row = row;
+        w->rows = upTo - assigned;
+        if (initTable(&w->table, 64) != 0) w->failed = 1;
+        advanceRows(archive, &segment, &row, w->rows);
+        assigned = upTo;
+    }
+
+    /* the calling thread scans the first slice itself */
+    int launched = 1;
+    for (int i = 1; i < threads; i++, launched++) {
+        if (pthread_create(&ids[i], NULL, scanSlice, &workers[i]) != 0) break;
+    }
+    if (!workers[0].failed) scanSlice(&workers[0]);
+    for (int i = 1; i < launched; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    /* slices whose thread failed to start run here */
+    for (int i = launched; i < threads; i++) {
+        if (!workers[i].failed) scanSlice(&workers[i]);
+    }
+
+    AggTable merged;
+    int failed = initTable(&merged, 64) != 0;
+    for (int i = 0; i < threads; i++) {
+        ReportWorker *w = &workers[i];
+        failed |= w->failed;
+        for (int k = 0; !failed && k < w->table.capacity; k++) {
+            const ReportRow *src = &w->table.slots[k].row;
+            if (src->key == EMPTY_KEY) continue;
+            AggSlot *slot = slotFor(&merged, src->key);
+            if (!slot) {
+                failed = 1;
+                break;
+            }
+            slot->row.orders += src->orders;
+            slot->row.units += src->units;
+            slot->row.revenue += src->revenue;
+        }
+        memFree(w->table.slots);
+    }
+    memFree(workers);
+    memFree(ids);
+
+    if (!failed) {
+        report->rows = (ReportRow *)memAlloc(MEM_REPORTS, (merged.count ? merged.count : 1) * sizeof(ReportRow));
+        failed = report->rows == NULL;
+    }
+    if (failed) {
+        fprintf(stderr, "Memory allocation failed\n");
+        memFree(merged.slots);
+        memFree(report);
+        return NULL;
+    }
+    for (int k = 0; k < merged.capacity; k++) {
+        if (merged.slots[k].row.key != EMPTY_KEY) {
+            report->rows[report->count++] = merged.slots[k].row;
+        }
+    }
+    memFree(merged.slots);
+    qsort(report->rows, report->count, sizeof(ReportRow), compareRows);
+
+    report->group = group;
+    report->scannedOrders = total;
+    report->threads = threads;
+    report->seconds = wallSeconds() - started;
+    return report;
+}
+
+const ReportRow* findReportRow(const Report *report, long key){
+    int lo = 0, hi = report->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (report->rows[mid].key < key) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < report->count && report->rows[lo].key == key) return &report->rows[lo];
+    return NULL;
+}
+
+void displayReport(const Report *report){
+    static const char *typeNames[] = { "Student", "Staff", "Faculty" };
+    static const char *headers[] = { "Item ID", "Consumer", "Day", "Hour" };
+    long orders = 0, units = 0;
+    double revenue = 0.0;
+
+    printf("\n%-12s %10s %10s %14s\n", headers[report->group], "Orders", "Units", "Revenue");
+    printf("--------------------------------------------------\n");
+    for (int i = 0; i < report->count; i++) {
+        const ReportRow *row = &report->rows[i];
+        char key[32];
+        if (report->group == REPORT_BY_CONSUMER_TYPE && row->key >= 0 && row->key < 3) {
+            snprintf(key, sizeof(key), "%s", typeNames[row->key]);
+        } else if (report->group == REPORT_BY_DAY) {
+            time_t day = (time_t)row->key * ARCHIVE_DAY_SECONDS;
+            strftime(key, sizeof(key), "%Y-%m-%d", gmtime(&day));
+        } else if (report->group == REPORT_BY_HOUR) {
+            snprintf(key, sizeof(key), "%02ld:00", row->key);
+        } else {
+            snprintf(key, sizeof(key), "%ld", row->key);
+        }
+        printf("%-12s %10ld %10ld %14.2f\n", key, row->orders, row->units, row->revenue);
+        orders += row->orders;
+        units += row->units;
+        revenue += row->revenue;
+    }
+    printf("--------------------------------------------------\n");
+    if (report->group == REPORT_BY_ITEM) {
+        /* an order with several items is counted once per item */
+        printf("%-12s %10s %10ld %14.2f\n", "Total", "-", units, revenue);
+    } else {
+        printf("%-12s %10ld %10ld %14.2f\n", "Total", orders, units, revenue);
+    }
+    printf("Scanned %ld orders with %d thread(s) in %.3f ms\n",
+           report->scannedOrders, report->threads, report->seconds * 1000.0);
+}
+
+void freeReport(Report *report){
+    if (!report) return;
+    memFree(report->rows);
+    memFree(report);
+}
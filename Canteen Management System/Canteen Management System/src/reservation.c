@@ -0,0 +1,100 @@
+#include <stdio.h>
+#include "../include/reservation.h"
+#include "../include/clocksource.h"
+#include "../include/memtrack.h"
+
+static void unhold(ReservationBook *book, Reservation *reservation){
+    if (reservation->idPrev) {
+        reservation->idPrev->idNext = reservation->idNext;
+    } else {
+        book->byId[reservation->reservationId & (RESERVATION_BUCKETS - 1)] = reservation->idNext;
+    }
+    if (reservation->idNext) {
+        reservation->idNext->idPrev = reservation->idPrev;
+    }
+    book->held--;
+    memFree(reservation);
+}
+
+/* Deadline passed: the timer is the first member, so it is the reservation */
+static void onHoldExpired(TimerNode *timer, void *context){
+    ReservationBook *book = (ReservationBook *)context;
+    Reservation *reservation = (Reservation *)timer;
+
+    for (const OrderItem *line = reservation->items; line != NULL; line = line->next) {
+        book->unitsReleased += line->quantity;
+    }
+    discardOrderItems(reservation->items);
+    book->expired++;
+    unhold(book, reservation);
+}
+
+ReservationBook* createReservationBook(uint64_t tickNanos){
+    ReservationBook *book = (ReservationBook *)memCalloc(MEM_ORDERS, 1, sizeof(ReservationBook));
+    if (!book) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    initTimingWheel(&book->wheel, tickNanos, clockNanos(), onHoldExpired, book);
+    book->nextReservationId = 1;
+    return book;
+}
+
+Reservation* reserveStock(ReservationBook *book, const Consumer *consumer,
+                          OrderItem *items, float totalAmount, uint64_t deadlineNanos){
+    expireReservations(book);       /* brings the wheel up to now after idle time */
+
+    Reservation *reservation = (Reservation *)memCalloc(MEM_ORDERS, 1, sizeof(Reservation));
+    if (!reservation) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    reservation->reservationId = book->nextReservationId;
+    book->nextReservationId = book->nextReservationId % 0x7FFFFFFF + 1;
+    reservation->consumer = consumer;
+    reservation->items = items;
+    reservation->totalAmount = totalAmount;
+    reservation->deadlineNanos = deadlineNanos;
+    armTimer(&book->wheel, &reservation->timer, deadlineNanos);
+
+    Reservation **bucket = &book->byId[reservation->reservationId & (RESERVATION_BUCKETS - 1)];
+    reservation->idNext = *bucket;
+    if (*bucket) (*bucket)->idPrev = reservation;
+    *bucket = reservation;
+    book->held++;
+    return reservation;
+}
+
+Reservation* findReservation(const ReservationBook *book, int reservationId){
+    Reservation *reservation = book->byId[reservationId & (RESERVATION_BUCKETS - 1)];
+    while (reservation && reservation->reservationId != reservationId) {
+        reservation = reservation->idNext;
+    }
+    return reservation;
+}
+
+Order* claimReservation(ReservationBook *book, Reservation *reservation,
+                        OrderQueue *queue, int orderId){
+    cancelTimer(&book->wheel, &reservation->timer);
+    Order *order = enqueueConsumerOrder(queue, orderId, reservation->consumer,
+                                        reservation->items, reservation->totalAmount);
+    book->claimed++;
+    unhold(book, reservation);
+    return order;
+}
+
+void cancelReservation(ReservationBook *book, Reservation *reservation){
+    cancelTimer(&book->wheel, &reservation->timer);
+    discardOrderItems(reservation->items);
+    unhold(book, reservation);
+}
+
+long expireReservations(ReservationBook *book){
+    return advanceTimingWheel(&book->wheel, clockNanos());
+}
+
+void freeReservationBook(ReservationBook *book){
+    if (!book) return;
+    fireAllTimers(&book->wheel);
+    memFree(book);
+}
@@ -0,0 +1,214 @@
+#include "../include/rushmetrics.h"
+#include "../include/memtrack.h"
+
+static const int bucketSeconds[RUSH_SPAN_COUNT] = { 1, 10, 60 };
+static const int bucketCounts[RUSH_SPAN_COUNT] = { 60, 90, 60 };
+
+/* ===============================
+   Ring windows
+   =============================== */
+
+/* Moves the window forward to slot, clearing buckets that fell out */
+static void advanceWindow(RushWindow *w, long slot){
+    if (slot <= w->latestSlot) return;
+    long steps = slot - w->latestSlot;
+    if (steps > w->bucketCount) steps = w->bucketCount;
+    for (long s = slot - steps + 1; s <= slot; s++) {
+        int i = (int)(s % w->bucketCount);
+        w->totalOrders -= w->orders[i];
+        w->totalRevenue -= w->revenue[i];
+        w->orders[i] = 0;
+        w->revenue[i] = 0.0;
+    }
+    w->latestSlot = slot;
+}
+
+static void addToWindow(RushWindow *w, time_t when, long orders, double revenue){
+    long slot = (long)(when / w->bucketSeconds);
+    advanceWindow(w, slot);
+    if (slot <= w->latestSlot - w->bucketCount) return;   /* too old */
+    int i = (int)(slot % w->bucketCount);
+    w->orders[i] += orders;
+    w->revenue[i] += revenue;
+    w->totalOrders += orders;
+    w->totalRevenue += revenue;
+}
+
+/* ===============================
+   Per-item demand
+   =============================== */
+
+static int itemSlot(const RushMetrics *rush, int menuId){
+    int mask = rush->capacity - 1;
+    int i = (int)(((unsigned)menuId * 2654435761u) & (unsigned)mask);
+    while (rush->items[i].menuId != 0 && rush->items[i].menuId != menuId) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+static int growItems(RushMetrics *rush){
+    ItemDemand *old = rush->items;
+    int oldCapacity = rush->capacity;
+
+    rush->capacity *= 2;
+    rush->items = (ItemDemand *)memCalloc(MEM_REPORTS, rush->capacity, sizeof(ItemDemand));
+    if (!rush->items) {
+        fprintf(stderr, "Memory allocation failed\n");
+        rush->items = old;
+        rush->capacity = oldCapacity;
+        return -1;
+    }
+    for (int i = 0; i < oldCapacity; i++) {
+        if (old[i].menuId != 0) {
+            rush->items[itemSlot(rush, old[i].menuId)] = old[i];
+        }
+    }
+    memFree(old);
+    return 0;
+}
+
+static void advanceItem(ItemDemand *d, long slot){
+    if (slot <= d->latestSlot) return;
+    long steps = slot - d->latestSlot;
+    if (steps > RUSH_ITEM_BUCKETS) steps = RUSH_ITEM_BUCKETS;
+    for (long s = slot - steps + 1; s <= slot; s++) {
+        int i = (int)(s % RUSH_ITEM_BUCKETS);
+        d->totalUnits -= d->units[i];
+        d->units[i] = 0;
+    }
+    d->latestSlot = slot;
+}
+
+static void addItemDemand(RushMetrics *rush, int menuId, time_t when, long units){
+    if ((rush->count + 1) * 10 > rush->capacity * 7 && growItems(rush) != 0) return;
+
+    ItemDemand *d = &rush->items[itemSlot(rush, menuId)];
+    long slot = (long)(when / 60);
+    if (d->menuId == 0) {
+        d->menuId = menuId;
+        d->latestSlot = slot;
+        rush->count++;
+    }
+    advanceItem(d, slot);
+    if (slot <= d->latestSlot - RUSH_ITEM_BUCKETS) return;
+    d->units[slot % RUSH_ITEM_BUCKETS] += units;
+    d->totalUnits += units;
+}
+
+/* ===============================
+   Public API
+   =============================== */
+
+void recordRushOrder(RushMetrics *rush, const Order *order, int sign){
+    for (int s = 0; s < RUSH_SPAN_COUNT; s++) {
+        addToWindow(&rush->windows[s], order->orderTime, sign, sign * (double)order->totalAmount);
+    }
+    for (OrderItem *line = order->items; line != NULL; line = line->next) {
+        addItemDemand(rush, line->menuItem->id, order->orderTime, sign * (long)line->quantity);
+    }
+}
+
+static void onOrderEvent(Order *order, OrderEvent event, void *context){
+    RushMetrics *rush = (RushMetrics *)context;
+    if (event == ORDER_ENQUEUED) {
+        recordRushOrder(rush, order, 1);
+    } else if (event == ORDER_CANCELLED) {
+        recordRushOrder(rush, order, -1);
+    }
+}
+
+RushMetrics* createRushMetrics(void){
+    RushMetrics *rush = (RushMetrics *)memCalloc(MEM_REPORTS, 1, sizeof(RushMetrics));
+    if (!rush) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    for (int s = 0; s < RUSH_SPAN_COUNT; s++) {
+        RushWindow *w = &rush->windows[s];
+        w->bucketSeconds = bucketSeconds[s];
+        w->bucketCount = bucketCounts[s];
+        w->orders = (long *)memCalloc(MEM_REPORTS, w->bucketCount, sizeof(long));
+        w->revenue = (double *)memCalloc(MEM_REPORTS, w->bucketCount, sizeof(double));
+        if (!w->orders || !w->revenue) {
+            fprintf(stderr, "Memory allocation failed\n");
+            freeRushMetrics(rush);
+            return NULL;
+        }
+    }
+    rush->capacity = 64;
+    rush->items = (ItemDemand *)memCalloc(MEM_REPORTS, rush->capacity, sizeof(ItemDemand));
+    if (!rush->items) {
+        fprintf(stderr, "Memory allocation failed\n");
+        freeRushMetrics(rush);
+        return NULL;
+    }
+    if (addOrderObserver(onOrderEvent, rush) != 0) {
+        freeRushMetrics(rush);
+        return NULL;
+    }
+    return rush;
+}
+
+RushRates getRushRates(RushMetrics *rush, RushSpan span, time_t now){
+    RushWindow *w = &rush->windows[span];
+    RushRates rates;
+    double minutes = w->bucketSeconds * w->bucketCount / 60.0;
+
+    advanceWindow(w, (long)(now / w->bucketSeconds));
+    rates.orders = w->totalOrders;
+    rates.revenue = w->totalRevenue;
+    rates.ordersPerMinute = w->totalOrders / minutes;
+    rates.revenuePerMinute = w->totalRevenue / minutes;
+    return rates;
+}
+
+long getItemDemand(RushMetrics *rush, int menuId, RushSpan span, time_t now){
+    ItemDemand *d = &rush->items[itemSlot(rush, menuId)];
+    if (d->menuId == 0) return 0;
+
+    long slot = (long)(now / 60);
+    advanceItem(d, slot);
+    if (span == RUSH_1_HOUR) return d->totalUnits;
+
+    int minutes = span == RUSH_15_MIN ? 15 : 1;
+    long units = 0;
+    for (int m = 0; m < minutes; m++) {
+        units += d->units[(slot - m) % RUSH_ITEM_BUCKETS];
+    }
+    return units;
+}
+
+void displayRushMetrics(RushMetrics *rush, time_t now){
+    static const char *labels[RUSH_SPAN_COUNT] = { "1 min", "15 min", "1 hour" };
+
+    printf("\n========== RUSH METRICS ==========\n");
+    printf("%-8s %8s %10s %10s %12s\n", "Window", "Orders", "Revenue", "Orders/m", "Revenue/m");
+    for (int s = 0; s < RUSH_SPAN_COUNT; s++) {
+        RushRates r = getRushRates(rush, s, now);
+        printf("%-8s %8ld %10.2f %10.2f %12.2f\n", labels[s], r.orders, r.revenue,
+               r.ordersPerMinute, r.revenuePerMinute);
+    }
+
+    /* per-minute curve from the 1-hour window */
+    RushWindow *w = &rush->windows[RUSH_1_HOUR];
+    printf("\nOrders per minute (last 15 min, newest last):\n");
+    for (long s = w->latestSlot - 14; s <= w->latestSlot; s++) {
+        long n = w->orders[s % w->bucketCount];
+        printf("%4ld min ago | %3ld ", w->latestSlot - s, n);
+        for (long i = 0; i < n && i < 50; i++) putchar('#');
+        putchar('\n');
+    }
+    printf("==================================\n");
+}
+
+void freeRushMetrics(RushMetrics *rush){
+    if (!rush) return;
+    removeOrderObserver(onOrderEvent, rush);
+    for (int s = 0; s < RUSH_SPAN_COUNT; s++) {
+        memFree(rush->windows[s].orders);
+        memFree(rush->windows[s].revenue);
+    }
+    memFree(rush->items);
+    memFree(rush);
+}
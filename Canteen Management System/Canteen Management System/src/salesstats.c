@@ -0,0 +1,206 @@
+#include "../include/salesstats.h"
+#include "../include/memtrack.h"
+
+static int slotOf(const SalesStats *stats, int menuId){
+    int mask = stats->capacity - 1;
+    int i = (int)(((unsigned)menuId * 2654435761u) & (unsigned)mask);
+    while (stats->items[i].menuId != 0 && stats->items[i].menuId != menuId) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+static int growTable(SalesStats *stats){
+    ItemSales *old = stats->items;
+    int oldCapacity = stats->capacity;
+
+    stats->capacity *= 2;
+    stats->items = (ItemSales *)memCalloc(MEM_REPORTS, stats->capacity, sizeof(ItemSales));
+    if (!stats->items) {
+        fprintf(stderr, "Memory allocation failed\n");
+        stats->items = old;
+        stats->capacity = oldCapacity;
+        return -1;
+    }
+    for (int i = 0; i < oldCapacity; i++) {
+        if (old[i].menuId != 0) {
+            stats->items[slotOf(stats, old[i].menuId)] = old[i];
+        }
+    }
+    memFree(old);
+    return 0;
+}
+
+static ItemSales* itemFor(SalesStats *stats, const Menu *item){
+    if ((stats->count + 1) * 10 > stats->capacity * 7 && growTable(stats) != 0) {
+        return NULL;
+    }
+    ItemSales *entry = &stats->items[slotOf(stats, item->id)];
+    if (entry->menuId == 0) {
+        entry->menuId = item->id;
+        entry->name = memStrdup(MEM_REPORTS, item->name);
+        stats->count++;
+    }
+    return entry;
+}
+
+void recordOrderSales(SalesStats *stats, const Order *order, int sign){
+    long units = 0;
+    for (OrderItem *line = order->items; line != NULL; line = line->next) {
+        ItemSales *entry = itemFor(stats, line->menuItem);
+        if (entry) {
+            entry->units += sign * line->quantity;
+            entry->revenue += sign * (double)line->unitPrice * line->quantity;
+        }
+        units += line->quantity;
+    }
+
+    SalesTotals *totals[2] = { &stats->overall, NULL };
+    if (order->consumerType >= 0 && order->consumerType < CONSUMER_TYPE_COUNT) {
+        totals[1] = &stats->byType[order->consumerType];
+    }
+    for (int t = 0; t < 2 && totals[t]; t++) {
+        totals[t]->orders += sign;
+        totals[t]->units += sign * units;
+        totals[t]->revenue += sign * (double)order->totalAmount;
+    }
+}
+
+static void onOrderEvent(Order *order, OrderEvent event, void *context){
+    SalesStats *stats = (SalesStats *)context;
+    if (event == ORDER_ENQUEUED) {
+        recordOrderSales(stats, order, 1);
+    } else if (event == ORDER_CANCELLED) {
+        recordOrderSales(stats, order, -1);
+    }
+}
+
+SalesStats* createSalesStats(void){
+    SalesStats *stats = (SalesStats *)memCalloc(MEM_REPORTS, 1, sizeof(SalesStats));
+    if (!stats) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    stats->capacity = 64;
+    stats->items = (ItemSales *)memCalloc(MEM_REPORTS, stats->capacity, sizeof(ItemSales));
+    if (!stats->items) {
+        fprintf(stderr, "Memory allocation failed\n");
+        memFree(stats);
+        return NULL;
+    }
+    if (addOrderObserver(onOrderEvent, stats) != 0) {
+        freeSalesStats(stats);
+        return NULL;
+    }
+    return stats;
+}
+
+const ItemSales* getItemSales(const SalesStats *stats, int menuId){
+    const ItemSales *entry = &stats->items[slotOf(stats, menuId)];
+    return entry->menuId != 0 ? entry : NULL;
+}
+
+SalesTotals getConsumerTypeSales(const SalesStats *stats, ConsumerType type){
+    SalesTotals none = { 0, 0, 0.0 };
+    if (type < 0 || type >= CONSUMER_TYPE_COUNT) return none;
+    return stats->byType[type];
+}
+
+/* ===============================
+   Top-N selection (min-heap of size n)
+   =============================== */
+
+static int lessThan(const ItemSales *a, const ItemSales *b, SalesRanking ranking){
+    if (ranking == RANK_BY_REVENUE) {
+        if (a->revenue != b->revenue) return a->revenue < b->revenue;
+    } else if (a->units != b->units) {
+        return a->units < b->units;
+    }
+    return a->menuId > b->menuId;
+}
+
+static void siftDown(ItemSales *heap, int size, int i, SalesRanking ranking){
+    for (;;) {
+        int smallest = i;
+        int l = 2 * i + 1, r = 2 * i + 2;
+        if (l < size && lessThan(&heap[l], &heap[smallest], ranking)) smallest = l;
+        if (r < size && lessThan(&heap[r], &heap[smallest], ranking)) smallest = r;
+        if (smallest == i) return;
+        ItemSales tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+int topSellers(const SalesStats *stats, int n, SalesRanking ranking, ItemSales *out){
+    int size = 0;
+    if (n <= 0) return 0;
+
+    for (int i = 0; i < stats->capacity; i++) {
+        const ItemSales *entry = &stats->items[i];
+        if (entry->menuId == 0 || entry->units <= 0) continue;
+        if (size < n) {
+            /* sift up */
+            int j = size++;
+            out[j] = *entry;
+            while (j > 0 && lessThan(&out[j], &out[(j - 1) / 2], ranking)) {
+                ItemSales tmp = out[j];
+                out[j] = out[(j - 1) / 2];
+                out[(j - 1) / 2] = tmp;
+                j = (j - 1) / 2;
+            }
+        } else if (lessThan(&out[0], entry, ranking)) {
+            out[0] = *entry;
+            siftDown(out, size, 0, ranking);
+        }
+    }
+
+    /* heap sort in place: repeatedly move the smallest to the back */
+    for (int end = size - 1; end > 0; end--) {
+        ItemSales tmp = out[0];
+        out[0] = out[end];
+        out[end] = tmp;
+        siftDown(out, end, 0, ranking);
+    }
+    return size;
+}
+
+void displaySalesReport(const SalesStats *stats, int n){
+    static const char *typeNames[CONSUMER_TYPE_COUNT] = { "STUDENT", "STAFF", "FACULTY" };
+
+    printf("\n========== SALES REPORT ==========\n");
+    printf("%-10s %8s %8s %12s\n", "Type", "Orders", "Units", "Revenue");
+    for (int t = 0; t < CONSUMER_TYPE_COUNT; t++) {
+        printf("%-10s %8ld %8ld %12.2f\n", typeNames[t], stats->byType[t].orders,
+               stats->byType[t].units, stats->byType[t].revenue);
+    }
+    printf("%-10s %8ld %8ld %12.2f\n", "TOTAL", stats->overall.orders,
+           stats->overall.units, stats->overall.revenue);
+
+    if (n > 0) {
+        ItemSales *top = (ItemSales *)memAlloc(MEM_REPORTS, n * sizeof(ItemSales));
+        if (!top) return;
+        int found = topSellers(stats, n, RANK_BY_UNITS, top);
+        printf("\nTop %d bestsellers:\n", n);
+        printf("%-4s %-20s %8s %12s\n", "#", "Item", "Units", "Revenue");
+        for (int i = 0; i < found; i++) {
+            printf("%-4d %-20s %8ld %12.2f\n", i + 1, top[i].name, top[i].units, top[i].revenue);
+        }
+        if (found == 0) {
+            printf("No sales yet.\n");
+        }
+        memFree(top);
+    }
+    printf("==================================\n");
+}
+
+void freeSalesStats(SalesStats *stats){
+    if (!stats) return;
+    removeOrderObserver(onOrderEvent, stats);
+    for (int i = 0; i < stats->capacity; i++) {
+        memFree(stats->items[i].name);
+    }
+    memFree(stats->items);
+    memFree(stats);
+}
@@ -0,0 +1,116 @@
+#include <string.h>
+#include "../include/scheduler.h"
+#include "../include/ordertrace.h"
+#include "../include/clocksource.h"
+#include "../include/memtrack.h"
+
+#define NANOS_PER_MINUTE 60000000000ULL
+
+static const char *classNames[PRIORITY_CLASS_COUNT] = { "faculty", "staff", "student", "bulk" };
+
+SchedulerConfig defaultSchedulerConfig(void){
+    SchedulerConfig config;
+    config.targetNanos[PRIORITY_FACULTY] = 3 * NANOS_PER_MINUTE;
+    config.targetNanos[PRIORITY_STAFF] = 6 * NANOS_PER_MINUTE;
+    config.targetNanos[PRIORITY_STUDENT] = 10 * NANOS_PER_MINUTE;
+    config.targetNanos[PRIORITY_BULK] = 20 * NANOS_PER_MINUTE;
+    config.bulkUnits = 10;
+    return config;
+}
+
+PriorityClass classifyOrder(const SchedulerConfig *config, const Order *order){
+    int units = 0;
+    for (const OrderItem *line = order->items; line != NULL; line = line->next) {
+        units += line->quantity;
+    }
+    if (units >= config->bulkUnits) return PRIORITY_BULK;
+    switch (order->consumerType) {
+    case FACULTY: return PRIORITY_FACULTY;
+    case STAFF: return PRIORITY_STAFF;
+    default: return PRIORITY_STUDENT;
+    }
+}
+
+const char* priorityClassName(PriorityClass priorityClass){
+    return classNames[priorityClass];
+}
+
+/* Keeps the scheduler in step with the queue: every other event means the order stopped waiting */
+static void onOrderEvent(Order *order, OrderEvent event, void *context){
+    OrderScheduler *scheduler = (OrderScheduler *)context;
+    if (event == ORDER_ENQUEUED) {
+        scheduleOrder(scheduler, order);
+    } else {
+        unscheduleOrder(scheduler, order);
+    }
+}
+
+OrderScheduler* createOrderScheduler(const SchedulerConfig *config){
+    OrderScheduler *scheduler = (OrderScheduler *)memCalloc(MEM_ORDERS, 1, sizeof(OrderScheduler));
+    if (!scheduler) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    scheduler->config = config ? *config : defaultSchedulerConfig();
+    if (addOrderObserver(onOrderEvent, scheduler) != 0) {
+        memFree(scheduler);
+        return NULL;
+    }
+    return scheduler;
+}
+
+void scheduleOrder(OrderScheduler *scheduler, Order *order){
+    if (order->priorityClass >= 0) return;
+
+    PriorityClass c = classifyOrder(&scheduler->config, order);
+    order->priorityClass = c;
+    order->deadlineNanos = clockNanos() + scheduler->config.targetNanos[c];
+    order->classPrev = scheduler->tails[c];
+    order->classNext = NULL;
+    if (scheduler->tails[c]) scheduler->tails[c]->classNext = order;
+    else scheduler->heads[c] = order;
+    scheduler->tails[c] = order;
+    scheduler->counts[c]++;
+    scheduler->count++;
+}
+
+void unscheduleOrder(OrderScheduler *scheduler, Order *order){
+    int c = order->priorityClass;
+    if (c < 0) return;
+
+    if (order->classPrev) order->classPrev->classNext = order->classNext;
+    else scheduler->heads[c] = order->classNext;
+    if (order->classNext) order->classNext->classPrev = order->classPrev;
+    else scheduler->tails[c] = order->classPrev;
+    order->classPrev = NULL;
+    order->classNext = NULL;
+    order->priorityClass = -1;
+    scheduler->counts[c]--;
+    scheduler->count--;
+}
+
+Order* startScheduledOrder(OrderScheduler *scheduler){
+    Order *next = NULL;
+    /* ties go to the more urgent class */
+    for (int c = 0; c < PRIORITY_CLASS_COUNT; c++) {
+        Order *head = scheduler->heads[c];
+        if (head && (!next || head->deadlineNanos < next->deadlineNanos)) {
+            next = head;
+        }
+    }
+    if (next) {
+        unscheduleOrder(scheduler, next);
+        markOrderStage(next, STAGE_STARTED);
+    }
+    return next;
+}
+
+void freeOrderScheduler(OrderScheduler *scheduler){
+    if (!scheduler) return;
+    removeOrderObserver(onOrderEvent, scheduler);
+    /* orders belong to the queue; only detach them */
+    for (int c = 0; c < PRIORITY_CLASS_COUNT; c++) {
+        while (scheduler->heads[c]) unscheduleOrder(scheduler, scheduler->heads[c]);
+    }
+    memFree(scheduler);
+}
@@ -0,0 +1,183 @@
+#include <math.h>
+#include "../include/stockalert.h"
+#include "../include/clocksource.h"
+#include "../include/memtrack.h"
+
+static int slotOf(const StockForecaster *f, int menuId){
+    int mask = f->capacity - 1;
+    int i = (int)(((unsigned)menuId * 2654435761u) & (unsigned)mask);
+    while (f->items[i].menuId != 0 && f->items[i].menuId != menuId) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+static int growTable(StockForecaster *f){
+    ItemRate *old = f->items;
+    int oldCapacity = f->capacity;
+
+    f->capacity *= 2;
+    f->items = (ItemRate *)memCalloc(MEM_REPORTS, f->capacity, sizeof(ItemRate));
+    if (!f->items) {
+        fprintf(stderr, "Memory allocation failed\n");
+        f->items = old;
+        f->capacity = oldCapacity;
+        return -1;
+    }
+    for (int i = 0; i < oldCapacity; i++) {
+        if (old[i].menuId != 0) {
+            f->items[slotOf(f, old[i].menuId)] = old[i];
+        }
+    }
+    memFree(old);
+    return 0;
+}
+
+static ItemRate* rateFor(StockForecaster *f, int menuId, time_t now){
+    if ((f->count + 1) * 10 > f->capacity * 7 && growTable(f) != 0) return NULL;
+
+    ItemRate *r = &f->items[slotOf(f, menuId)];
+    if (r->menuId == 0) {
+        r->menuId = menuId;
+        r->rate = 0.0;
+        r->updated = now;
+        f->count++;
+    }
+    return r;
+}
+
+/* Decays the rate to now: rate(t) = rate * e^(-dt/tau) */
+static void decay(const StockForecaster *f, ItemRate *r, time_t now){
+    double dt = difftime(now, r->updated);
+    if (dt > 0) {
+        r->rate *= exp(-dt / f->tau);
+        r->updated = now;
+    }
+}
+
+static void raiseAlert(StockForecaster *f, const Menu *item, const ItemRate *r,
+                       RestockReason reason, double minutesLeft, time_t now){
+    RestockAlert alert;
+    alert.menuId = item->id;
+    strncpy(alert.name, item->name, sizeof(alert.name) - 1);
+    alert.name[sizeof(alert.name) - 1] = '\0';
+    alert.quantity = item->quantity;
+    alert.unitsPerMinute = r->rate * 60.0;
+    alert.minutesToStockout = minutesLeft;
+    alert.reason = reason;
+    alert.when = now;
+
+    if (f->callback) {
+        f->callback(&alert, f->context);
+        return;
+    }
+    if (f->pendingCount == RESTOCK_QUEUE_SIZE) {
+        /* drop the oldest so the newest state is always visible */
+        f->pendingHead = (f->pendingHead + 1) % RESTOCK_QUEUE_SIZE;
+        f->pendingCount--;
+    }
+    f->pending[(f->pendingHead + f->pendingCount) % RESTOCK_QUEUE_SIZE] = alert;
+    f->pendingCount++;
+}
+
+static void onMenuChange(Menu *item, MenuEvent event, void *context){
+    StockForecaster *f = (StockForecaster *)context;
+    if (event == MENU_STOCK_CHANGING) {
+        f->changingFrom = item->quantity;
+        return;
+    }
+    if (event != MENU_STOCK_CHANGED) return;
+
+    time_t now = clockTime();
+    ItemRate *r = rateFor(f, item->id, now);
+    if (!r) return;
+
+    decay(f, r, now);
+    int sold = f->changingFrom - item->quantity;
+    if (sold > 0) {
+        /* each unit adds 1/tau, so a steady flow converges to its true rate */
+        r->rate += sold / f->tau;
+    }
+
+    double minutesLeft = r->rate > 0 ? item->quantity / r->rate / 60.0 : -1.0;
+    int low = item->quantity <= f->minQuantity;
+    int soon = minutesLeft >= 0 && minutesLeft < f->horizonMinutes;
+
+    if (!r->alerted && (low || soon)) {
+        r->alerted = 1;
+        raiseAlert(f, item, r, low ? RESTOCK_LOW_QUANTITY : RESTOCK_PREDICTED_STOCKOUT,
+                   minutesLeft, now);
+    } else if (r->alerted && !low && !soon) {
+        r->alerted = 0;     /* restocked: allow the next alert */
+    }
+}
+
+StockForecaster* createStockForecaster(double halfLifeMinutes, double horizonMinutes,
+                                       int minQuantity, RestockCallback callback,
+                                       void *context){
+    StockForecaster *f = (StockForecaster *)memCalloc(MEM_REPORTS, 1, sizeof(StockForecaster));
+    if (!f) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    f->capacity = 64;
+    f->items = (ItemRate *)memCalloc(MEM_REPORTS, f->capacity, sizeof(ItemRate));
+    if (!f->items) {
+        fprintf(stderr, "Memory allocation failed\n");
+        memFree(f);
+        return NULL;
+    }
+    f->tau = halfLifeMinutes * 60.0 / log(2.0);
+    f->horizonMinutes = horizonMinutes;
+    f->minQuantity = minQuantity;
+    f->callback = callback;
+    f->context = context;
+    if (addMenuObserver(onMenuChange, f) != 0) {
+        freeStockForecaster(f);
+        return NULL;
+    }
+    return f;
+}
+
+double getDemandRate(StockForecaster *forecaster, int menuId, time_t now){
+    ItemRate *r = &forecaster->items[slotOf(forecaster, menuId)];
+    if (r->menuId == 0) return 0.0;
+    decay(forecaster, r, now);
+    return r->rate * 60.0;
+}
+
+double predictStockout(StockForecaster *forecaster, const Menu *item, time_t now){
+    double perMinute = getDemandRate(forecaster, item->id, now);
+    if (perMinute <= 0.0) return -1.0;
+    return item->quantity / perMinute;
+}
+
+int pollRestockAlert(StockForecaster *forecaster, RestockAlert *alert){
+    if (forecaster->pendingCount == 0) return 0;
+    *alert = forecaster->pending[forecaster->pendingHead];
+    forecaster->pendingHead = (forecaster->pendingHead + 1) % RESTOCK_QUEUE_SIZE;
+    forecaster->pendingCount--;
+    return 1;
+}
+
+void displayStockForecast(StockForecaster *forecaster, Menu *head){
+    time_t now = clockTime();
+    printf("\n%-4s %-20s %6s %10s %14s\n", "ID", "Name", "Stock", "Units/min", "Minutes left");
+    printf("----------------------------------------------------------\n");
+    for (Menu *item = head; item != NULL; item = item->next) {
+        double perMinute = getDemandRate(forecaster, item->id, now);
+        double left = predictStockout(forecaster, item, now);
+        if (left < 0) {
+            printf("%-4d %-20s %6d %10.2f %14s\n", item->id, item->name, item->quantity, perMinute, "-");
+        } else {
+            printf("%-4d %-20s %6d %10.2f %14.1f\n", item->id, item->name, item->quantity, perMinute, left);
+        }
+    }
+}
+
+void freeStockForecaster(StockForecaster *forecaster){
+    if (!forecaster) return;
+    removeMenuObserver(onMenuChange, forecaster);
+    memFree(forecaster->items);
+    memFree(forecaster);
+}
@@ -0,0 +1,137 @@
+#include <stddef.h>
+#include "../include/timerwheel.h"
+
+#define SLOT_MASK (WHEEL_SLOTS - 1)
+
+static void linkTimer(TimerNode *head, TimerNode *timer){
+    timer->prev = head->prev;
+    timer->next = head;
+    head->prev->next = timer;
+    head->prev = timer;
+}
+
+static void unlinkTimer(TimerNode *timer){
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->prev = timer->next = NULL;
+}
+
+/* Level whose span covers the delta; deadlines past the top level wait in its last slot */
+static void placeTimer(TimingWheel *wheel, TimerNode *timer){
+    uint64_t expires = timer->expiresTick;
+    uint64_t delta = expires - wheel->currentTick;
+
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        if (delta < (1ULL << (WHEEL_SLOT_BITS * (level + 1)))) {
+            linkTimer(&wheel->slots[level][(expires >> (WHEEL_SLOT_BITS * level)) & SLOT_MASK], timer);
+            return;
+        }
+    }
+    int top = WHEEL_LEVELS - 1;
+    uint64_t last = wheel->currentTick + (1ULL << (WHEEL_SLOT_BITS * WHEEL_LEVELS)) - 1;
+    linkTimer(&wheel->slots[top][(last >> (WHEEL_SLOT_BITS * top)) & SLOT_MASK], timer);
+}
+
+/* Moves a slot's timers onto an empty list head */
+static void detachSlot(TimerNode *head, TimerNode *list){
+    list->next = list->prev = list;
+    if (head->next == head) return;
+    list->next = head->next;
+    list->prev = head->prev;
+    list->next->prev = list;
+    list->prev->next = list;
+    head->next = head->prev = head;
+}
+
+/* Detaches the slot first so callbacks can arm into it */
+static long fireSlot(TimingWheel *wheel, TimerNode *head){
+    TimerNode due;
+    long fired = 0;
+
+    detachSlot(head, &due);
+    while (due.next != &due) {
+        TimerNode *timer = due.next;
+        unlinkTimer(timer);
+        wheel->count--;
+        fired++;
+        wheel->fire(timer, wheel->context);
+    }
+    return fired;
+}
+
+/* Moves one slot's timers down to the levels that now cover them; runs before the
+   current tick's level 0 slot fires, so timers due now land in that slot */
+static void cascade(TimingWheel *wheel, int level, int slot){
+    TimerNode pending;
+
+    detachSlot(&wheel->slots[level][slot], &pending);
+    while (pending.next != &pending) {
+        TimerNode *timer = pending.next;
+        unlinkTimer(timer);
+        placeTimer(wheel, timer);
+    }
+}
+
+void initTimingWheel(TimingWheel *wheel, uint64_t tickNanos, uint64_t nowNanos,
+                     TimerCallback fire, void *context){
+    wheel->tickNanos = tickNanos > 0 ? tickNanos : 1;
+    wheel->currentTick = nowNanos / wheel->tickNanos;
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < WHEEL_SLOTS; slot++) {
+            TimerNode *head = &wheel->slots[level][slot];
+            head->next = head->prev = head;
+        }
+    }
+    wheel->count = 0;
+    wheel->fire = fire;
+    wheel->context = context;
+}
+
+void armTimer(TimingWheel *wheel, TimerNode *timer, uint64_t deadlineNanos){
+    /* round up: never fire before the deadline */
+    uint64_t expires = deadlineNanos / wheel->tickNanos + (deadlineNanos % wheel->tickNanos != 0);
+    timer->expiresTick = expires > wheel->currentTick ? expires : wheel->currentTick + 1;
+    placeTimer(wheel, timer);
+    wheel->count++;
+}
+
+void cancelTimer(TimingWheel *wheel, TimerNode *timer){
+    if (!timer->prev) return;
+    unlinkTimer(timer);
+    wheel->count--;
+}
+
+int isTimerArmed(const TimerNode *timer){
+    return timer->prev != NULL;
+}
+
+long advanceTimingWheel(TimingWheel *wheel, uint64_t nowNanos){
+    uint64_t target = nowNanos / wheel->tickNanos;
+    long fired = 0;
+
+    while (wheel->currentTick < target) {
+        if (wheel->count == 0) {
+            wheel->currentTick = target;        /* nothing armed: skip the idle ticks */
+            break;
+        }
+        uint64_t tick = ++wheel->currentTick;
+        int slot = (int)(tick & SLOT_MASK);
+        for (int level = 1; level < WHEEL_LEVELS && slot == 0; level++) {
+            slot = (int)((tick >> (WHEEL_SLOT_BITS * level)) & SLOT_MASK);
+            cascade(wheel, level, slot);
+        }
+
+        fired += fireSlot(wheel, &wheel->slots[0][tick & SLOT_MASK]);
+    }
+    return fired;
+}
+
+long fireAllTimers(TimingWheel *wheel){
+    long fired = 0;
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < WHEEL_SLOTS; slot++) {
+            fired += fireSlot(wheel, &wheel->slots[level][slot]);
+        }
+    }
+    return fired;
+}
@@ -1,17 +1,24 @@
 #include "../include/undo.h"
+#include "../include/metrics.h"
+#include "../include/memtrack.h"
+#include "../include/ordertrace.h"
+#include "../include/recorder.h"
 
 OrderStack* createOrderStack(){
-    OrderStack *stack = (OrderStack *)malloc(sizeof(OrderStack));
+    OrderStack *stack = (OrderStack *)memAlloc(MEM_UNDO, sizeof(OrderStack));
     stack->top = NULL;
     stack->count = 0;
     return stack;
 }
 
 void pushOrder(OrderStack *stack, Order *order){
-    OrderStackNode *newNode = (OrderStackNode *)malloc(sizeof(OrderStackNode));
+    OrderStackNode *newNode = (OrderStackNode *)memAlloc(MEM_UNDO, sizeof(OrderStackNode));
     newNode->order = order;
+    newNode->prev = NULL;
     newNode->next = stack->top;
+    if (stack->top) stack->top->prev = newNode;
     stack->top = newNode;
+    order->undoNode = newNode;
     stack->count++;
 }
 
@@ -22,54 +29,80 @@ Order* popOrder(OrderStack *stack){
     OrderStackNode *temp = stack->top;
     Order *poppedOrder = temp->order;
     stack->top = stack->top->next;
-    free(temp);
+    if (stack->top) stack->top->prev = NULL;
+    poppedOrder->undoNode = NULL;
+    memFree(temp);
     stack->count--;
     return poppedOrder;
 }
 
 /*  Undoing last order(restck item)*/
-int undoLastOrder(OrderStack *stack, OrderQueue *queue){
+int revertLastOrder(OrderStack *stack, OrderQueue *queue){
+    METRIC_START(started);
+    /* the kitchen has started cooking it: it stays on the stack until it is served */
+    if(stack->top && stack->top->order->stageNanos[STAGE_STARTED] != 0){
+        METRIC_COUNT(COUNTER_UNDO_MISSES, 1);
+        return -3;
+    }
     Order *lastOrder = popOrder(stack);
     if(lastOrder == NULL){
-        printf("No order to undo.\n");
+        METRIC_COUNT(COUNTER_UNDO_MISSES, 1);
         return -1;
     }
     
-    /* STEP 1: Restore stock levels FIRST */
+    /* STEP 1: Remove order from queue */
+    if (!isQueued(queue, lastOrder)) {
+        return -2;
+    }
+    removeQueuedOrder(queue, lastOrder);
+
+    /* STEP 2: Restore stock and free the order */
+    int orderId = lastOrder->orderId;
     restoreStockLevels(lastOrder);
-    
-    /* STEP 2: Remove order from queue */
-    Order *current = queue->front;
-    Order *previous = NULL;
-    int found = 0;
-    
-    while(current != NULL){
-        if(current == lastOrder){  /* Compare pointers directly */
-            if(previous == NULL){
-                queue->front = current->next;
-            } else {
-                previous->next = current->next;
-            }
-            if(current == queue->rear){
-                queue->rear = previous;
-            }
-            queue->count--;
-            found = 1;
-            break;
-        }
-        previous = current;
-        current = current->next;
+    markOrderStage(lastOrder, STAGE_CANCELLED);
+    notifyOrderObservers(lastOrder, ORDER_CANCELLED);
+    freeOrder(lastOrder);
+    RECORD_OP(recordEvent(RECORD_UNDO));
+    METRIC_COUNT(COUNTER_ORDERS_UNDONE, 1);
+    METRIC_STOP(METRIC_UNDO, started);
+    return orderId;
+}
+
+int undoLastOrder(OrderStack *stack, OrderQueue *queue){
+    int orderId = revertLastOrder(stack, queue);
+    if (orderId == -1) {
+        printf("No order to undo.\n");
+        return -1;
     }
-    
-    /* STEP 3: Free the order */
-    if (found) {
-        printf("Order ID %d undone successfully. Stock restored.\n", lastOrder->orderId);
-        freeOrder(lastOrder);
-        return 0;
-    } else {
+    if (orderId == -2) {
         printf("Error: Order not found in queue.\n");
         return -1;
     }
+    if (orderId == -3) {
+        printf("Order ID %d is already being prepared and cannot be undone.\n", stack->top->order->orderId);
+        return -1;
+    }
+    printf("Order ID %d undone successfully. Stock restored.\n", orderId);
+    return 0;
+}
+
+int forgetOrder(OrderStack *stack, Order *order){
+    OrderStackNode *node = order->undoNode;
+    if(node == NULL){
+        return -1;
+    }
+    if(node->prev){
+        node->prev->next = node->next;
+    } else {
+        stack->top = node->next;
+    }
+    if(node->next){
+        node->next->prev = node->prev;
+    }
+    order->undoNode = NULL;
+    memFree(node);
+    stack->count--;
+    return 0;
 }
 
 void freeOrderStack(OrderStack *stack){
@@ -78,8 +111,8 @@ void freeOrderStack(OrderStack *stack){
     while(current != NULL){
         nextNode = current->next;
         
-        free(current);
+        memFree(current);
         current = nextNode;
     }
-    free(stack);
+    memFree(stack);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../include/user.h"
+#include "../include/memtrack.h"
 
 
 /*
@@ -9,13 +10,13 @@
 */
 User* createUser(const char *uid, const char *name, const char *username,
                  const char *password, Role role) {
-    User *user = (User*)malloc(sizeof(User));
+    User *user = (User*)memAlloc(MEM_USERS, sizeof(User));
     if (!user) return NULL;
 
-    user->uid = strdup(uid);
-    user->name = strdup(name);
-    user->username = strdup(username);
-    user->password = strdup(password);
+    user->uid = memStrdup(MEM_USERS, uid);
+    user->name = memStrdup(MEM_USERS, name);
+    user->username = memStrdup(MEM_USERS, username);
+    user->password = memStrdup(MEM_USERS, password);
     user->role = role;
     user->next = NULL;
 
@@ -91,14 +92,14 @@ void editUser(User *head, const char *uid, const char *newName,
 
     while (head) {
         if (strcmp(head->uid, uid) == 0) {
-            free(head->name);
-            head->name = strdup(newName);
+            memFree(head->name);
+            head->name = memStrdup(MEM_USERS, newName);
 
-            free(head->username);
-            head->username = strdup(newUsername);
+            memFree(head->username);
+            head->username = memStrdup(MEM_USERS, newUsername);
 
-            free(head->password);
-            head->password = strdup(newPassword);
+            memFree(head->password);
+            head->password = memStrdup(MEM_USERS, newPassword);
 
             head->role = newRole;
             return;
@@ -116,10 +117,10 @@ void freeUsers(User *head) {
         User *temp = head;
         head = head->next;
 
-        free(temp->uid);
-        free(temp->name);
-        free(temp->username);
-        free(temp->password);
-        free(temp);
+        memFree(temp->uid);
+        memFree(temp->name);
+        memFree(temp->username);
+        memFree(temp->password);
+        memFree(temp);
     }
 }
@@ -0,0 +1,322 @@
+#ifdef _WIN32
+#define _CRT_RAND_S           /* declares rand_s() */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/userindex.h"
+#include "../include/clocksource.h"
+#include "../include/memtrack.h"
+
+/* ===============================
+   User Index
+   =============================== */
+
+static uint32_t hashString(const char *s){
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static const char* keyOf(const User *user, int byUid){
+    return byUid ? user->uid : user->username;
+}
+
+/* Returns the slot holding key, or the empty slot where it would go */
+static int probe(User **slots, int capacity, const char *key, int byUid){
+    int mask = capacity - 1;
+    int i = (int)(hashString(key) & (uint32_t)mask);
+    while (slots[i] != NULL && strcmp(keyOf(slots[i], byUid), key) != 0) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/* Backward-shift deletion keeps probe chains intact without tombstones */
+static void removeSlot(User **slots, int capacity, int hole, int byUid){
+    int mask = capacity - 1;
+    int i = hole;
+    slots[hole] = NULL;
+    for (;;) {
+        i = (i + 1) & mask;
+        if (slots[i] == NULL) return;
+        int home = (int)(hashString(keyOf(slots[i], byUid)) & (uint32_t)mask);
+        /* move the entry back if the hole lies between its home and i */
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            slots[hole] = slots[i];
+            slots[i] = NULL;
+            hole = i;
+        }
+    }
+}
+
+static int growIndex(UserIndex *index){
+    int capacity = index->capacity * 2;
+    User **byUsername = (User **)memCalloc(MEM_USERS, capacity, sizeof(User *));
+    User **byUid = (User **)memCalloc(MEM_USERS, capacity, sizeof(User *));
+    if (!byUsername || !byUid) {
+        fprintf(stderr, "Memory allocation failed\n");
+        memFree(byUsername);
+        memFree(byUid);
+        return -1;
+    }
+    for (int i = 0; i < index->capacity; i++) {
+        User *user = index->byUsername[i];
+        if (user) {
+            byUsername[probe(byUsername, capacity, user->username, 0)] = user;
+            byUid[probe(byUid, capacity, user->uid, 1)] = user;
+        }
+    }
+    memFree(index->byUsername);
+    memFree(index->byUid);
+    index->byUsername = byUsername;
+    index->byUid = byUid;
+    index->capacity = capacity;
+    return 0;
+}
+
+static int indexUser(UserIndex *index, User *user){
+    if ((index->count + 1) * 10 > index->capacity * 7 && growIndex(index) != 0) {
+        return -1;
+    }
+    int nameSlot = probe(index->byUsername, index->capacity, user->username, 0);
+    if (index->byUsername[nameSlot] != NULL) {
+        fprintf(stderr, "Username %s is already taken.\n", user->username);
+        return -1;
+    }
+    int uidSlot = probe(index->byUid, index->capacity, user->uid, 1);
+    if (index->byUid[uidSlot] != NULL) {
+        fprintf(stderr, "UID %s is already taken.\n", user->uid);
+        return -1;
+    }
+    index->byUsername[nameSlot] = user;
+    index->byUid[uidSlot] = user;
+    index->count++;
+    return 0;
+}
+
+UserIndex* createUserIndex(User *head){
+    UserIndex *index = (UserIndex *)memAlloc(MEM_USERS, sizeof(UserIndex));
+    if (!index) return NULL;
+
+    index->capacity = 16;
+    index->count = 0;
+    index->byUsername = (User **)memCalloc(MEM_USERS, index->capacity, sizeof(User *));
+    index->byUid = (User **)memCalloc(MEM_USERS, index->capacity, sizeof(User *));
+    if (!index->byUsername || !index->byUid) {
+        freeUserIndex(index);
+        return NULL;
+    }
+    while (head) {
+        indexUser(index, head);
+        head = head->next;
+    }
+    return index;
+}
+
+int registerUser(User **head, UserIndex *index, User *user){
+    if (!head || !index || !user) return -1;
+
+    if (indexUser(index, user) != 0) {
+        freeUsers(user);
+        return -1;
+    }
+    addUser(head, user);
+    return 0;
+}
+
+User* findIndexedUser(UserIndex *index, const char *username){
+    return index->byUsername[probe(index->byUsername, index->capacity, username, 0)];
+}
+
+User* findUserByUid(UserIndex *index, const char *uid){
+    return index->byUid[probe(index->byUid, index->capacity, uid, 1)];
+}
+
+User* loginIndexed(UserIndex *index, const char *username, const char *password){
+    User *user = findIndexedUser(index, username);
+    if (!user) return NULL;
+
+    if (strcmp(user->password, password) == 0)
+        return user;
+
+    return NULL; // password mismatch
+}
+
+int editIndexedUser(UserIndex *index, const char *uid, const char *newName,
+                    const char *newUsername, const char *newPassword, Role newRole){
+    User *user = findUserByUid(index, uid);
+    if (!user) {
+        fprintf(stderr, "User with UID %s not found.\n", uid);
+        return -1;
+    }
+    User *owner = findIndexedUser(index, newUsername);
+    if (owner && owner != user) {
+        fprintf(stderr, "Username %s is already taken.\n", newUsername);
+        return -1;
+    }
+
+    removeSlot(index->byUsername, index->capacity,
+               probe(index->byUsername, index->capacity, user->username, 0), 0);
+
+    memFree(user->name);
+    user->name = memStrdup(MEM_USERS, newName);
+
+    memFree(user->username);
+    user->username = memStrdup(MEM_USERS, newUsername);
+
+    memFree(user->password);
+    user->password = memStrdup(MEM_USERS, newPassword);
+
+    user->role = newRole;
+
+    index->byUsername[probe(index->byUsername, index->capacity, user->username, 0)] = user;
+    return 0;
+}
+
+void freeUserIndex(UserIndex *index){
+    if (!index) return;
+    memFree(index->byUsername);
+    memFree(index->byUid);
+    memFree(index);
+}
+
+/* ===============================
+   Session Table
+   =============================== */
+
+#define SESSION_MASK (SESSION_TABLE_SIZE - 1)
+
+/* Tokens are the credential of a terminal, so each one comes from the OS */
+static int randomToken(uint64_t *token){
+#ifdef _WIN32
+    unsigned int high, low;
+    if (rand_s(&high) != 0 || rand_s(&low) != 0) return -1;
+    *token = (uint64_t)high << 32 | low;
+    return 0;
+#else
+    FILE *source = fopen("/dev/urandom", "rb");
+    if (!source) return -1;
+    size_t got = fread(token, sizeof(*token), 1, source);
+    fclose(source);
+    return got == 1 ? 0 : -1;
+#endif
+}
+
+static int findSession(SessionTable *table, uint64_t token){
+    int i = (int)(token & SESSION_MASK);
+    while (table->slots[i].token != 0) {
+        if (table->slots[i].token == token) return i;
+        i = (i + 1) & SESSION_MASK;
+    }
+    return -1;
+}
+
+static void removeSession(SessionTable *table, int hole){
+    int i = hole;
+    table->slots[hole].token = 0;
+    table->count--;
+    for (;;) {
+        i = (i + 1) & SESSION_MASK;
+        if (table->slots[i].token == 0) return;
+        int home = (int)(table->slots[i].token & SESSION_MASK);
+        if (((i - home) & SESSION_MASK) >= ((i - hole) & SESSION_MASK)) {
+            table->slots[hole] = table->slots[i];
+            table->slots[i].token = 0;
+            hole = i;
+        }
+    }
+}
+
+SessionTable* createSessionTable(int ttlSeconds){
+    SessionTable *table = (SessionTable *)memCalloc(MEM_USERS, 1, sizeof(SessionTable));
+    if (!table) return NULL;
+
+    table->ttlSeconds = ttlSeconds;
+    return table;
+}
+
+/* Drops every expired session; only needed once the table fills up */
+static void reapSessions(SessionTable *table, time_t now){
+    int i = 0;
+    while (i < SESSION_TABLE_SIZE) {
+        if (table->slots[i].token != 0 && now > table->slots[i].expires) {
+            /* the shift may pull another entry into slot i, so recheck it */
+            removeSession(table, i);
+        } else {
+            i++;
+        }
+    }
+}
+
+uint64_t openSession(SessionTable *table, User *user, int terminalId){
+    time_t now = clockTime();
+    if (table->count >= SESSION_TABLE_SIZE / 2) {
+        reapSessions(table, now);
+    }
+    if (table->count >= SESSION_TABLE_SIZE / 2) {
+        fprintf(stderr, "Too many open sessions.\n");
+        return 0;
+    }
+    uint64_t token;
+    do {
+        if (randomToken(&token) != 0) {
+            fprintf(stderr, "No random source for session tokens.\n");
+            return 0;
+        }
+    } while (token == 0 || findSession(table, token) >= 0);
+    int i = (int)(token & SESSION_MASK);
+    while (table->slots[i].token != 0) {
+        i = (i + 1) & SESSION_MASK;
+    }
+    table->slots[i].token = token;
+    table->slots[i].user = user;
+    table->slots[i].terminalId = terminalId;
+    table->slots[i].expires = now + table->ttlSeconds;
+    table->count++;
+    return token;
+}
+
+User* validateSession(SessionTable *table, uint64_t token, int terminalId){
+    if (token == 0) return NULL;
+
+    int i = findSession(table, token);
+    if (i < 0) return NULL;
+
+    Session *session = &table->slots[i];
+    time_t now = clockTime();
+    if (now > session->expires) {
+        removeSession(table, i);
+        return NULL;
+    }
+    if (session->terminalId != terminalId) return NULL;
+
+    session->expires = now + table->ttlSeconds;
+    return session->user;
+}
+
+void closeSession(SessionTable *table, uint64_t token){
+    int i = findSession(table, token);
+    if (i >= 0) {
+        removeSession(table, i);
+    }
+}
+
+void closeUserSessions(SessionTable *table, const User *user){
+    int i = 0;
+    while (i < SESSION_TABLE_SIZE) {
+        if (table->slots[i].token != 0 && table->slots[i].user == user) {
+            /* the shift may pull another entry into slot i, so recheck it */
+            removeSession(table, i);
+        } else {
+            i++;
+        }
+    }
+}
+
+void freeSessionTable(SessionTable *table){
+    memFree(table);
+}
@@ -0,0 +1,211 @@
+#include <string.h>
+#include "../include/waitestimate.h"
+#include "../include/ordertrace.h"
+#include "../include/clocksource.h"
+#include "../include/memtrack.h"
+
+#define ETA_INITIAL_ITEMS 64
+
+/* ===============================
+   Item estimates
+   =============================== */
+
+static unsigned slotOf(int menuId, int capacity){
+    return ((unsigned)menuId * 2654435761u) & (unsigned)(capacity - 1);
+}
+
+static PrepEstimate* findEstimate(const WaitEstimator *estimator, int menuId){
+    unsigned h = slotOf(menuId, estimator->itemCapacity);
+    while (estimator->items[h].used) {
+        if (estimator->items[h].menuId == menuId) return &estimator->items[h];
+        h = (h + 1) & (unsigned)(estimator->itemCapacity - 1);
+    }
+    return NULL;
+}
+
+static int growEstimates(WaitEstimator *estimator){
+    int capacity = estimator->itemCapacity * 2;
+    PrepEstimate *items = (PrepEstimate *)memCalloc(MEM_ORDERS, capacity, sizeof(PrepEstimate));
+    if (!items) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return -1;
+    }
+    for (int i = 0; i < estimator->itemCapacity; i++) {
+        if (!estimator->items[i].used) continue;
+        unsigned h = slotOf(estimator->items[i].menuId, capacity);
+        while (items[h].used) h = (h + 1) & (unsigned)(capacity - 1);
+        items[h] = estimator->items[i];
+    }
+    memFree(estimator->items);
+    estimator->items = items;
+    estimator->itemCapacity = capacity;
+    return 0;
+}
+
+/* Returns the item's estimate, adding it at the default if new; NULL if out of memory */
+static PrepEstimate* ensureEstimate(WaitEstimator *estimator, int menuId){
+    PrepEstimate *estimate = findEstimate(estimator, menuId);
+    if (estimate) return estimate;
+    if ((estimator->itemCount + 1) * 2 > estimator->itemCapacity && growEstimates(estimator) != 0) {
+        return NULL;
+    }
+    unsigned h = slotOf(menuId, estimator->itemCapacity);
+    while (estimator->items[h].used) h = (h + 1) & (unsigned)(estimator->itemCapacity - 1);
+    estimator->items[h].menuId = menuId;
+    estimator->items[h].used = 1;
+    estimator->items[h].unitNanos = estimator->defaultUnitNanos;
+    estimator->itemCount++;
+    return &estimator->items[h];
+}
+
+uint64_t itemPrepNanos(const WaitEstimator *estimator, int menuId){
+    const PrepEstimate *estimate = findEstimate(estimator, menuId);
+    return (uint64_t)(estimate ? estimate->unitNanos : estimator->defaultUnitNanos);
+}
+
+uint64_t estimateBasketWork(const WaitEstimator *estimator, const OrderItem *items){
+    double work = 0.0;
+    for (const OrderItem *line = items; line != NULL; line = line->next) {
+        work += line->quantity * (double)itemPrepNanos(estimator, line->menuItem->id);
+    }
+    return (uint64_t)work;
+}
+
+/* Spreads the error of the current estimate evenly over the order's units */
+static void learn(WaitEstimator *estimator, const Order *order, uint64_t observed){
+    if (observed < ETA_MIN_SAMPLE_NANOS || order->workNanos == 0) return;
+    int units = 0;
+    for (const OrderItem *line = order->items; line != NULL; line = line->next) {
+        units += line->quantity;
+    }
+    if (units == 0) return;
+
+    double error = (double)observed - (double)estimateBasketWork(estimator, order->items);
+    double step = ETA_LEARNING_RATE * error / units;
+    double floor = estimator->defaultUnitNanos / 100.0;
+    for (const OrderItem *line = order->items; line != NULL; line = line->next) {
+        PrepEstimate *estimate = ensureEstimate(estimator, line->menuItem->id);
+        if (!estimate) return;
+        estimate->unitNanos += step;
+        if (estimate->unitNanos < floor) estimate->unitNanos = floor;
+    }
+    estimator->samples++;
+}
+
+/* ===============================
+   Queue sums
+   =============================== */
+
+static void addActive(WaitEstimator *estimator, const Order *order){
+    estimator->activeWork += order->workNanos;
+    estimator->activeStartSum += order->stageNanos[STAGE_STARTED];
+    estimator->activeCount++;
+}
+
+static void removeActive(WaitEstimator *estimator, const Order *order){
+    if (estimator->activeCount == 0) return;
+    estimator->activeWork -= order->workNanos;
+    estimator->activeStartSum -= order->stageNanos[STAGE_STARTED];
+    estimator->activeCount--;
+}
+
+/* Work of the orders being prepared that is not done yet */
+static uint64_t activeRemaining(const WaitEstimator *estimator, uint64_t now){
+    uint64_t elapsed = estimator->activeCount * now - estimator->activeStartSum;
+    return elapsed < estimator->activeWork ? estimator->activeWork - elapsed : 0;
+}
+
+static int isWaiting(const Order *order){
+    return order->stageNanos[STAGE_STARTED] == 0;
+}
+
+static int isActive(const Order *order){
+    return order->stageNanos[STAGE_STARTED] != 0 && order->stageNanos[STAGE_READY] == 0;
+}
+
+static void onOrderEvent(Order *order, OrderEvent event, void *context){
+    WaitEstimator *estimator = (WaitEstimator *)context;
+
+    if (event == ORDER_ENQUEUED) {
+        order->workNanos = estimateBasketWork(estimator, order->items);
+        order->workAheadNanos = estimator->placedWork;
+        estimator->placedWork += order->workNanos;
+        return;
+    }
+    if (order->workNanos == 0) return;      /* placed before the estimator existed */
+
+    switch (event) {
+    case ORDER_STARTED:
+        estimator->drainedWork += order->workNanos;
+        addActive(estimator, order);
+        break;
+    case ORDER_READY:
+        removeActive(estimator, order);
+        learn(estimator, order, orderStageNanos(order, STAGE_STARTED, STAGE_READY));
+        break;
+    case ORDER_CANCELLED:
+    case ORDER_DEQUEUED:
+        if (isWaiting(order)) {
+            if (event == ORDER_CANCELLED && order->workAheadNanos + order->workNanos == estimator->placedWork) {
+                estimator->placedWork -= order->workNanos;      /* newest order: as if never placed */
+            } else {
+                estimator->drainedWork += order->workNanos;
+            }
+        } else if (isActive(order)) {
+            removeActive(estimator, order);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/* ===============================
+   Estimates
+   =============================== */
+
+static uint64_t queueReadyIn(const WaitEstimator *estimator, uint64_t ahead, uint64_t own){
+    uint64_t now = clockNanos();
+    return (ahead + activeRemaining(estimator, now)) / estimator->stations + own;
+}
+
+uint64_t estimateBasketReadyIn(const WaitEstimator *estimator, const OrderItem *items){
+    return queueReadyIn(estimator, estimator->placedWork - estimator->drainedWork,
+                        estimateBasketWork(estimator, items));
+}
+
+uint64_t estimateOrderReadyIn(const WaitEstimator *estimator, const Order *order){
+    if (order->stageNanos[STAGE_READY] != 0) return 0;
+    if (isActive(order)) {
+        uint64_t due = order->stageNanos[STAGE_STARTED] + order->workNanos, now = clockNanos();
+        return due > now ? due - now : 0;
+    }
+    uint64_t ahead = order->workAheadNanos > estimator->drainedWork
+                   ? order->workAheadNanos - estimator->drainedWork : 0;
+    return queueReadyIn(estimator, ahead, order->workNanos);
+}
+
+WaitEstimator* createWaitEstimator(int stations, uint64_t defaultUnitNanos){
+    WaitEstimator *estimator = (WaitEstimator *)memCalloc(MEM_ORDERS, 1, sizeof(WaitEstimator));
+    if (!estimator) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    estimator->stations = stations > 0 ? stations : 1;
+    estimator->defaultUnitNanos = (double)defaultUnitNanos;
+    estimator->itemCapacity = ETA_INITIAL_ITEMS;
+    estimator->items = (PrepEstimate *)memCalloc(MEM_ORDERS, ETA_INITIAL_ITEMS, sizeof(PrepEstimate));
+    if (!estimator->items || addOrderObserver(onOrderEvent, estimator) != 0) {
+        memFree(estimator->items);
+        memFree(estimator);
+        return NULL;
+    }
+    return estimator;
+}
+
+void freeWaitEstimator(WaitEstimator *estimator){
+    if (!estimator) return;
+    removeOrderObserver(onOrderEvent, estimator);
+    memFree(estimator->items);
+    memFree(estimator);
+}